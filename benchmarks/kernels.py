@@ -0,0 +1,72 @@
+# Times the wizuall_rt vector kernels against the Python that avg, runningSum,
+# pairwiseCompare, reverse and slice compile to: the list code emitted for
+# vectors of unknown type and the NumPy code emitted for typed ones. Run from
+# the repository root after `make`; `--max 7` stops at 10^7 elements.
+import sys
+import time
+
+import numpy as np
+
+sys.path.insert(0, '.')
+import wizuall_rt as rt
+
+# Python lists of 10^8 floats take over 3 GB, so they stop before that
+LIST_MAX = 10 ** 7
+
+
+def best(fn, x, budget=0.2):
+    # Best of 3 rounds of enough calls to fill `budget` seconds, per call
+    start = time.perf_counter()
+    fn(x)
+    once = time.perf_counter() - start
+    calls = max(1, int(budget / max(once, 1e-7)))
+    rounds = []
+    for _ in range(3):
+        start = time.perf_counter()
+        for _ in range(calls):
+            fn(x)
+        rounds.append((time.perf_counter() - start) / calls)
+    return min(rounds)
+
+
+OPS = [
+    ('avg', lambda x: sum(x) / len(x), lambda x: float(x.mean()), rt.avg),
+    ('runningSum', np.cumsum, np.cumsum, rt.running_sum),
+    ('pairwiseCompare', lambda x: [x[i + 1] - x[i] for i in range(len(x) - 1)], np.diff, rt.diff),
+    ('reverse', lambda x: list(reversed(x)), lambda x: x[::-1].copy(), rt.reverse),
+    ('min/max', lambda x: (min(x), max(x)), lambda x: (x.min(), x.max()), rt.minmax),
+    # A slice of an array is a view, with nothing for a kernel to copy
+    ('slice', lambda x: x[len(x) // 4:3 * len(x) // 4], lambda x: x[len(x) // 4:3 * len(x) // 4], None),
+]
+
+
+def show(seconds):
+    if seconds is None:
+        return '-'
+    for unit, scale in (('s', 1), ('ms', 1e-3), ('us', 1e-6)):
+        if seconds >= scale:
+            return '%.3g %s' % (seconds / scale, unit)
+    return '%.3g ns' % (seconds / 1e-9)
+
+
+def main():
+    top = int(sys.argv[sys.argv.index('--max') + 1]) if '--max' in sys.argv else 8
+    rng = np.random.default_rng(7)
+    print('| builtin | n | list | NumPy | wizuall_rt | vs NumPy |')
+    print('|---|---|---|---|---|---|')
+    for exp in range(3, top + 1):
+        n = 10 ** exp
+        x = rng.normal(size=n)
+        listed = x.tolist() if n <= LIST_MAX else None
+        for name, on_list, on_array, kernel in OPS:
+            t_list = best(on_list, listed) if listed is not None else None
+            t_numpy = best(on_array, x)
+            t_rt = best(kernel, x) if kernel else None
+            ratio = '%.1fx' % (t_numpy / t_rt) if t_rt else '-'
+            print('| %s | 10^%d | %s | %s | %s | %s |' % (name, exp, show(t_list), show(t_numpy), show(t_rt), ratio),
+                  flush=True)
+        del x, listed
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,80 @@
+# Writes the input files the import benchmarks read into benchmarks/data/
+import json
+import os
+import random
+
+OUT = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'data')
+os.makedirs(OUT, exist_ok=True)
+random.seed(7)
+
+# 200 columns, of which the benchmark reads two
+wide_csv = os.path.join(OUT, 'wide.csv')
+if not os.path.exists(wide_csv):
+    with open(wide_csv, 'w') as f:
+        f.write(','.join('c%d' % i for i in range(200)) + '\n')
+        for _ in range(50000):
+            f.write(','.join('%.4f' % random.random() for _ in range(200)) + '\n')
+
+# 40 arrays of 100000 numbers, of which the benchmark reads two
+wide_json = os.path.join(OUT, 'wide.json')
+if not os.path.exists(wide_json):
+    with open(wide_json, 'w') as f:
+        json.dump({'k%d' % i: [round(random.random(), 4) for _ in range(100000)] for i in range(40)}, f)
+
+# 10 million rows of two numeric columns, which the streaming benchmark
+# aggregates without loading them
+long_csv = os.path.join(OUT, 'long.csv')
+if not os.path.exists(long_csv):
+    import numpy as np
+    rng = np.random.default_rng(7)
+    with open(long_csv, 'w') as f:
+        f.write('x,y\n')
+        for _ in range(10):
+            x = rng.integers(0, 1000000, 1000000)
+            y = rng.normal(50, 15, 1000000)
+            f.write(''.join('%d,%.4f\n' % row for row in zip(x.tolist(), y.tolist())))
+
+# The same rows gzip-compressed, imported without decompressing to disk
+long_gz = long_csv + '.gz'
+if not os.path.exists(long_gz):
+    import gzip
+    import shutil
+    with open(long_csv, 'rb') as src, gzip.open(long_gz, 'wb') as dst:
+        shutil.copyfileobj(src, dst, 1 << 20)
+
+# A SQLite table of 5 million rows and eight columns, of which the
+# benchmark plots a window of two
+metrics_db = os.path.join(OUT, 'metrics.db')
+if not os.path.exists(metrics_db):
+    import sqlite3
+    import numpy as np
+    rng = np.random.default_rng(7)
+    db = sqlite3.connect(metrics_db + '.tmp')
+    db.execute('CREATE TABLE t (ts INTEGER, value REAL, host TEXT, cpu REAL, mem REAL, disk REAL, net REAL, errors INTEGER)')
+    for block in range(10):
+        ts = np.arange(block * 500000, (block + 1) * 500000)
+        value = rng.normal(50, 15, len(ts)).round(4)
+        host = ['h%d' % h for h in rng.integers(0, 64, len(ts)).tolist()]
+        other = [rng.random(len(ts)).round(4).tolist() for _ in range(4)]
+        errors = rng.integers(0, 5, len(ts))
+        db.executemany('INSERT INTO t VALUES (?, ?, ?, ?, ?, ?, ?, ?)',
+                       zip(ts.tolist(), value.tolist(), host, *other, errors.tolist()))
+    db.commit()
+    db.close()
+    os.replace(metrics_db + '.tmp', metrics_db)
+
+# Ten days of hourly log files, 20000 rows each, imported by one pattern
+logs = os.path.join(OUT, 'logs')
+if not os.path.exists(logs):
+    import numpy as np
+    rng = np.random.default_rng(7)
+    os.makedirs(logs + '.tmp', exist_ok=True)
+    for hour in range(240):
+        ts = np.arange(hour * 20000, (hour + 1) * 20000)
+        latency = rng.lognormal(3, 0.5, len(ts))
+        status = rng.choice([200, 200, 200, 404, 500], len(ts))
+        size = rng.integers(100, 100000, len(ts))
+        with open(os.path.join(logs + '.tmp', 'h%03d.csv' % hour), 'w') as f:
+            f.write('ts,latency,status,bytes\n')
+            f.write(''.join('%d,%.3f,%d,%d\n' % row for row in zip(ts.tolist(), latency.tolist(), status.tolist(), size.tolist())))
+    os.replace(logs + '.tmp', logs)
@@ -0,0 +1,90 @@
+# Times the wizuall_rt kernels that run on its thread pool at WIZUALL_THREADS=1
+# up to the number of CPUs, each count in a fresh process (the pool is sized
+# once per process), and prints the speedup over one thread. Run from the
+# repository root after `make`; `--n 8` times vectors of 10^8 elements,
+# `--threads 16` goes up to 16 threads and `--chart scaling.png` also plots
+# the speedups.
+import json
+import os
+import subprocess
+import sys
+
+import numpy as np
+
+sys.path.insert(0, '.')
+import wizuall_rt as rt
+
+from kernels import best, show
+
+OPS = [
+    ('avg', lambda x, y: rt.avg(x), lambda x, y: float(x.mean())),
+    ('runningSum', lambda x, y: rt.running_sum(x), lambda x, y: np.cumsum(x)),
+    ('pairwiseCompare', lambda x, y: rt.diff(x), lambda x, y: np.diff(x)),
+    ('x + y', lambda x, y: rt.arith('+', x, y), lambda x, y: x + y),
+    ('x * 2.5', lambda x, y: rt.arith('*', x, 2.5), lambda x, y: x * 2.5),
+    ('sort', lambda x, y: rt.sort(x), lambda x, y: np.sort(x)),
+]
+
+
+def option(name, default):
+    return int(sys.argv[sys.argv.index(name) + 1]) if name in sys.argv else default
+
+
+def measure(n):
+    # Seconds per call of each kernel, and of NumPy when on one thread
+    rng = np.random.default_rng(7)
+    x, y = rng.normal(size=n), rng.normal(size=n)
+    times = {}
+    for name, kernel, numpy in OPS:
+        times[name] = best(lambda x: kernel(x, y), x, budget=0.5)
+        if rt.threads() == 1:
+            times[name + ' NumPy'] = best(lambda x: numpy(x, y), x, budget=0.5)
+    return times
+
+
+def counts(top):
+    # 1, 2, 4, ... and top itself
+    c = 1
+    while c < top:
+        yield c
+        c *= 2
+    yield top
+
+
+def chart(path, threads, results):
+    import matplotlib
+    matplotlib.use('Agg')
+    import matplotlib.pyplot as plt
+    fig, ax = plt.subplots(figsize=(7, 5))
+    for name, _, _ in OPS:
+        ax.plot(threads, [results[1][name] / results[t][name] for t in threads], marker='o', label=name)
+    ax.plot(threads, threads, linestyle=':', color='grey', label='linear')
+    ax.set_xlabel('WIZUALL_THREADS')
+    ax.set_ylabel('speedup over 1 thread')
+    ax.legend()
+    fig.savefig(path, dpi=120, bbox_inches='tight')
+
+
+def main():
+    n = 10 ** option('--n', 7)
+    if '--child' in sys.argv:
+        print(json.dumps(measure(n)))
+        return
+    threads = list(counts(option('--threads', os.cpu_count() or 1)))
+    results = {}
+    for t in threads:
+        env = dict(os.environ, WIZUALL_THREADS=str(t))
+        child = subprocess.run([sys.executable, __file__, '--child'] + sys.argv[1:], env=env,
+                               capture_output=True, text=True, check=True)
+        results[t] = json.loads(child.stdout)
+    print('| kernel (10^%d) | NumPy | %s |' % (len(str(n)) - 1, ' | '.join('%d thread%s' % (t, 's' * (t > 1)) for t in threads)))
+    print('|---|---|%s' % ('---|' * len(threads)))
+    for name, _, _ in OPS:
+        cells = ['%s (%.1fx)' % (show(results[t][name]), results[1][name] / results[t][name]) for t in threads]
+        print('| %s | %s | %s |' % (name, show(results[1][name + ' NumPy']), ' | '.join(cells)))
+    if '--chart' in sys.argv:
+        chart(sys.argv[sys.argv.index('--chart') + 1], threads, results)
+
+
+if __name__ == '__main__':
+    main()
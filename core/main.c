@@ -2,6 +2,11 @@
 #include <stdlib.h>
 #include "../ir/ast.h"
 #include "../ir/codegen.h"
+#include "../ir/optimize.h"
+#include "../ir/semantic_checks.h"
+#include "../ir/release.h"
+#include "../ir/streaming.h"
+#include "../ir/pushdown.h"
 
 // Declare parser function
 extern int yyparse();
@@ -12,6 +17,11 @@ int main() {
     if (yyparse() == 0) {
         printf("\n✅ Parsing successful! Here's the AST:\n\n");
         printAST(final_ast, 0);
+        optimize_program(final_ast);
+        analyze_types(final_ast);
+        plan_streams(final_ast);
+        plan_pushdown(final_ast);
+        release_dead_values(final_ast);
         FILE* out = fopen("output.py", "w");
         if (out) {
             generate_code(final_ast, out,0);
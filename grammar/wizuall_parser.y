@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "ir/ast.h"
+#include "ir/import_schema.h"
 
 ASTNode* final_ast = NULL;
 
@@ -10,6 +11,63 @@ ASTNode* final_ast = NULL;
 extern int yylineno;
 extern int yycolumn;
 extern char* yytext;
+
+int yylex(void);
+void yyerror(const char *s);
+
+// A SQLite database is imported one table at a time, only databases have
+// tables, and only CSV files are concatenated from a pattern
+static bool check_import(const char* filename, const char* table) {
+    char path[256];
+    import_path(filename, path, sizeof(path));
+    bool database = import_format(path) == IMPORT_SQLITE;
+    if (database && !table) yyerror("a database is imported with `table \"name\"` after the file name");
+    else if (!database && table) yyerror("only a SQLite database (.db, .sqlite, .sqlite3) is imported with a table");
+    else if (import_is_pattern(path) && import_format(path) != IMPORT_CSV) yyerror("only CSV files are imported by pattern");
+    else return true;
+    return false;
+}
+
+// Only CSV files are sampled: the other readers have no cheap way to skip rows
+static bool check_sample(const char* filename) {
+    char path[256];
+    import_path(filename, path, sizeof(path));
+    if (import_format(path) == IMPORT_CSV) return true;
+    yyerror("only CSV files are imported with sample");
+    return false;
+}
+
+// A live import follows one growing file (or FIFO) from where it last read
+static bool check_live(const char* filename) {
+    char path[256];
+    import_path(filename, path, sizeof(path));
+    if (import_format(path) != IMPORT_CSV) yyerror("only CSV files are imported live");
+    else if (import_is_pattern(path)) yyerror("a pattern is not imported live");
+    else if (strlen(path) > 3 && strcmp(path + strlen(path) - 3, ".gz") == 0) yyerror("a .gz file is not imported live");
+    else return true;
+    return false;
+}
+
+// `export x, y to "f";` writes named vectors, each once: the file is a CSV
+// table or a binary `.wzb` archive of columns
+static bool check_export(ASTList* names, const char* filename) {
+    char path[256];
+    import_path(filename, path, sizeof(path));
+    size_t len = strlen(path);
+    bool csv = len > 4 && strcmp(path + len - 4, ".csv") == 0;
+    bool wzb = len > 4 && strcmp(path + len - 4, ".wzb") == 0;
+    if (!csv && !wzb) {
+        yyerror("export writes a .wzb or .csv file");
+        return false;
+    }
+    for (ASTList* n = names; n; n = n->next)
+        for (ASTList* m = n->next; m; m = m->next)
+            if (strcmp(n->node->id_name, m->node->id_name) == 0) {
+                yyerror("a vector is exported once per file");
+                return false;
+            }
+    return true;
+}
 %}
 
 /* ----------  UNION  ---------- */
@@ -47,7 +105,8 @@ extern char* yytext;
 /* ----------  TYPES ------------ */
 %type <ast>  Program Statement Assignment ControlStructure FunctionCall VisualizationCall Expression Term Factor VectorLiteral VizArg
 %type <list> StatementList VectorElements ArgList ArgListOpt VizArgList VizArgListOpt
-%type <ast> ImportStatement
+%type <ast> ImportStatement ExportStatement
+%type <list> ExportNames
 
 %%   /* ---------- GRAMMAR ---------- */
 
@@ -62,6 +121,7 @@ StatementList
 
 Statement
     : ImportStatement
+    | ExportStatement
     | Assignment SEMICOLON
     | ControlStructure
     | VisualizationCall SEMICOLON
@@ -69,7 +129,78 @@ Statement
     ;
 
 ImportStatement
-    : IMPORT STRING SEMICOLON { $$ = createImportNode($2); }
+    : IMPORT STRING SEMICOLON
+        {
+            if (!check_import($2, NULL)) YYERROR;
+            $$ = createImportNode($2, false, false, NULL, 0, false);
+        }
+    | IMPORT STRING ID SEMICOLON
+        {   /* `stream` and `live` are not reserved, so they stay usable as variable names */
+            bool live = strcmp($3, "live") == 0;
+            if (strcmp($3, "stream") != 0 && !live) {
+                yyerror("expected 'stream', 'live' or ';' after the import file name");
+                YYERROR;
+            }
+            if (!check_import($2, NULL) || (live && !check_live($2))) YYERROR;
+            $$ = createImportNode($2, !live, live, NULL, 0, false);
+        }
+    | IMPORT STRING ID STRING SEMICOLON
+        {   /* likewise `table` */
+            if (strcmp($3, "table") != 0) {
+                yyerror("expected 'table' before the table name");
+                YYERROR;
+            }
+            char table[256];
+            import_path($4, table, sizeof(table));
+            if (!check_import($2, table)) YYERROR;
+            $$ = createImportNode($2, false, false, table, 0, false);
+        }
+    | IMPORT STRING ID NUMBER SEMICOLON
+        {   /* and `sample`: a fraction of the rows */
+            if (strcmp($3, "sample") != 0) {
+                yyerror("expected 'sample' before the sampled fraction");
+                YYERROR;
+            }
+            if (!($4 > 0 && $4 <= 1)) {
+                yyerror($4 > 1 && $4 == (long long)$4 ? "a sampled row count is written `sample N rows`"
+                                                      : "a sampled fraction must be in (0, 1]");
+                YYERROR;
+            }
+            if (!check_import($2, NULL) || !check_sample($2)) YYERROR;
+            $$ = createImportNode($2, false, false, NULL, $4, false);
+        }
+    | IMPORT STRING ID NUMBER ID SEMICOLON
+        {   /* `sample N rows`: that many rows */
+            if (strcmp($3, "sample") != 0 || strcmp($5, "rows") != 0) {
+                yyerror("expected `sample N rows`");
+                YYERROR;
+            }
+            if (!($4 >= 1 && $4 == (long long)$4)) {
+                yyerror("a sampled row count must be a positive integer");
+                YYERROR;
+            }
+            if (!check_import($2, NULL) || !check_sample($2)) YYERROR;
+            $$ = createImportNode($2, false, false, NULL, $4, true);
+        }
+    ;
+
+ExportStatement
+    : ID ExportNames ID STRING SEMICOLON
+        {   /* `export` and `to` are contextual, like `stream` and `sample` */
+            if (strcmp($1, "export") != 0 || strcmp($3, "to") != 0) {
+                yyerror("expected `export name, ... to \"file\"`");
+                YYERROR;
+            }
+            if (!check_export($2, $4)) YYERROR;
+            char path[256];
+            import_path($4, path, sizeof(path));
+            $$ = createExportNode($2, path);
+        }
+    ;
+
+ExportNames
+    : ID                           { $$ = createASTList(createIdNode($1)); }
+    | ExportNames COMMA ID         { $$ = appendASTList($1, createIdNode($3)); }
     ;
 
 Assignment
@@ -1,6 +1,8 @@
 #ifndef AST_H
 #define AST_H
 
+#include <stdbool.h>
+
 // Types of AST nodes
 typedef enum {
     NODE_PROGRAM,        // New type for the Program (list of statements)
@@ -16,7 +18,9 @@ typedef enum {
     NODE_WHILE_LOOP,
     NODE_FOR_LOOP,
     NODE_AUX_BLOCK,
-    NODE_IMPORT
+    NODE_IMPORT,
+    NODE_EXPORT,
+    NODE_RELEASE         // Inserted by release_dead_values: drops a dead variable
 } NodeType;
 
 // Operators for binary expressions
@@ -33,6 +37,22 @@ typedef enum {
 // Forward declarations
 struct ASTNode;
 
+// Per-statement plan for a counted loop rewritten into NumPy calls (see vectorize_loops)
+typedef enum {
+    VEC_SUM,             // target = target + term (or - term)
+    VEC_PRODUCT,         // target = target * term
+    VEC_MAP              // target = concat(target, [term])
+} VectorOpKind;
+
+typedef struct VectorOp {
+    VectorOpKind kind;
+    const char* target;
+    struct ASTNode* term;        // per-iteration value in terms of the loop variable
+    bool negate;                 // VEC_SUM only: subtract instead of add
+    const char* scan_into;       // VEC_SUM/VEC_PRODUCT: vector receiving each running value
+    struct VectorOp* next;
+} VectorOp;
+
 typedef struct ASTList {
     struct ASTNode* node;
     struct ASTList* next;
@@ -86,6 +106,13 @@ typedef struct ASTNode {
             struct ASTNode* condition;
             struct ASTNode* increment;
             ASTList* body;
+            // Set by lower_counted_loops when the loop can run over range()
+            bool counted;
+            long range_start;
+            long range_step;
+            struct ASTNode* range_bound;   // exclusive bound from the condition
+            bool keep_final;               // loop variable is read after the loop
+            VectorOp* vector_ops;          // set when the whole body was vectorised
         } for_loop;
 
         struct {           // For aux blocks
@@ -98,8 +125,23 @@ typedef struct ASTNode {
 
         struct {           // For import statements
             char* filename;
+            bool stream;   // `import "f" stream;`: aggregates are computed block by block
+            bool live;     // `import "f" live;`: appended rows are read as they arrive
+            char* table;   // `import "f.db" table "t";`: unquoted table name, else NULL
+            double sample; // `sample 0.01;`: fraction of the rows, `sample 1000 rows;`: row count, else 0
+            bool sample_rows;
         } import;
 
+        struct {           // For `export x, y to "f";`
+            ASTList* names;   // NODE_ID nodes, in column order
+            char* filename;   // unquoted; `.csv` writes text, anything else `.wzb`
+        } export;
+
+        struct {           // For releases of dead variables
+            char* var_name;
+            bool rebind;   // bind to None instead of `del` (name may be unbound)
+        } release;
+
     };
 } ASTNode;
 
@@ -117,11 +159,17 @@ ASTNode* createIfElseNode(ASTNode* cond, ASTList* if_body, ASTList* else_body);
 ASTNode* createWhileNode(ASTNode* cond, ASTList* body);
 ASTNode* createForNode(ASTNode* init, ASTNode* cond, ASTNode* incr, ASTList* body);
 ASTNode* createAuxBlockNode(char* code);
-ASTNode* createImportNode(const char* filename);
+ASTNode* createImportNode(const char* filename, bool stream, bool live, const char* table, double sample, bool sample_rows);
+ASTNode* createExportNode(ASTList* names, const char* filename);
+ASTNode* createReleaseNode(const char* var_name, bool rebind);
 
 ASTList* createASTList(ASTNode* node);
 ASTList* appendASTList(ASTList* list, ASTNode* node);
 
+// Deep copies of subtrees (used by passes that duplicate code)
+ASTNode* cloneAST(ASTNode* node);
+ASTList* cloneASTList(ASTList* list);
+
 void printAST(ASTNode* node, int level);
 
 #endif
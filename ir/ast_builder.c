@@ -90,6 +90,12 @@ ASTNode* createForNode(ASTNode* init, ASTNode* cond, ASTNode* incr, ASTList* bod
     node->for_loop.condition = cond;
     node->for_loop.increment = incr;
     node->for_loop.body = body;
+    node->for_loop.counted = false;
+    node->for_loop.range_start = 0;
+    node->for_loop.range_step = 0;
+    node->for_loop.range_bound = NULL;
+    node->for_loop.keep_final = false;
+    node->for_loop.vector_ops = NULL;
     return node;
 }
 
@@ -107,10 +113,31 @@ ASTNode* createStringNode(char* value) {
     return node;
 }
 
-ASTNode* createImportNode(const char* filename) {
+ASTNode* createImportNode(const char* filename, bool stream, bool live, const char* table, double sample, bool sample_rows) {
     ASTNode* node = malloc(sizeof(ASTNode));
     node->type = NODE_IMPORT;
     node->import.filename = strdup(filename);
+    node->import.stream = stream;
+    node->import.live = live;
+    node->import.table = table ? strdup(table) : NULL;
+    node->import.sample = sample;
+    node->import.sample_rows = sample_rows;
+    return node;
+}
+
+ASTNode* createExportNode(ASTList* names, const char* filename) {
+    ASTNode* node = malloc(sizeof(ASTNode));
+    node->type = NODE_EXPORT;
+    node->export.names = names;
+    node->export.filename = strdup(filename);
+    return node;
+}
+
+ASTNode* createReleaseNode(const char* var_name, bool rebind) {
+    ASTNode* node = malloc(sizeof(ASTNode));
+    node->type = NODE_RELEASE;
+    node->release.var_name = strdup(var_name);
+    node->release.rebind = rebind;
     return node;
 }
 
@@ -131,6 +158,56 @@ ASTList* appendASTList(ASTList* list, ASTNode* node) {
     return list;
 }
 
+// Copy functions
+
+ASTList* cloneASTList(ASTList* list) {
+    ASTList* copy = NULL;
+    for (ASTList* l = list; l; l = l->next)
+        copy = appendASTList(copy, cloneAST(l->node));
+    return copy;
+}
+
+ASTNode* cloneAST(ASTNode* node) {
+    if (!node) return NULL;
+    switch (node->type) {
+        case NODE_PROGRAM:
+            return createProgramNode(cloneASTList(node->program.statements));
+        case NODE_ASSIGNMENT:
+            return createAssignmentNode(node->assignment.var_name, cloneAST(node->assignment.expr));
+        case NODE_BINARY_OP:
+            return createBinaryOpNode(node->binary_op.op, cloneAST(node->binary_op.left), cloneAST(node->binary_op.right));
+        case NODE_VECTOR_LITERAL:
+            return createVectorNode(cloneASTList(node->vector_literal.elements));
+        case NODE_NUMBER:
+            return createNumberNode(node->num_value);
+        case NODE_ID:
+            return createIdNode(node->id_name);
+        case NODE_STRING:
+            return createStringNode(node->id_name);
+        case NODE_FUNCTION_CALL:
+            return createFunctionCallNode(node->function_call.func_name, cloneASTList(node->function_call.args));
+        case NODE_VIZ_CALL:
+            return createVizCallNode(node->viz_call.viz_func, cloneASTList(node->viz_call.args));
+        case NODE_IF_ELSE:
+            return createIfElseNode(cloneAST(node->if_else.condition), cloneASTList(node->if_else.if_body), cloneASTList(node->if_else.else_body));
+        case NODE_WHILE_LOOP:
+            return createWhileNode(cloneAST(node->while_loop.condition), cloneASTList(node->while_loop.body));
+        case NODE_FOR_LOOP:
+            return createForNode(cloneAST(node->for_loop.init), cloneAST(node->for_loop.condition),
+                                 cloneAST(node->for_loop.increment), cloneASTList(node->for_loop.body));
+        case NODE_AUX_BLOCK:
+            return createAuxBlockNode(node->aux_block.raw_code);
+        case NODE_IMPORT:
+            return createImportNode(node->import.filename, node->import.stream, node->import.live, node->import.table,
+                                    node->import.sample, node->import.sample_rows);
+        case NODE_EXPORT:
+            return createExportNode(cloneASTList(node->export.names), node->export.filename);
+        case NODE_RELEASE:
+            return createReleaseNode(node->release.var_name, node->release.rebind);
+    }
+    return NULL;
+}
+
 // Debug print function
 
 void printAST(ASTNode* node, int level) {
@@ -210,6 +287,14 @@ void printAST(ASTNode* node, int level) {
         case NODE_AUX_BLOCK:
             printf("AuxiliaryCodeBlock\n");
             break;
+        case NODE_EXPORT:
+            printf("Export to %s\n", node->export.filename);
+            for (ASTList* n = node->export.names; n; n = n->next)
+                printAST(n->node, level+1);
+            break;
+        case NODE_RELEASE:
+            printf("Release %s\n", node->release.var_name);
+            break;
         default:
             printf("Unknown Node Type\n");
     }
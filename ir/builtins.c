@@ -0,0 +1,23 @@
+#include <string.h>
+#include "builtins.h"
+
+// Table of built-in functions understood by the code generator
+static const BuiltinInfo builtins[] = {
+    { "avg",             true },
+    { "sort",            true },
+    { "reverse",         true },
+    { "slice",           true },
+    { "transpose",       true },
+    { "runningSum",      true },
+    { "pairwiseCompare", true },
+    { "paretoSet",       true },
+    { "concat",          true },
+};
+
+const BuiltinInfo* lookup_builtin(const char* name) {
+    for (size_t i = 0; i < sizeof(builtins) / sizeof(builtins[0]); i++) {
+        if (strcmp(builtins[i].name, name) == 0)
+            return &builtins[i];
+    }
+    return NULL;
+}
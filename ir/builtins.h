@@ -0,0 +1,14 @@
+#ifndef BUILTINS_H
+#define BUILTINS_H
+#include <stdbool.h>
+
+// Static properties of the WizuAll built-in functions (see generate_builtin_func)
+typedef struct {
+    const char* name;
+    bool pure;          // no side effects, result depends only on the arguments
+} BuiltinInfo;
+
+// Returns NULL for names that are not WizuAll built-ins (e.g. print)
+const BuiltinInfo* lookup_builtin(const char* name);
+
+#endif
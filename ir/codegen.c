@@ -1,7 +1,14 @@
 #include "ast.h"
+#include "builtins.h"
+#include "semantic_checks.h"
+#include "liveness.h"
+#include "streaming.h"
+#include "pushdown.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <math.h>
 #include <libgen.h> // for basename
 
 // Flags for imports and helpers
@@ -10,6 +17,35 @@ static bool seaborn_imported = false;
 static bool numpy_imported = false;
 static bool paretoset_emitted = false;
 static bool pairwise_emitted = false;
+static bool math_imported = false;
+static bool csv_reader_emitted = false;
+static bool json_reader_emitted = false;
+static bool stream_reader_emitted = false;
+static bool sqlite_reader_emitted = false;
+static bool budget_emitted = false;
+static bool export_emitted = false;
+static bool live_reader_emitted = false;
+static bool gzip_reader_emitted = false;
+static bool prefetch_emitted = false;
+static bool vector_helpers_emitted = false;
+static bool update_emitted = false;
+static bool shown_emitted = false;
+// One flag per wizuall_rt wrapper; _wizuall_kernel and _wizuall_parallel are
+// emitted for the ones that call them
+static bool avg_emitted = false;
+static bool diff_emitted = false;
+static bool reversed_emitted = false;
+static bool minmax_emitted = false;
+static bool sorted_emitted = false;
+static bool arith_emitted = false;
+static bool running_sum_emitted = false;
+
+// Imports of files whose schema was read at compile time bind exactly the
+// columns the program reads, as plain assignments
+static bool static_imports = false;
+static NameSet referenced_names;
+
+static const char* array_update(ASTNode* assign, ASTNode** operand);
 
 // Add at the top of the file (after includes):
 static int plot_counter = 1;
@@ -17,9 +53,13 @@ static int plot_counter = 1;
 // Forward declarations
 void generate_code(ASTNode* node, FILE* out, int indent);
 void generate_expr(ASTNode* node, FILE* out, int indent);
+void generate_block(ASTList* stmts, FILE* out, int indent);
 void emit_helpers(FILE* out);
 void emit_imports(FILE* out);
 void scan_for_imports_and_helpers(ASTNode* node);
+static int live_source(const char* name);
+static void plan_live(ASTList* stmts);
+static void plan_prefetches(ASTList* stmts);
 
 void print_indent(FILE* out, int indent) {
     for (int i = 0; i < indent; i++)
@@ -31,6 +71,146 @@ bool streq(const char* a, const char* b) {
     return strcmp(a, b) == 0;
 }
 
+// range() takes the bound as is once type inference proves it an integer;
+// anything else (possibly a float) is rounded with math.ceil/math.floor
+static bool bound_needs_rounding(ASTNode* bound) {
+    if (bound->type == NODE_NUMBER) return false;
+    TypeInfo t = infer_expr_type(bound);
+    return !(t.kind == TYPE_NUMBER && t.dtype == DTYPE_INT);
+}
+
+// Columns of a stream import that plan_streams accepted are aggregated
+// block by block; the other referenced columns are loaded whole
+static bool column_streamed(const char* path, const char* name) {
+    const StreamColumn* c = find_stream_column(name);
+    return c && streq(c->path, path);
+}
+
+static bool column_loaded(const char* path, const char* name) {
+    return nameset_contains(&referenced_names, name) && !column_streamed(path, name);
+}
+
+static bool import_reads_columns(const char* path, const ImportSchema* schema) {
+    for (int i = 0; i < schema->count; i++)
+        if (column_loaded(path, schema->columns[i].name)) return true;
+    return false;
+}
+
+static bool import_streams_columns(const char* path, const ImportSchema* schema) {
+    for (int i = 0; i < schema->count; i++)
+        if (column_streamed(path, schema->columns[i].name)) return true;
+    return false;
+}
+
+// True if an expression mentions a value that may be a NumPy array
+static bool mentions_array(ASTNode* e) {
+    if (!e) return false;
+    switch (e->type) {
+        case NODE_ID:
+        case NODE_VECTOR_LITERAL: {
+            ValueKind kind = infer_expr_type(e).kind;
+            return kind == TYPE_VECTOR || kind == TYPE_MATRIX || kind == TYPE_UNKNOWN;
+        }
+        case NODE_BINARY_OP:
+            return mentions_array(e->binary_op.left) || mentions_array(e->binary_op.right);
+        case NODE_FUNCTION_CALL:
+            if (streq(e->function_call.func_name, "runningSum")) return true;
+            for (ASTList* a = e->function_call.args; a; a = a->next)
+                if (mentions_array(a->node)) return true;
+            return false;
+        default:
+            return false;
+    }
+}
+
+// Operators on arrays allocate a new array, which an assignment passes
+// through _wizuall_spill; runningSum has its own helper. Vectors known to
+// stay under the helper's 1 MB threshold are left out.
+static bool may_spill(ASTNode* expr) {
+    if (!expr || expr->type != NODE_BINARY_OP) return false;
+    TypeInfo t = infer_expr_type(expr);
+    if (t.kind == TYPE_VECTOR && t.length >= 0 && t.length < (1 << 20) / 8) return false;
+    return (t.kind == TYPE_VECTOR || t.kind == TYPE_UNKNOWN) && mentions_array(expr);
+}
+
+// + - * / over numbers and numeric vectors: element i of the result needs
+// only element i of each vector, so _wizuall_spill can compute it a block at
+// a time. *vectors is set when it has a vector operand.
+static bool elementwise(ASTNode* e, bool* vectors) {
+    if (!e) return false;
+    switch (e->type) {
+        case NODE_NUMBER:
+            return true;
+        case NODE_ID: {
+            TypeInfo t = infer_expr_type(e);
+            if (t.kind == TYPE_NUMBER) return true;
+            if (t.kind != TYPE_VECTOR || t.dtype == DTYPE_NONE) return false;
+            *vectors = true;
+            return true;
+        }
+        case NODE_BINARY_OP: {
+            BinaryOpType op = e->binary_op.op;
+            if (op != OP_PLUS && op != OP_MINUS && op != OP_TIMES && op != OP_DIVIDE) return false;
+            return elementwise(e->binary_op.left, vectors) && elementwise(e->binary_op.right, vectors);
+        }
+        default:
+            return false;
+    }
+}
+
+// The distinct vector names of an elementwise expression
+static void collect_vector_operands(ASTNode* e, NameSet* names) {
+    if (e->type == NODE_BINARY_OP) {
+        collect_vector_operands(e->binary_op.left, names);
+        collect_vector_operands(e->binary_op.right, names);
+    } else if (e->type == NODE_ID && infer_expr_type(e).kind == TYPE_VECTOR && !nameset_contains(names, e->id_name)) {
+        nameset_add(names, e->id_name);
+    }
+}
+
+// print shows vectors and matrices, which may be NumPy arrays, through
+// _wizuall_shown; numbers, strings and lists of strings print as they are
+static bool printed_as_list(ASTNode* arg) {
+    ValueKind kind = infer_expr_type(arg).kind;
+    return kind == TYPE_VECTOR || kind == TYPE_MATRIX || kind == TYPE_UNKNOWN;
+}
+
+// + - * / on a vector of unknown length, which may be long enough for
+// _wizuall_arith to split across the wizuall_rt thread pool
+static bool parallel_arith(ASTNode* expr) {
+    if (!expr || expr->type != NODE_BINARY_OP) return false;
+    BinaryOpType op = expr->binary_op.op;
+    if (op != OP_PLUS && op != OP_MINUS && op != OP_TIMES && op != OP_DIVIDE) return false;
+    TypeInfo t = infer_expr_type(expr);
+    return t.kind == TYPE_VECTOR && t.length < 0;
+}
+
+// How a vector literal is built: numbers make a NumPy array (rows of one
+// length a 2-D one), strings and rows of other vectors a list, and elements
+// of unknown type are checked at run time by _wizuall_vector
+typedef enum {
+    LITERAL_ARRAY,
+    LITERAL_LIST,
+    LITERAL_DYNAMIC
+} LiteralForm;
+
+static LiteralForm literal_form(ASTNode* literal) {
+    TypeInfo t = infer_expr_type(literal);
+    if (t.kind == TYPE_VECTOR) return LITERAL_ARRAY;
+    if (t.kind == TYPE_UNKNOWN) return LITERAL_DYNAMIC;
+    if (t.kind != TYPE_MATRIX || t.columns < 0) return LITERAL_LIST;
+    for (ASTList* e = literal->vector_literal.elements; e; e = e->next)
+        if (e->node->type != NODE_VECTOR_LITERAL) return LITERAL_LIST;
+    return LITERAL_ARRAY;
+}
+
+// avg and runningSum of a streamed column, or of a live column, are computed
+// by the import rather than by a wizuall_rt kernel
+static bool carried_forward(const char* func, ASTList* args) {
+    if (!args || args->next || (!streq(func, "avg") && !streq(func, "runningSum"))) return false;
+    return is_stream_column(args->node) || (args->node->type == NODE_ID && live_source(args->node->id_name) >= 0);
+}
+
 // Scan AST for needed imports/helpers
 void scan_for_imports_and_helpers(ASTNode* node) {
     if (!node) return;
@@ -42,24 +222,59 @@ void scan_for_imports_and_helpers(ASTNode* node) {
         case NODE_VIZ_CALL:
             matplotlib_imported = true;
             if (streq(node->viz_call.viz_func, "heatmap")) seaborn_imported = true;
+            for (ASTList* arg = node->viz_call.args; arg; arg = arg->next)
+                scan_for_imports_and_helpers(arg->node);
             break;
         case NODE_FUNCTION_CALL: {
             const char* func = node->function_call.func_name;
-            if (streq(func, "runningSum")) numpy_imported = true;
-            if (streq(func, "paretoSet")) paretoset_emitted = true;
-            if (streq(func, "pairwiseCompare")) pairwise_emitted = true;
+            if (streq(func, "runningSum") && !carried_forward(func, node->function_call.args))
+                numpy_imported = budget_emitted = running_sum_emitted = true;
+            if (streq(func, "paretoSet")) paretoset_emitted = numpy_imported = true;
+            if (streq(func, "concat")) vector_helpers_emitted = numpy_imported = true;
+            if (streq(func, "print"))
+                for (ASTList* arg = node->function_call.args; arg; arg = arg->next)
+                    if (printed_as_list(arg->node)) shown_emitted = true;
+            if (node->function_call.args) {
+                TypeInfo t = infer_expr_type(node->function_call.args->node);
+                if (streq(func, "pairwiseCompare")) {
+                    numpy_imported = true;
+                    if (t.kind != TYPE_VECTOR) pairwise_emitted = true;
+                }
+                if (t.kind == TYPE_VECTOR && !carried_forward(func, node->function_call.args)) {
+                    if (streq(func, "avg")) avg_emitted = numpy_imported = true;
+                    if (streq(func, "pairwiseCompare")) diff_emitted = true;
+                    if (streq(func, "reverse")) reversed_emitted = numpy_imported = true;
+                    if (streq(func, "sort")) sorted_emitted = numpy_imported = true;
+                }
+                if ((streq(func, "sort") || streq(func, "reverse")) && t.kind == TYPE_UNKNOWN)
+                    vector_helpers_emitted = numpy_imported = true;
+                if (streq(func, "transpose") && t.kind == TYPE_MATRIX && t.columns >= 0)
+                    numpy_imported = true;
+            }
             for (ASTList* arg = node->function_call.args; arg; arg = arg->next)
                 scan_for_imports_and_helpers(arg->node);
             break;
         }
-        case NODE_ASSIGNMENT:
+        case NODE_ASSIGNMENT: {
+            ASTNode* operand;
+            if (array_update(node, &operand)) {
+                update_emitted = numpy_imported = true;
+                scan_for_imports_and_helpers(operand);
+                break;
+            }
+            if (may_spill(node->assignment.expr)) numpy_imported = budget_emitted = true;
             scan_for_imports_and_helpers(node->assignment.expr);
             break;
+        }
         case NODE_BINARY_OP:
+            // Set only where generate_expr lowers the node to _wizuall_arith
+            if (parallel_arith(node)) arith_emitted = numpy_imported = true;
             scan_for_imports_and_helpers(node->binary_op.left);
             scan_for_imports_and_helpers(node->binary_op.right);
             break;
         case NODE_VECTOR_LITERAL:
+            if (literal_form(node) == LITERAL_ARRAY) numpy_imported = true;
+            if (literal_form(node) == LITERAL_DYNAMIC) vector_helpers_emitted = numpy_imported = true;
             for (ASTList* e = node->vector_literal.elements; e; e = e->next)
                 scan_for_imports_and_helpers(e->node);
             break;
@@ -76,37 +291,1290 @@ void scan_for_imports_and_helpers(ASTNode* node) {
                 scan_for_imports_and_helpers(s->node);
             break;
         case NODE_FOR_LOOP:
+            // range() bounds not known to be integers are rounded up with math.ceil
+            if (node->for_loop.counted && bound_needs_rounding(node->for_loop.range_bound)) math_imported = true;
+            if (node->for_loop.vector_ops) {
+                // Only the terms are emitted, over np.arange() of the loop
+                // variable; the body, condition and increment are not
+                numpy_imported = true;
+                for (VectorOp* op = node->for_loop.vector_ops; op; op = op->next) {
+                    if (op->kind == VEC_MAP || op->scan_into) vector_helpers_emitted = true;
+                    scan_for_imports_and_helpers(op->term);
+                }
+                break;
+            }
             scan_for_imports_and_helpers(node->for_loop.init);
             scan_for_imports_and_helpers(node->for_loop.condition);
             scan_for_imports_and_helpers(node->for_loop.increment);
             for (ASTList* s = node->for_loop.body; s; s = s->next)
                 scan_for_imports_and_helpers(s->node);
             break;
-        case NODE_IMPORT:
+        case NODE_EXPORT:
+            export_emitted = true;
+            break;
+        case NODE_IMPORT: {
+            char path[256];
+            import_path(node->import.filename, path, sizeof(path));
+            if (node->import.live) {
+                live_reader_emitted = true;
+                break;
+            }
+            const ImportSchema* schema = static_imports ? find_import_schema(path, node->import.table) : NULL;
+            if (import_format(path) == IMPORT_CSV && import_is_gzip(path)) gzip_reader_emitted = true;
+            if (schema && import_streams_columns(path, schema)) stream_reader_emitted = minmax_emitted = numpy_imported = true;
+            if (import_format(path) == IMPORT_SQLITE) {
+                if (!schema || import_reads_columns(path, schema)) sqlite_reader_emitted = true;
+            } else if (schema && import_reads_columns(path, schema)) {
+                if (schema->format == IMPORT_JSON) json_reader_emitted = true;
+                else csv_reader_emitted = true;
+            } else if (!schema && import_format(path) == IMPORT_CSV) {
+                csv_reader_emitted = true;
+            } else if (!schema && import_format(path) == IMPORT_JSON) {
+                json_reader_emitted = true;
+            }
             break;
+        }
         default:
             break;
     }
 }
 
+// Only the prelude pieces something in the (optimised) program reaches are emitted
 void emit_imports(FILE* out) {
-    // Always suppress matplotlib UserWarnings at the very top
-    fprintf(out, "import warnings\nwarnings.filterwarnings(\"ignore\", category=UserWarning, module=\"matplotlib\")\n");
     if (matplotlib_imported) {
+        // Suppress matplotlib UserWarnings before pyplot is loaded
+        fprintf(out, "import warnings\nwarnings.filterwarnings(\"ignore\", category=UserWarning, module=\"matplotlib\")\n");
         fprintf(out, "import matplotlib.pyplot as plt\n");
     }
     if (numpy_imported) fprintf(out, "import numpy as np\n");
-    // Ensure plot_counter is defined before use
-    fprintf(out, "plot_counter = 1\n");
-    fprintf(out, "import time\n_wizuall_run_id = int(time.time())\n");
+    if (math_imported) fprintf(out, "import math\n");
+    if (matplotlib_imported) {
+        // Ensure plot_counter is defined before use
+        fprintf(out, "plot_counter = 1\n");
+        fprintf(out, "import time\n_wizuall_run_id = int(time.time())\n");
+        // Add code to create 'plots' directory if it doesn't exist
+        fprintf(out, "import os\n");
+        fprintf(out, "os.makedirs('plots', exist_ok=True)\n");
+    }
 }
 
 void emit_helpers(FILE* out) {
     if (pairwise_emitted) {
-        fprintf(out, "def pairwise_compare(x):\n    return [x[i+1] - x[i] for i in range(len(x)-1)]\n\n");
+        fprintf(out, "def pairwise_compare(x):\n    return np.diff(x) if isinstance(x, np.ndarray) else [x[i+1] - x[i] for i in range(len(x)-1)]\n\n");
     }
     if (paretoset_emitted) {
-        fprintf(out, "def pareto_set(x):\n    # Dummy implementation: returns unique values\n    return list(set(x))\n\n");
+        fprintf(out, "def pareto_set(x):\n    # Dummy implementation: returns unique values\n    return np.unique(x) if isinstance(x, np.ndarray) else list(set(x))\n\n");
+    }
+    if (shown_emitted) {
+        fprintf(out,
+            "def _wizuall_shown(x):\n"
+            "    # A vector as print shows it: arrays in the list format, e.g. [1, 2, 3]\n"
+            "    if isinstance(x, list):\n"
+            "        return [_wizuall_shown(e) for e in x]\n"
+            "    return x.tolist() if hasattr(x, 'tolist') else x\n\n");
+    }
+    if (update_emitted) {
+        fprintf(out,
+            "def _wizuall_update(ufunc, x, y):\n"
+            "    # `x = x op y` on a vector nothing else holds: written over x when the\n"
+            "    # result keeps x's shape and dtype (an int64 x stays a new array next to a\n"
+            "    # float y), else computed into a new array\n"
+            "    if isinstance(x, np.ndarray) and x.flags.writeable and np.shape(y) in ((), x.shape) \\\n"
+            "            and np.result_type(x, y) == x.dtype and (ufunc is not np.true_divide or x.dtype.kind == 'f'):\n"
+            "        return ufunc(x, y, out=x)\n"
+            "    return ufunc(x, y)\n\n");
+    }
+    if (vector_helpers_emitted) {
+        fprintf(out,
+            "import weakref\n\n"
+            "def _wizuall_vector(elements):\n"
+            "    # A vector literal whose elements were not typed at compile time: numbers\n"
+            "    # make a NumPy array, anything else stays a list\n"
+            "    if all(isinstance(e, (int, float, np.number)) for e in elements):\n"
+            "        return np.asarray(elements)\n"
+            "    return elements\n\n"
+            "class _WizuallBuffer(np.ndarray):\n"
+            "    # Storage of a vector grown by `x = concat(x, v)`. `tail` refers to the view\n"
+            "    # of its filled part that the last append returned; only that vector appends\n"
+            "    # in place, so the values other names see are never overwritten.\n"
+            "    pass\n\n"
+            "def _wizuall_concat(a, b, grow=False):\n"
+            "    # `concat`: vectors are joined as arrays, lists of strings as lists, and an\n"
+            "    # empty side leaves the other as it is. With grow (`x = concat(x, v)`) the\n"
+            "    # array goes into spare room of the buffer x fills, doubled when full, so\n"
+            "    # a loop of appends does not copy x every time.\n"
+            "    if not len(b):\n"
+            "        return a if grow else a.copy()\n"
+            "    if not len(a):\n"
+            "        return b.copy()\n"
+            "    if isinstance(a, list) and isinstance(b, list):\n"
+            "        return a + b\n"
+            "    if not grow or type(a) is not np.ndarray or a.ndim != 1 or np.ndim(b) != 1:\n"
+            "        return np.concatenate((a, b))\n"
+            "    b = np.asarray(b)\n"
+            "    buffer = a.base\n"
+            "    end = a.size + b.size\n"
+            "    dtype = np.result_type(a, b)\n"
+            "    if type(buffer) is not _WizuallBuffer or buffer.tail() is not a or buffer.size < end or buffer.dtype != dtype:\n"
+            "        buffer = _WizuallBuffer(max(2 * end, 16), dtype)\n"
+            "        buffer[:a.size] = a\n"
+            "    buffer[a.size:end] = b\n"
+            "    result = np.ndarray((end,), dtype, buffer)\n"
+            "    buffer.tail = weakref.ref(result)\n"
+            "    return result\n\n"
+            "def _wizuall_append(x, value):\n"
+            "    # `x = concat(x, [value])`, storing one number straight into the buffer\n"
+            "    buffer = x.base if type(x) is np.ndarray else None\n"
+            "    if type(buffer) is _WizuallBuffer and buffer.tail() is x and x.size < buffer.size \\\n"
+            "            and (type(value) is int or (type(value) is float and buffer.dtype.kind == 'f')):\n"
+            "        buffer[x.size] = value\n"
+            "        result = np.ndarray((x.size + 1,), buffer.dtype, buffer)\n"
+            "        buffer.tail = weakref.ref(result)\n"
+            "        return result\n"
+            "    return _wizuall_concat(x, _wizuall_vector([value]), True)\n\n"
+            "def _wizuall_sort(x):\n"
+            "    return np.sort(x) if isinstance(x, np.ndarray) else sorted(x)\n\n"
+            "def _wizuall_reverse(x):\n"
+            "    return x[::-1].copy() if isinstance(x, np.ndarray) else list(reversed(x))\n\n");
+    }
+    bool parallel = sorted_emitted || arith_emitted;
+    bool kernel = avg_emitted || diff_emitted || reversed_emitted || minmax_emitted || running_sum_emitted || parallel;
+    if (kernel) {
+        // The NumPy calls stay as the fallback: without wizuall_rt, and for
+        // vectors of other dtypes (bool, or object when ints overflow int64)
+        fprintf(out,
+            "_wizuall_native = (np.dtype(np.int64), np.dtype(np.float64))\n\n"
+            "def _wizuall_kernel(x):\n"
+            "    # Whether the SIMD kernels of wizuall_rt take x: a 1-D int64/float64 array\n"
+            "    return _wizuall_rt is not None and isinstance(x, np.ndarray) and x.ndim == 1 and x.dtype in _wizuall_native\n\n");
+    }
+    if (avg_emitted) {
+        fprintf(out,
+            "def _wizuall_avg(x):\n"
+            "    # Floats give np.mean's result; ints are summed exactly, as sum() sums them\n"
+            "    return _wizuall_rt.avg(x) if _wizuall_kernel(x) else float(np.mean(x))\n\n");
+    }
+    if (diff_emitted) {
+        fprintf(out,
+            "def _wizuall_diff(x):\n"
+            "    return _wizuall_rt.diff(x) if _wizuall_kernel(x) else np.diff(x)\n\n");
+    }
+    if (reversed_emitted) {
+        fprintf(out,
+            "def _wizuall_reversed(x):\n"
+            "    return _wizuall_rt.reverse(x) if _wizuall_kernel(x) else x[::-1].copy()\n\n");
+    }
+    if (minmax_emitted) {
+        fprintf(out,
+            "def _wizuall_minmax(x):\n"
+            "    # x.min() and x.max() in one pass over x\n"
+            "    return _wizuall_rt.minmax(x) if _wizuall_kernel(x) and len(x) else (x.min(), x.max())\n\n");
+    }
+    if (parallel) {
+        fprintf(out,
+            "def _wizuall_parallel(x):\n"
+            "    # Whether wizuall_rt splits its work on x across threads (WIZUALL_THREADS)\n"
+            "    return _wizuall_kernel(x) and x.size >= _wizuall_rt.PARALLEL_MIN and _wizuall_rt.threads() > 1\n\n");
+    }
+    if (sorted_emitted) {
+        fprintf(out,
+            "def _wizuall_sorted(x):\n"
+            "    return _wizuall_rt.sort(x) if _wizuall_parallel(x) else np.sort(x)\n\n");
+    }
+    if (arith_emitted) {
+        fprintf(out,
+            "_wizuall_operators = {'+': lambda a, b: a + b, '-': lambda a, b: a - b,\n"
+            "                      '*': lambda a, b: a * b, '/': lambda a, b: a / b}\n\n"
+            "def _wizuall_arith(op, a, b):\n"
+            "    # a op b, elementwise on the wizuall_rt thread pool when it takes the operands\n"
+            "    if _wizuall_parallel(a) or _wizuall_parallel(b):\n"
+            "        result = _wizuall_rt.arith(op, a, b)\n"
+            "        if result is not NotImplemented:\n"
+            "            return result\n"
+            "    return _wizuall_operators[op](a, b)\n\n");
+    }
+    if (csv_reader_emitted || stream_reader_emitted || budget_emitted || live_reader_emitted) {
+        fprintf(out,
+            "def _wizuall_option(name):\n"
+            "    # Value of `name value` or `name=value` on the command line of output.py\n"
+            "    import sys\n"
+            "    args = sys.argv[1:]\n"
+            "    for i, arg in enumerate(args):\n"
+            "        if arg == name:\n"
+            "            return args[i + 1] if i + 1 < len(args) else ''\n"
+            "        if arg.startswith(name + '='):\n"
+            "            return arg[len(name) + 1:]\n"
+            "    return None\n\n");
+    }
+    if (budget_emitted) {
+        // Derived arrays past the budget live in files the kernel can write
+        // back and evict, instead of anonymous memory that can only be swapped
+        fprintf(out,
+            "def _wizuall_mem_limit_option():\n"
+            "    # `python3 output.py --mem-limit 2G`: a budget for the process's memory\n"
+            "    import re\n"
+            "    value = _wizuall_option('--mem-limit')\n"
+            "    if value is None:\n"
+            "        return None\n"
+            "    match = re.fullmatch(r'(\\d+(?:\\.\\d+)?)\\s*([KMGT]?)(?:i?B)?', value.strip(), re.IGNORECASE)\n"
+            "    if not match:\n"
+            "        raise SystemExit('--mem-limit takes a size such as 512M or 2G, not %%r' %% value)\n"
+            "    return int(float(match[1]) * 1024 ** ' KMGT'.index(match[2].upper() or ' '))\n\n"
+            "_wizuall_mem_limit = _wizuall_mem_limit_option()\n"
+            "_wizuall_scratch_dir = None\n\n"
+            "def _wizuall_resident_bytes():\n"
+            "    # Memory of the process in RAM, pages of mapped files included; scratch\n"
+            "    # arrays keep theirs out with _wizuall_page_out\n"
+            "    try:\n"
+            "        with open('/proc/self/status') as f:\n"
+            "            for line in f:\n"
+            "                if line.startswith('VmRSS:'):\n"
+            "                    return int(line.split()[1]) * 1024\n"
+            "    except OSError:\n"
+            "        pass\n"
+            "    import resource\n"
+            "    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss * 1024\n\n"
+            "def _wizuall_over_budget(nbytes):\n"
+            "    # Arrays under 1 MB are never worth a file\n"
+            "    return _wizuall_mem_limit is not None and nbytes >= 1 << 20 and _wizuall_resident_bytes() + nbytes > _wizuall_mem_limit\n\n"
+            "def _wizuall_scratch(shape, dtype):\n"
+            "    # An array backed by a file of $WIZUALL_SCRATCH_DIR (default: the system's\n"
+            "    # temporary directory). The file is unlinked at once, so its space is\n"
+            "    # freed with the array; the directory is removed at exit.\n"
+            "    global _wizuall_scratch_dir\n"
+            "    import atexit, mmap, os, shutil, tempfile\n"
+            "    if _wizuall_scratch_dir is None:\n"
+            "        _wizuall_scratch_dir = tempfile.mkdtemp(prefix='wizuall-', dir=os.environ.get('WIZUALL_SCRATCH_DIR') or None)\n"
+            "        atexit.register(shutil.rmtree, _wizuall_scratch_dir, True)\n"
+            "    dtype = np.dtype(dtype)\n"
+            "    size = max(int(np.prod(shape)) * dtype.itemsize, 1)\n"
+            "    fd, path = tempfile.mkstemp(dir=_wizuall_scratch_dir)\n"
+            "    try:\n"
+            "        os.ftruncate(fd, size)\n"
+            "        mapped = mmap.mmap(fd, size)\n"
+            "    finally:\n"
+            "        os.close(fd)\n"
+            "        os.unlink(path)\n"
+            "    return np.frombuffer(mapped, dtype, int(np.prod(shape))).reshape(shape)\n\n"
+            "def _wizuall_page_out(array):\n"
+            "    # Writes the pages of a scratch array to its file and drops them from the\n"
+            "    # process; they are read back when next used. Other arrays are left as is.\n"
+            "    import mmap\n"
+            "    base = array\n"
+            "    while base is not None and not isinstance(base, mmap.mmap):\n"
+            "        base = base.obj if isinstance(base, memoryview) else getattr(base, 'base', None)\n"
+            "    if base is not None:\n"
+            "        base.flush()\n"
+            "        base.madvise(mmap.MADV_DONTNEED)\n"
+            "    return array\n\n"
+            "def _wizuall_spill(value, *vectors):\n"
+            "    # An array a statement just computed moves to a scratch file when the\n"
+            "    # process is over the --mem-limit budget; views and other values stay.\n"
+            "    # An elementwise expression comes as a function of its vectors. Under a\n"
+            "    # budget it is computed a block at a time, so its full-size temporaries\n"
+            "    # never exist, into a scratch file when the result would take the process\n"
+            "    # over the budget. Pages of that file, and of operands that are scratch\n"
+            "    # arrays themselves, are dropped behind each block.\n"
+            "    if callable(value):\n"
+            "        if _wizuall_mem_limit is not None and all(type(v) is np.ndarray and v.ndim == 1 and v.shape == vectors[0].shape for v in vectors):\n"
+            "            dtype = value(*[v[:0] for v in vectors]).dtype\n"
+            "            nbytes = vectors[0].size * dtype.itemsize\n"
+            "            spilled = _wizuall_scratch(vectors[0].shape, dtype) if _wizuall_over_budget(nbytes) else np.empty(vectors[0].shape, dtype)\n"
+            "            step = 1 << 20\n"
+            "            for start in range(0, spilled.size, step):\n"
+            "                spilled[start:start + step] = value(*[v[start:start + step] for v in vectors])\n"
+            "                for array in (spilled,) + vectors:\n"
+            "                    _wizuall_page_out(array)\n"
+            "            return spilled\n"
+            "        return value(*vectors)\n"
+            "    if _wizuall_mem_limit is None or type(value) is not np.ndarray or value.base is not None:\n"
+            "        return value\n"
+            "    if value.nbytes < 1 << 20 or _wizuall_resident_bytes() <= _wizuall_mem_limit:\n"
+            "        return value\n"
+            "    spilled = _wizuall_scratch(value.shape, value.dtype)\n"
+            "    spilled[...] = value\n"
+            "    return _wizuall_page_out(spilled)\n\n");
+        if (running_sum_emitted) {
+            fprintf(out,
+                "def _wizuall_running_sum(x):\n"
+                "    # np.cumsum (the wizuall_rt scan for int64/float64 vectors). Under a\n"
+                "    # --mem-limit budget it is scanned a block at a time, each block carrying\n"
+                "    # the last sum of the one before, into a scratch file when the result would\n"
+                "    # take the process over the budget, paging out like _wizuall_spill.\n"
+                "    if _wizuall_mem_limit is not None and isinstance(x, np.ndarray) and x.ndim == 1:\n"
+                "        dtype = np.cumsum(x[:0]).dtype\n"
+                "        total = _wizuall_scratch(x.shape, dtype) if _wizuall_over_budget(x.size * dtype.itemsize) else np.empty(x.shape, dtype)\n"
+                "        step = 1 << 20\n"
+                "        for start in range(0, x.size, step):\n"
+                "            part, block = x[start:start + step], total[start:start + step]\n"
+                "            if _wizuall_kernel(part):\n"
+                "                _wizuall_rt.running_sum(part, block)\n"
+                "            else:\n"
+                "                np.cumsum(part, out=block)\n"
+                "            if start:\n"
+                "                block += total[start - 1]\n"
+                "            _wizuall_page_out(total)\n"
+                "            _wizuall_page_out(x)\n"
+                "        return total\n"
+                "    return _wizuall_rt.running_sum(x) if _wizuall_kernel(x) else np.cumsum(x)\n\n");
+        }
+    }
+    if (csv_reader_emitted || stream_reader_emitted || json_reader_emitted || sqlite_reader_emitted || export_emitted || live_reader_emitted
+        || kernel) {
+        fprintf(out,
+            "try:\n"
+            "    import wizuall_rt as _wizuall_rt\n"
+            "except ImportError:\n"
+            "    _wizuall_rt = None\n\n");
+    }
+    if (prefetch_emitted) {
+        fprintf(out,
+            "_wizuall_prefetcher = None\n\n"
+            "def _wizuall_prefetch(load):\n"
+            "    # Starts load() on a background thread and returns a function that waits\n"
+            "    # for its result. The thread runs the loads one after another in program\n"
+            "    # order, and the native readers release the GIL while they parse. With a\n"
+            "    # single CPU the parsers could only take turns with the program, so the\n"
+            "    # returned function runs load() itself when its result is first wanted.\n"
+            "    global _wizuall_prefetcher\n"
+            "    import os\n"
+            "    cpus = len(os.sched_getaffinity(0)) if hasattr(os, 'sched_getaffinity') else os.cpu_count() or 1\n"
+            "    if cpus < 2:\n"
+            "        return load\n"
+            "    if _wizuall_prefetcher is None:\n"
+            "        from concurrent.futures import ThreadPoolExecutor\n"
+            "        _wizuall_prefetcher = ThreadPoolExecutor(1)\n"
+            "    return _wizuall_prefetcher.submit(load).result\n\n");
+    }
+    if (export_emitted) {
+        // A .wzb file is the .npz layout: np.load maps each column back without
+        // parsing, and other tools read .npy members with a fixed header
+        fprintf(out,
+            "def _wizuall_export_column(value):\n"
+            "    # A vector as a 1-D int64, float64 or str array; anything else becomes text\n"
+            "    import numpy as np\n"
+            "    try:\n"
+            "        array = np.asarray(value)\n"
+            "    except ValueError:\n"
+            "        array = np.empty(len(value), dtype=object)\n"
+            "        array[:] = [cell for cell in value]\n"
+            "    if array.ndim == 0:\n"
+            "        array = array.reshape(1)\n"
+            "    if array.dtype.kind in 'iu':\n"
+            "        return array.astype(np.int64, copy=False)\n"
+            "    if array.dtype.kind == 'f':\n"
+            "        return array.astype(np.float64, copy=False)\n"
+            "    if array.dtype.kind != 'U':\n"
+            "        array = np.array(['' if cell is None else str(cell) for cell in array.ravel().tolist()], dtype=str).reshape(array.shape)\n"
+            "    return array\n\n"
+            "def _wizuall_export(path, vectors):\n"
+            "    # `export x, y to \"f\"`: a .csv file gets a header and one column per\n"
+            "    # vector; a .wzb file is an uncompressed .npz archive of one .npy array per\n"
+            "    # vector, in order, which np.load(path) reads back. Each column is written\n"
+            "    # in one buffered pass, to a partial file renamed over `path` when complete.\n"
+            "    import os\n"
+            "    import numpy as np\n"
+            "    columns = {name: _wizuall_export_column(value) for name, value in vectors.items()}\n"
+            "    if os.path.dirname(path):\n"
+            "        os.makedirs(os.path.dirname(path), exist_ok=True)\n"
+            "    partial = path + '.partial'\n"
+            "    if path.endswith('.csv'):\n"
+            "        for name, column in columns.items():\n"
+            "            if column.ndim != 1:\n"
+            "                raise ValueError('export to %%s: %%s is not a vector (shape %%s)' %% (path, name, column.shape))\n"
+            "        cells = [column if column.dtype.kind in 'if' else column.tolist() for column in columns.values()]\n"
+            "        if _wizuall_rt:\n"
+            "            _wizuall_rt.write_csv(partial, list(columns), cells)\n"
+            "        else:\n"
+            "            import csv, itertools\n"
+            "            with open(partial, 'w', newline='') as f:\n"
+            "                writer = csv.writer(f, lineterminator='\\n')\n"
+            "                writer.writerow(columns)\n"
+            "                writer.writerows(itertools.zip_longest(*[cell if isinstance(cell, list) else cell.tolist() for cell in cells], fillvalue=''))\n"
+            "    else:\n"
+            "        import zipfile\n"
+            "        with zipfile.ZipFile(partial, 'w', zipfile.ZIP_STORED, allowZip64=True) as archive:\n"
+            "            for name, column in columns.items():\n"
+            "                with archive.open(name + '.npy', 'w', force_zip64=True) as member:\n"
+            "                    np.lib.format.write_array(member, column, allow_pickle=False)\n"
+            "    os.replace(partial, path)\n\n");
+    }
+    if (csv_reader_emitted || stream_reader_emitted || json_reader_emitted) {
+        fprintf(out,
+            "def _wizuall_open(path, newline=None):\n"
+            "    # .gz files are decompressed as they are read, never to disk\n"
+            "    if path.endswith('.gz'):\n"
+            "        import gzip\n"
+            "        return gzip.open(path, 'rt', newline=newline)\n"
+            "    return open(path, 'r', newline=newline)\n\n"
+            "def _wizuall_files(path):\n"
+            "    # The files a pattern such as logs/*.csv matches, in name order\n"
+            "    import glob\n"
+            "    if not glob.has_magic(path):\n"
+            "        return [path]\n"
+            "    files = sorted(glob.glob(path))\n"
+            "    if not files:\n"
+            "        raise FileNotFoundError(2, 'No files match the pattern', path)\n"
+            "    return files\n\n");
+    }
+    if (csv_reader_emitted || stream_reader_emitted || live_reader_emitted) {
+        fprintf(out,
+            "def _wizuall_column(cells):\n"
+            "    # Columns of numbers become int64 or float64 arrays, as the native reader returns them\n"
+            "    import numpy as np\n"
+            "    if cells and None not in cells:\n"
+            "        for dtype in (np.int64, np.float64):\n"
+            "            try:\n"
+            "                return np.array(cells, dtype=dtype)\n"
+            "            except (ValueError, OverflowError):\n"
+            "                pass\n"
+            "    return cells\n\n");
+    }
+    if (live_reader_emitted) {
+        // Rows appended to a live import are parsed from the last offset, so
+        // the work per update follows the new rows instead of the file size
+        fprintf(out,
+            "class _WizuallLive:\n"
+            "    # `import \"f.csv\" live;`: the columns of a CSV file, or FIFO, that keeps\n"
+            "    # growing. poll() parses only the complete lines appended since the last\n"
+            "    # read and appends their cells to arrays with spare room, so an update\n"
+            "    # costs the new rows and not the file; avg and runningSum of a column are\n"
+            "    # carried forward the same way. A file that shrinks or is replaced is read\n"
+            "    # again from its start, and a FIFO ends when its writer closes it.\n"
+            "    def __init__(self, path, names=None):\n"
+            "        import os, stat\n"
+            "        self.path = path\n"
+            "        self.names = names\n"
+            "        self.fd = os.open(path, os.O_RDONLY)   # a FIFO waits here for a writer\n"
+            "        self.fifo = stat.S_ISFIFO(os.fstat(self.fd).st_mode)\n"
+            "        self.closed = False\n"
+            "        self.restart()\n"
+            "        if self.fifo:\n"
+            "            # The first run of the program needs at least the header\n"
+            "            while self.header is None and not self.closed:\n"
+            "                self.poll(block=True)\n"
+            "            os.set_blocking(self.fd, False)\n"
+            "        self.poll()\n"
+            "\n"
+            "    def restart(self):\n"
+            "        self.pending = b''\n"
+            "        self.header = None\n"
+            "        self.rows = 0\n"
+            "        self.data = {}      # column: array with spare room at the end, or list of text cells\n"
+            "        self.sums = {}      # column: sum of its rows, once avg asked for it\n"
+            "        self.scans = {}     # column: its running sums, once runningSum asked for them\n"
+            "\n"
+            "    def read(self, block):\n"
+            "        # The complete lines appended since the last read\n"
+            "        import os\n"
+            "        chunks = []\n"
+            "        while True:\n"
+            "            try:\n"
+            "                chunk = os.read(self.fd, 1 << 20)\n"
+            "            except BlockingIOError:\n"
+            "                break\n"
+            "            if not chunk:\n"
+            "                self.closed = self.fifo\n"
+            "                break\n"
+            "            chunks.append(chunk)\n"
+            "            if block:\n"
+            "                break\n"
+            "        data = self.pending + b''.join(chunks)\n"
+            "        if self.closed:\n"
+            "            self.pending = b''\n"
+            "            return data if data.endswith(b'\\n') or not data else data + b'\\n'\n"
+            "        cut = data.rfind(b'\\n') + 1\n"
+            "        self.pending = data[cut:]\n"
+            "        return data[:cut]\n"
+            "\n"
+            "    def replaced(self):\n"
+            "        # The file was truncated, or renamed away and created again\n"
+            "        import os\n"
+            "        try:\n"
+            "            current = os.stat(self.path)\n"
+            "        except FileNotFoundError:\n"
+            "            return False\n"
+            "        opened = os.fstat(self.fd)\n"
+            "        return (current.st_dev, current.st_ino) != (opened.st_dev, opened.st_ino) or current.st_size < os.lseek(self.fd, 0, os.SEEK_CUR)\n"
+            "\n"
+            "    def poll(self, block=False):\n"
+            "        # Appends the rows written since the last call; True if there are any\n"
+            "        # (or the file started over)\n"
+            "        import os\n"
+            "        restarted = False\n"
+            "        if not self.fifo and self.replaced():\n"
+            "            os.close(self.fd)\n"
+            "            self.fd = os.open(self.path, os.O_RDONLY)\n"
+            "            self.restart()\n"
+            "            restarted = True\n"
+            "        lines = self.read(block)\n"
+            "        if self.header is None:\n"
+            "            end = lines.find(b'\\n') + 1\n"
+            "            if not end:\n"
+            "                return restarted\n"
+            "            self.header, lines = lines[:end], lines[end:]\n"
+            "            # Bind the columns of the header, empty until rows arrive\n"
+            "            self.append(self.parse(b''))\n"
+            "        if not lines:\n"
+            "            return restarted\n"
+            "        self.append(self.parse(lines))\n"
+            "        return True\n"
+            "\n"
+            "    def parse(self, lines):\n"
+            "        # Columns of complete lines, typed as the import reader types them\n"
+            "        if _wizuall_rt:\n"
+            "            return _wizuall_rt.read_csv(self.header + lines, self.names)\n"
+            "        import csv, io\n"
+            "        reader = csv.reader(io.StringIO((self.header + lines).decode('utf-8')))\n"
+            "        header = next(reader, [])\n"
+            "        index = {name: i for i, name in enumerate(header)}\n"
+            "        rows = [row for row in reader if row]\n"
+            "        names = [name for name in (self.names if self.names is not None else index) if name in index]\n"
+            "        return {name: _wizuall_column([row[index[name]] if index[name] < len(row) else None for row in rows]) for name in names}\n"
+            "\n"
+            "    @staticmethod\n"
+            "    def extend(buffer, used, values):\n"
+            "        # buffer[:used] followed by values, in buffer itself when it has room;\n"
+            "        # a larger buffer doubles, so appending n rows costs O(n) overall\n"
+            "        import numpy as np\n"
+            "        dtype = np.result_type(buffer, values)\n"
+            "        end = used + len(values)\n"
+            "        if dtype != buffer.dtype or end > len(buffer):\n"
+            "            grown = np.empty(max(end, 2 * len(buffer), 1024), dtype)\n"
+            "            grown[:used] = buffer[:used]\n"
+            "            buffer = grown\n"
+            "        buffer[used:end] = values\n"
+            "        return buffer\n"
+            "\n"
+            "    def append(self, columns):\n"
+            "        import numpy as np\n"
+            "        count = len(next(iter(columns.values()), []))\n"
+            "        for name, values in columns.items():\n"
+            "            old = self.data.get(name) if self.rows else None\n"
+            "            if isinstance(values, np.ndarray) and (old is None or isinstance(old, np.ndarray)):\n"
+            "                self.data[name] = self.extend(np.empty(0, values.dtype) if old is None else old, self.rows, values)\n"
+            "            else:\n"
+            "                # Text arrived in a column of numbers (or the reverse): it holds text from now on\n"
+            "                if isinstance(old, np.ndarray):\n"
+            "                    old = [str(cell) for cell in old[:self.rows].tolist()]\n"
+            "                if isinstance(values, np.ndarray):\n"
+            "                    values = [str(cell) for cell in values.tolist()]\n"
+            "                self.data[name] = old = old if old is not None else []\n"
+            "                old.extend(values)\n"
+            "                # avg and runningSum of text fail as they would on a full import\n"
+            "                self.sums.pop(name, None)\n"
+            "                self.scans.pop(name, None)\n"
+            "            if name in self.sums:\n"
+            "                self.sums[name] += np.sum(values, dtype=np.float64)\n"
+            "            if name in self.scans:\n"
+            "                scan = np.cumsum(values)\n"
+            "                if self.rows:\n"
+            "                    scan = scan + self.scans[name][self.rows - 1]\n"
+            "                self.scans[name] = self.extend(self.scans[name], self.rows, scan)\n"
+            "        self.rows += count\n"
+            "\n"
+            "    def column(self, name):\n"
+            "        import numpy as np\n"
+            "        values = self.data.get(name, [])\n"
+            "        if not isinstance(values, np.ndarray):\n"
+            "            return values\n"
+            "        view = values[:self.rows]\n"
+            "        view.flags.writeable = False   # the rows after it are written in place\n"
+            "        return view\n"
+            "\n"
+            "    def columns(self):\n"
+            "        return {name: self.column(name) for name in (self.names if self.names is not None else self.data)}\n"
+            "\n"
+            "    def avg(self, name):\n"
+            "        import numpy as np\n"
+            "        if name not in self.sums:\n"
+            "            self.sums[name] = np.sum(self.column(name), dtype=np.float64)\n"
+            "        return float(self.sums[name] / self.rows) if self.rows else float('nan')\n"
+            "\n"
+            "    def running_sum(self, name):\n"
+            "        import numpy as np\n"
+            "        if name not in self.scans:\n"
+            "            self.scans[name] = np.cumsum(self.column(name))\n"
+            "        view = self.scans[name][:self.rows]\n"
+            "        view.flags.writeable = False\n"
+            "        return view\n"
+            "\n"
+            "def _wizuall_live_wait(sources):\n"
+            "    # Waits until rows are appended to a live import. False once every FIFO\n"
+            "    # is closed, after --live-timeout seconds without new rows, or on Ctrl-C;\n"
+            "    # files are checked every --live-interval seconds (default 1)\n"
+            "    import select, time\n"
+            "    interval = float(_wizuall_option('--live-interval') or 1)\n"
+            "    timeout = _wizuall_option('--live-timeout')\n"
+            "    deadline = None if timeout is None else time.monotonic() + float(timeout)\n"
+            "    try:\n"
+            "        while True:\n"
+            "            if any([source.poll() for source in sources]):\n"
+            "                return True\n"
+            "            if all(source.closed for source in sources):\n"
+            "                return False\n"
+            "            wait = interval if deadline is None else min(interval, deadline - time.monotonic())\n"
+            "            if wait <= 0:\n"
+            "                return False\n"
+            "            fifos = [source.fd for source in sources if source.fifo and not source.closed]\n"
+            "            if fifos:\n"
+            "                select.select(fifos, [], [], wait)\n"
+            "            else:\n"
+            "                time.sleep(wait)\n"
+            "    except KeyboardInterrupt:\n"
+            "        return False\n\n");
+    }
+    if (csv_reader_emitted || stream_reader_emitted) {
+        // A sample passes the rows through once, a chunk at a time, keeping
+        // only the rows drawn; .gz files are inflated block by block when
+        // that reader is emitted, else handed to the native reader whole
+        fprintf(out,
+            "def _wizuall_read_csv_sample(files, names, sample):\n"
+            "    # A preview: a fraction (float) or a number (int) of the rows, drawn with\n"
+            "    # a fixed seed so reruns show the same rows, in file order. The native\n"
+            "    # reader parses only random blocks of uncompressed files, about four\n"
+            "    # times the bytes the sample needs, and the rows are drawn from all of\n"
+            "    # them, so they spread over the file. Rows pass through once; a fraction\n"
+            "    # keeps each with its probability, a count keeps a reservoir of them.\n"
+            "    import math, os, random\n"
+            "    import numpy as np\n"
+            "    if not _wizuall_rt:\n"
+            "        import csv\n"
+            "        rng = random.Random(0)\n"
+            "        kept, seen = [], 0\n"
+            "        for file in files:\n"
+            "            with _wizuall_open(file, newline='') as f:\n"
+            "                reader = csv.reader(f)\n"
+            "                where = {name: i for i, name in enumerate(next(reader, []))}\n"
+            "                if names is None:\n"
+            "                    names = list(where)\n"
+            "                picks = [where[name] for name in names]\n"
+            "                for row in reader:\n"
+            "                    if not row:\n"
+            "                        continue\n"
+            "                    seen += 1\n"
+            "                    if isinstance(sample, float):\n"
+            "                        if rng.random() >= sample:\n"
+            "                            continue\n"
+            "                        slot = len(kept)\n"
+            "                    else:\n"
+            "                        # Algorithm R, remembering each row's position\n"
+            "                        slot = len(kept) if len(kept) < sample else rng.randrange(seen)\n"
+            "                        if slot >= sample:\n"
+            "                            continue\n"
+            "                    cells = (seen, [row[i] if i < len(row) else None for i in picks])\n"
+            "                    if slot == len(kept):\n"
+            "                        kept.append(cells)\n"
+            "                    else:\n"
+            "                        kept[slot] = cells\n"
+            "        kept.sort(key=lambda cells: cells[0])\n"
+            "        return {name: _wizuall_column([cells[j] for _, cells in kept]) for j, name in enumerate(names or [])}\n"
+            "\n"
+            "    rng = np.random.default_rng(0)\n"
+            "    plain = [file for file in files if not file.endswith('.gz')]\n"
+            "    sizes = {file: os.path.getsize(file) for file in plain}\n"
+            "    block = min(max(sum(sizes.values()) // 4096, 1 << 16), 1 << 20)\n"
+            "    blocks = [(file, start) for file in plain for start in range(0, sizes[file], block)]\n"
+            "    if isinstance(sample, float):\n"
+            "        count = math.ceil(len(blocks) * sample * 4)\n"
+            "    elif plain:\n"
+            "        with open(plain[0], 'rb') as f:\n"
+            "            head = f.read(1 << 16)\n"
+            "        per_row = len(head) / max(head.count(b'\\n') - 1, 1)\n"
+            "        count = math.ceil(sample * per_row * 4 / block)\n"
+            "    else:\n"
+            "        count = 0\n"
+            "\n"
+            "    def take(column, where):\n"
+            "        return column[where] if isinstance(column, np.ndarray) else [column[i] for i in where]\n"
+            "\n"
+            "    def join(parts):\n"
+            "        if all(isinstance(part, np.ndarray) for part in parts):\n"
+            "            return np.concatenate(parts)\n"
+            "        return [cell for part in parts for cell in (part.tolist() if isinstance(part, np.ndarray) else part)]\n"
+            "\n"
+            "    def chunks(chosen, share):\n"
+            "        # (columns, chance of each row) per group of chosen blocks, or per\n"
+            "        # inflated block of a .gz file, whose rows all pass\n"
+            "        for file in files:\n"
+            "            if file.endswith('.gz'):\n");
+        if (gzip_reader_emitted) {
+            fprintf(out,
+                "                for text in _wizuall_gzip_blocks(file, 1 << 22):\n"
+                "                    yield _wizuall_rt.read_csv(text, names), sample\n");
+        } else {
+            fprintf(out,
+                "                yield _wizuall_rt.read_csv(file, names), sample\n");
+        }
+        fprintf(out,
+            "                continue\n"
+            "            starts = [start for f, start in chosen if f == file]\n"
+            "            for i in range(0, len(starts), 64):\n"
+            "                ranges = [(start, start + block) for start in starts[i:i + 64]]\n"
+            "                yield _wizuall_rt.read_csv(file, names, ranges=ranges), share\n"
+            "\n"
+            "    while True:\n"
+            "        count = min(count, len(blocks))\n"
+            "        chosen = sorted(blocks[i] for i in rng.choice(len(blocks), count, replace=False))\n"
+            "        # Rows of the chosen blocks are thinned to the fraction of the file\n"
+            "        share = min(sample * len(blocks) / count, 1.0) if isinstance(sample, float) and count else sample\n"
+            "        kept, keys, first = [], np.empty(0), None\n"
+            "        for part, chance in chunks(chosen, share):\n"
+            "            first = part if first is None else first\n"
+            "            n = len(next(iter(part.values()), ()))\n"
+            "            if not n:\n"
+            "                continue\n"
+            "            if isinstance(sample, float):\n"
+            "                where = np.flatnonzero(rng.random(n) < chance)\n"
+            "                kept.append({name: take(column, where) for name, column in part.items()})\n"
+            "                continue\n"
+            "            # The rows with the `sample` smallest random keys: a reservoir as\n"
+            "            # uniform as Algorithm R, trimmed after every chunk\n"
+            "            keys = np.concatenate([keys, rng.random(n)])\n"
+            "            part = {name: join([column, part[name]]) for name, column in kept[0].items()} if kept else part\n"
+            "            if len(keys) > sample:\n"
+            "                where = np.sort(np.argpartition(keys, sample - 1)[:sample])\n"
+            "                keys = keys[where]\n"
+            "                part = {name: take(column, where) for name, column in part.items()}\n"
+            "            kept = [part]\n"
+            "        columns = {name: join([k[name] for k in kept]) for name in kept[0]} if kept else first\n"
+            "        if columns is None:\n"
+            "            return _wizuall_rt.read_csv(files, names)\n"
+            "        if isinstance(sample, float) or count == len(blocks) or len(keys) >= sample:\n"
+            "            return columns\n"
+            "        count *= 2   # the rows ran longer than the head suggested\n"
+            "\n");
+        // The native reader is built next to the compiler (runtime/); without
+        // it, lines without quotes are split only up to the last wanted field.
+        // Stream imports read through it when previewing a sample.
+        fprintf(out,
+            "def _wizuall_read_csv(path, names=None, sample=None):\n"
+            "    # Same rows as csv.DictReader: blank lines are skipped, missing fields\n"
+            "    # read as None and the last of duplicate headers wins. The rows of the\n"
+            "    # files a pattern matches are concatenated.\n"
+            "    files = _wizuall_files(path)\n"
+            "    if sample is not None:\n"
+            "        return _wizuall_read_csv_sample(files, names, sample)\n");
+        if (gzip_reader_emitted) {
+            fprintf(out,
+                "    if _wizuall_rt and any(file.endswith('.gz') for file in files):\n"
+                "        return _wizuall_read_gzip_csv(files, names)\n");
+        }
+        fprintf(out,
+            "    if _wizuall_rt:\n"
+            "        return _wizuall_rt.read_csv(files, names)\n"
+            "    import csv, itertools\n"
+            "    columns = None\n"
+            "    for file in files:\n"
+            "        with _wizuall_open(file) as f:\n"
+            "            header = next(csv.reader(f), [])\n"
+            "            where = {name: i for i, name in enumerate(header)}\n"
+            "            if names is None:\n"
+            "                names = list(where)\n"
+            "            if columns is None:\n"
+            "                columns = [[] for _ in names]\n"
+            "            picks = [where[name] for name in names]\n"
+            "            width = max(picks, default=-1) + 1\n"
+            "            appends = [(i, column.append) for i, column in zip(picks, columns)]\n"
+            "            for line in f:\n"
+            "                if '\"' in line:\n"
+            "                    # Quoted fields may hold commas or newlines: the csv module reads the rest\n"
+            "                    for row in csv.reader(itertools.chain([line], f)):\n"
+            "                        if row:\n"
+            "                            row += [None] * (width - len(row))\n"
+            "                            for i, append in appends:\n"
+            "                                append(row[i])\n"
+            "                    break\n"
+            "                row = line.rstrip('\\r\\n').split(',', width)\n"
+            "                if row == ['']:\n"
+            "                    continue\n"
+            "                row += [None] * (width - len(row))\n"
+            "                for i, append in appends:\n"
+            "                    append(row[i])\n"
+            "    return {name: _wizuall_column(column) for name, column in zip(names, columns)}\n\n"
+            "def _wizuall_sample_option():\n"
+            "    # `python3 output.py --sample 0.01` (a fraction) or `--sample 100000` (a\n"
+            "    # row count) previews every CSV import on a sample of its rows\n"
+            "    value = _wizuall_option('--sample')\n"
+            "    if value is None:\n"
+            "        return None\n"
+            "    try:\n"
+            "        sample = int(value) if value.isdigit() else float(value)\n"
+            "    except ValueError:\n"
+            "        sample = 0\n"
+            "    if not 0 < sample or isinstance(sample, float) and not sample <= 1:\n"
+            "        raise SystemExit('--sample takes a fraction in (0, 1] or a row count, not %%r' %% value)\n"
+            "    return None if sample == 1.0 and isinstance(sample, float) else sample\n\n");
+    }
+    if (gzip_reader_emitted && (csv_reader_emitted || stream_reader_emitted)) {
+        // The text of a .gz file is inflated a block at a time into the
+        // native reader, so it is never held whole
+        fprintf(out,
+            "def _wizuall_gzip_blocks(file, block_bytes=1 << 24):\n"
+            "    # The CSV text of a .gz file in blocks of about block_bytes of whole\n"
+            "    # records, each behind the header line. The next block is decompressed on\n"
+            "    # another thread (zlib drops the GIL) while the caller parses this one. A\n"
+            "    # block ends at a line end after an even number of quotes, so a quoted\n"
+            "    # field holding line breaks stays in one block.\n"
+            "    import gzip\n"
+            "    from concurrent.futures import ThreadPoolExecutor\n"
+            "    with gzip.open(file, 'rb') as f, ThreadPoolExecutor(1) as pool:\n"
+            "        header = f.readline()\n"
+            "        rest, odd = b'', 0\n"
+            "        pending = pool.submit(f.read, block_bytes)\n"
+            "        while True:\n"
+            "            data = pending.result()\n"
+            "            if not data:\n"
+            "                yield header + rest\n"
+            "                return\n"
+            "            pending = pool.submit(f.read, block_bytes)\n"
+            "            cut = data.rfind(b'\\n') + 1\n"
+            "            odd_at = (odd + data.count(b'\"', 0, cut)) & 1\n"
+            "            while cut and odd_at:\n"
+            "                line = data.rfind(b'\\n', 0, cut - 1) + 1\n"
+            "                odd_at ^= data.count(b'\"', line, cut) & 1\n"
+            "                cut = line\n"
+            "            if not cut:\n"
+            "                rest += data\n"
+            "                odd = (odd + data.count(b'\"')) & 1\n"
+            "                continue\n"
+            "            block = b''.join((header, rest, memoryview(data)[:cut]))\n"
+            "            rest, odd = data[cut:], data.count(b'\"', cut) & 1\n"
+            "            yield block\n"
+            "            del block\n\n"
+            "def _wizuall_gzip_size(file):\n"
+            "    # Length of the decompressed file as the gzip trailer gives it (of the\n"
+            "    # last member, modulo 2^32: a guess that can be short)\n"
+            "    import os, struct\n"
+            "    if os.path.getsize(file) < 18:\n"
+            "        return 0\n"
+            "    with open(file, 'rb') as f:\n"
+            "        f.seek(-4, 2)\n"
+            "        return struct.unpack('<I', f.read(4))[0]\n\n"
+            "def _wizuall_read_gzip_csv(files, names):\n"
+            "    # The native reader over .gz files a block at a time, so their text is\n"
+            "    # never held decompressed whole. Each column fills an array sized from\n"
+            "    # the rows per byte read so far; its pages past the last row are never\n"
+            "    # touched. A column with numbers in some blocks and text in others is\n"
+            "    # read again from the whole text, so that its cells keep their spelling.\n"
+            "    import os\n"
+            "    import numpy as np\n"
+            "    total = sum(_wizuall_gzip_size(file) if file.endswith('.gz') else os.path.getsize(file) for file in files)\n"
+            "    data, rows, seen, empty = {}, 0, 0, None\n"
+            "    for file in files:\n"
+            "        for block in _wizuall_gzip_blocks(file, 1 << 22) if file.endswith('.gz') else [file]:\n"
+            "            seen += len(block) if isinstance(block, bytes) else os.path.getsize(block)\n"
+            "            part = _wizuall_rt.read_csv(block, names)\n"
+            "            del block\n"
+            "            if names is None:\n"
+            "                names = list(part)   # every file has the columns of the first\n"
+            "            count = len(next(iter(part.values()), ()))\n"
+            "            if not count:\n"
+            "                empty = empty or part\n"
+            "                continue\n"
+            "            end = rows + count\n"
+            "            for name, values in part.items():\n"
+            "                old = data.get(name, [] if isinstance(values, list) else np.empty(0, values.dtype))\n"
+            "                if isinstance(old, list) != isinstance(values, list):\n"
+            "                    return _wizuall_rt.read_csv(files, names)\n"
+            "                if isinstance(values, list):\n"
+            "                    old.extend(values)\n"
+            "                elif np.result_type(old, values) != old.dtype or end > len(old):\n"
+            "                    grown = np.empty(max(end, int(end * max(total / seen, 1) * 1.1)), np.result_type(old, values))\n"
+            "                    grown[:rows] = old[:rows]\n"
+            "                    grown[rows:end] = values\n"
+            "                    old = grown\n"
+            "                else:\n"
+            "                    old[rows:end] = values\n"
+            "                data[name] = old\n"
+            "            rows = end\n"
+            "    if not rows:\n"
+            "        return empty\n"
+            "    return {name: values if isinstance(values, list) else values[:rows] for name, values in data.items()}\n\n");
+    }
+    if (stream_reader_emitted) {
+        // Each pass re-reads the file block by block; what a pass keeps per
+        // column is bounded by the bin and sample sizes, not by the row count
+        fprintf(out,
+            "def _wizuall_stream_csv(path, plan, block_bytes=1 << 24):\n"
+            "    # Aggregates of the CSV columns in `plan`, computed in passes over blocks of\n"
+            "    # about block_bytes so memory use does not grow with the file. plan maps a\n"
+            "    # column to what the program reads: avg, running_sum, hist (bin counts) and\n"
+            "    # box (boxplot statistics). The values match the in-memory builtins;\n"
+            "    # running sums are spilled to a temporary file and memory-mapped.\n"
+            "    import math, os, tempfile\n"
+            "    from types import SimpleNamespace\n"
+            "    import numpy as np\n"
+            "    names = list(plan)\n"
+            "    files = _wizuall_files(path)\n"
+            "    sampling = _wizuall_sample_option()\n"
+            "\n"
+            "    def numeric(name, column):\n"
+            "        if isinstance(column, np.ndarray):\n"
+            "            return column\n"
+            "        if column:\n"
+            "            raise ValueError('%%s: column %%r is not numeric in every row; import it without stream' %% (path, name))\n"
+            "        return np.empty(0, np.int64)\n"
+            "\n"
+            "    def file_blocks(file, wanted):\n"
+            "        # Native blocks are byte ranges cut at line ends, so quoted fields\n"
+            "        # must not span lines; the csv module handles anything, 65536 rows at a time\n"
+            "        if _wizuall_rt and file.endswith('.gz'):\n"
+            "            for block in _wizuall_gzip_blocks(file, block_bytes):\n"
+            "                part = _wizuall_rt.read_csv(block, wanted)\n"
+            "                del block\n"
+            "                yield [numeric(name, part[name]) for name in wanted]\n"
+            "            return\n"
+            "        if _wizuall_rt:\n"
+            "            size = os.path.getsize(file)\n"
+            "            for start in range(0, size, block_bytes):\n"
+            "                part = _wizuall_rt.read_csv(file, wanted, start=start, stop=start + block_bytes)\n"
+            "                yield [numeric(name, part[name]) for name in wanted]\n"
+            "            return\n"
+            "        import csv, itertools\n"
+            "        with _wizuall_open(file, newline='') as f:\n"
+            "            reader = csv.reader(f)\n"
+            "            where = {name: i for i, name in enumerate(next(reader, []))}\n"
+            "            picks = [where[name] for name in wanted]\n"
+            "            while True:\n"
+            "                rows = list(itertools.islice(reader, 1 << 16))\n"
+            "                if not rows:\n"
+            "                    break\n"
+            "                rows = [row for row in rows if row]\n"
+            "                yield [numeric(name, _wizuall_column([row[i] if i < len(row) else None for row in rows]))\n"
+            "                       for name, i in zip(wanted, picks)]\n"
+            "\n"
+            "    def blocks(wanted):\n"
+            "        # The files a pattern matches, one after the other; a preview\n"
+            "        # (--sample) is one block, the same sample on every pass\n"
+            "        if sampling:\n"
+            "            part = _wizuall_read_csv(path, wanted, sampling)\n"
+            "            yield [numeric(name, part[name]) for name in wanted]\n"
+            "            return\n"
+            "        for file in files:\n"
+            "            yield from file_blocks(file, wanted)\n"
+            "\n"
+            "    stats = {name: SimpleNamespace() for name in names}\n"
+            "    count = dict.fromkeys(names, 0)\n"
+            "    sums = {name: [] for name in names}\n"
+            "    low, high, floats = {}, {}, set()\n"
+            "    for part in blocks(names):\n"
+            "        for name, x in zip(names, part):\n"
+            "            if len(x):\n"
+            "                count[name] += len(x)\n"
+            "                sums[name].append(float(x.sum(dtype=np.float64)))\n"
+            "                lo, hi = _wizuall_minmax(x)\n"
+            "                low[name] = min(low.get(name, lo), lo)\n"
+            "                high[name] = max(high.get(name, hi), hi)\n"
+            "                if x.dtype.kind == 'f':\n"
+            "                    floats.add(name)\n"
+            "    dtypes = {name: np.float64 if name in floats else np.int64 for name in names}\n"
+            "    for name in names:\n"
+            "        if plan[name].get('avg'):\n"
+            "            stats[name].avg = math.fsum(sums[name]) / count[name] if count[name] else math.nan\n"
+            "\n"
+            "    # The second pass writes running sums and counts histogram bins over the\n"
+            "    # range found above. Boxplot quartiles are order statistics: every pass\n"
+            "    # narrows the interval [lo, hi) holding a wanted rank to one of 4096\n"
+            "    # sub-intervals, until it holds few enough values to keep and sort.\n"
+            "    spills, hists, targets = {}, {}, []\n"
+            "    for name in names:\n"
+            "        full = np.array([low[name], high[name]], dtypes[name]) if count[name] else np.empty(0)\n"
+            "        hists[name] = {bins: [np.histogram_bin_edges(full, bins), 0] for bins in plan[name].get('hist', ())}\n"
+            "        if plan[name].get('running_sum'):\n"
+            "            spills[name] = [tempfile.TemporaryFile(), dtypes[name](0)]\n"
+            "        if plan[name].get('box') and count[name]:\n"
+            "            n = count[name]\n"
+            "            ranks = set()\n"
+            "            for q in (0.25, 0.5, 0.75):\n"
+            "                k = math.floor((n - 1) * q)\n"
+            "                ranks.update((k, min(k + 1, n - 1)))\n"
+            "            start, stop = float(low[name]), np.nextafter(float(high[name]), np.inf)\n"
+            "            for rank in sorted(ranks):\n"
+            "                targets.append({'name': name, 'rank': rank, 'lo': start, 'hi': stop, 'below': 0, 'inside': n})\n"
+            "    order = {}\n"
+            "    first = True\n"
+            "    while first or any('value' not in t for t in targets):\n"
+            "        pending = [t for t in targets if 'value' not in t]\n"
+            "        for t in pending:\n"
+            "            t.update(kept=[], vmin=None, vmax=None)\n"
+            "            t['keep'] = t['inside'] <= 1 << 18 or np.nextafter(t['lo'], np.inf) >= t['hi']\n"
+            "            if not t['keep']:\n"
+            "                t['edges'] = np.linspace(t['lo'], t['hi'], 4097)\n"
+            "                t['counts'] = np.zeros(4096, np.int64)\n"
+            "        wanted = [name for name in names\n"
+            "                  if any(t['name'] == name for t in pending) or first and (name in spills or hists[name])]\n"
+            "        for part in blocks(wanted):\n"
+            "            for name, x in zip(wanted, part):\n"
+            "                if not len(x):\n"
+            "                    continue\n"
+            "                if first and name in spills:\n"
+            "                    spill = spills[name]\n"
+            "                    running = x.astype(dtypes[name])\n"
+            "                    running[0] += spill[1]\n"
+            "                    np.cumsum(running, out=running)\n"
+            "                    spill[1] = running[-1]\n"
+            "                    running.tofile(spill[0])\n"
+            "                    del running\n"
+            "                if first:\n"
+            "                    for bin_counts in hists[name].values():\n"
+            "                        bin_counts[1] = bin_counts[1] + np.histogram(x, bin_counts[0])[0]\n"
+            "                xf = None\n"
+            "                for t in pending:\n"
+            "                    if t['name'] != name:\n"
+            "                        continue\n"
+            "                    if xf is None:\n"
+            "                        xf = x.astype(np.float64, copy=False)\n"
+            "                    inside = x[(xf >= t['lo']) & (xf < t['hi'])]\n"
+            "                    if not len(inside):\n"
+            "                        continue\n"
+            "                    if t['keep']:\n"
+            "                        t['kept'].append(inside.astype(dtypes[name]))\n"
+            "                        continue\n"
+            "                    where = np.searchsorted(t['edges'], inside.astype(np.float64), 'right') - 1\n"
+            "                    t['counts'] += np.bincount(where, minlength=4096)\n"
+            "                    t['vmin'] = inside.min() if t['vmin'] is None else min(t['vmin'], inside.min())\n"
+            "                    t['vmax'] = inside.max() if t['vmax'] is None else max(t['vmax'], inside.max())\n"
+            "        for t in pending:\n"
+            "            if t['keep']:\n"
+            "                t['value'] = np.sort(np.concatenate(t['kept']))[t['rank'] - t['below']]\n"
+            "            elif t['vmin'] == t['vmax']:\n"
+            "                t['value'] = t['vmin']\n"
+            "            else:\n"
+            "                cumulative = np.cumsum(t['counts'])\n"
+            "                j = int(np.searchsorted(cumulative, t['rank'] - t['below'], 'right'))\n"
+            "                t['below'] += int(cumulative[j - 1]) if j else 0\n"
+            "                t['inside'] = int(t['counts'][j])\n"
+            "                t['lo'], t['hi'] = t['edges'][j], t['edges'][j + 1]\n"
+            "            order[t['name'], t['rank']] = t.get('value')\n"
+            "        first = False\n"
+            "\n"
+            "    for name, (f, _) in spills.items():\n"
+            "        f.flush()\n"
+            "        if count[name]:\n"
+            "            stats[name].running_sum = np.memmap(f, dtypes[name], 'r', shape=(count[name],))\n"
+            "        else:\n"
+            "            stats[name].running_sum = np.empty(0, dtypes[name])\n"
+            "        f.close()\n"
+            "    for name, binnings in hists.items():\n"
+            "        if binnings:\n"
+            "            stats[name].hist = {bins: {'x': edges[:-1], 'bins': edges, 'weights': counts}\n"
+            "                                for bins, (edges, counts) in binnings.items()}\n"
+            "\n"
+            "    # Whiskers reach the furthest values within 1.5 IQR of the box, as in\n"
+            "    # matplotlib; boxplot() gets [whislo, q1, med, q3, whishi], which it\n"
+            "    # draws as exactly that box (outliers are not drawn)\n"
+            "    quartiles = {}\n"
+            "    for name in names:\n"
+            "        if not plan[name].get('box'):\n"
+            "            continue\n"
+            "        n = count[name]\n"
+            "        if not n:\n"
+            "            stats[name].box, stats[name].box_notch = np.empty(0), (None, None)\n"
+            "            continue\n"
+            "        values = []\n"
+            "        for q in (0.25, 0.5, 0.75):\n"
+            "            position = (n - 1) * q\n"
+            "            k = math.floor(position)\n"
+            "            a, b = float(order[name, k]), float(order[name, min(k + 1, n - 1)])\n"
+            "            gamma = position - k\n"
+            "            # numpy's linear interpolation, including its rounding\n"
+            "            values.append(b - (b - a) * (1 - gamma) if gamma >= 0.5 else a + (b - a) * gamma)\n"
+            "        q1, med, q3 = values\n"
+            "        iqr = q3 - q1\n"
+            "        quartiles[name] = [q1 - 1.5 * iqr, q3 + 1.5 * iqr, None, None]\n"
+            "        stats[name].box_notch = (med - 1.57 * iqr / np.sqrt(n), med + 1.57 * iqr / np.sqrt(n))\n"
+            "        stats[name].box = values\n"
+            "    if quartiles:\n"
+            "        wanted = list(quartiles)\n"
+            "        for part in blocks(wanted):\n"
+            "            for name, x in zip(wanted, part):\n"
+            "                bounds = quartiles[name]\n"
+            "                below = x[x <= bounds[1]]\n"
+            "                above = x[x >= bounds[0]]\n"
+            "                if len(below):\n"
+            "                    bounds[3] = below.max() if bounds[3] is None else max(bounds[3], below.max())\n"
+            "                if len(above):\n"
+            "                    bounds[2] = above.min() if bounds[2] is None else min(bounds[2], above.min())\n"
+            "        for name, (_, _, lowest, highest) in quartiles.items():\n"
+            "            q1, med, q3 = stats[name].box\n"
+            "            whislo = q1 if lowest is None or lowest > q1 else lowest\n"
+            "            whishi = q3 if highest is None or highest < q3 else highest\n"
+            "            stats[name].box = np.array([whislo, q1, med, q3, whishi], np.float64)\n"
+            "    return stats\n\n");
+    }
+    if (json_reader_emitted) {
+        // The native reader (runtime/) parses the file in one pass and arrays
+        // of numbers straight into arrays. Without it, top-level values are
+        // decoded one at a time and unreferenced ones dropped at once, so the
+        // whole document is never held as objects.
+        fprintf(out,
+            "def _wizuall_read_json(path, names=None):\n"
+            "    if _wizuall_rt:\n"
+            "        return _wizuall_rt.read_json(path, names)\n"
+            "    import json\n"
+            "    import numpy as np\n"
+            "    with _wizuall_open(path) as f:\n"
+            "        text = f.read()\n"
+            "    decode = json.JSONDecoder().raw_decode\n"
+            "    skip = json.decoder.WHITESPACE.match\n"
+            "    wanted = None if names is None else set(names)\n"
+            "    values = {}\n"
+            "    pos = skip(text, 0).end()\n"
+            "    if text[pos:pos + 1] != '{':\n"
+            "        raise ValueError(path + ': expected a JSON object')\n"
+            "    pos = skip(text, pos + 1).end()\n"
+            "    while text[pos:pos + 1] != '}':\n"
+            "        key, pos = decode(text, pos)\n"
+            "        pos = skip(text, pos).end()\n"
+            "        if text[pos:pos + 1] != ':':\n"
+            "            raise ValueError(path + ': expected \\':\\' at offset %%d' %% pos)\n"
+            "        value, pos = decode(text, skip(text, pos + 1).end())\n"
+            "        if wanted is None or key in wanted:\n"
+            "            # Arrays of numbers become int64 or float64 arrays, as the native reader returns them\n"
+            "            if isinstance(value, list) and value and all(type(x) in (int, float, bool) for x in value):\n"
+            "                dtype = np.float64 if float in map(type, value) else np.int64\n"
+            "                try:\n"
+            "                    value = np.array(value, dtype)\n"
+            "                except OverflowError:\n"
+            "                    value = np.array(value, np.float64)\n"
+            "            values[key] = value\n"
+            "        del value\n"
+            "        pos = skip(text, pos).end()\n"
+            "        if text[pos:pos + 1] == ',':\n"
+            "            pos = skip(text, pos + 1).end()\n"
+            "        elif text[pos:pos + 1] != '}':\n"
+            "            raise ValueError(path + ': expected \\',\\' or \\'}\\' at offset %%d' %% pos)\n"
+            "    if skip(text, pos + 1).end() != len(text):\n"
+            "        raise ValueError(path + ': extra data at offset %%d' %% skip(text, pos + 1).end())\n"
+            "    return values if names is None else {name: values[name] for name in names}\n\n");
+    }
+    if (sqlite_reader_emitted) {
+        // Only the referenced columns and rows are selected. The native
+        // reader steps through the rows straight into typed arrays; without
+        // it the sqlite3 module fetches them in batches.
+        fprintf(out,
+            "def _wizuall_read_sqlite(path, table, names=None, start=0, stop=None):\n"
+            "    # Columns of `table` in rows [start, stop), in rowid order: INTEGER columns\n"
+            "    # become int64 arrays, INTEGER/REAL ones float64, others lists\n"
+            "    if _wizuall_rt:\n"
+            "        return _wizuall_rt.read_sqlite(path, table, names, start, -1 if stop is None else stop)\n"
+            "    import os, sqlite3, urllib.parse\n"
+            "    os.stat(path)  # a missing file raises OSError, not 'unable to open'\n"
+            "    quote = lambda name: '\"' + name.replace('\"', '\"\"') + '\"'\n"
+            "    db = sqlite3.connect('file:' + urllib.parse.quote(path) + '?mode=ro', uri=True)\n"
+            "    query = 'SELECT %%s FROM %%s%%s LIMIT ? OFFSET ?'\n"
+            "    window = (-1 if stop is None else max(stop - start, 0), start)\n"
+            "    selected = '*' if names is None else ', '.join(map(quote, names))\n"
+            "    try:\n"
+            "        try:\n"
+            "            cursor = db.execute(query %% (selected, quote(table), ' ORDER BY rowid'), window)\n"
+            "        except sqlite3.OperationalError as e:\n"
+            "            if str(e) != 'no such column: rowid':\n"
+            "                raise\n"
+            "            # A WITHOUT ROWID table, read in the order SQLite returns\n"
+            "            cursor = db.execute(query %% (selected, quote(table), ''), window)\n"
+            "    except sqlite3.OperationalError as e:\n"
+            "        if str(e).startswith('no such'):\n"
+            "            raise KeyError('%%s: %%s' %% (path, e)) from None\n"
+            "        raise\n"
+            "    if names is None:\n"
+            "        names = [d[0] for d in cursor.description]\n"
+            "    columns = [[] for _ in names]\n"
+            "    try:\n"
+            "        for rows in iter(lambda: cursor.fetchmany(1 << 16), []):\n"
+            "            for column, cells in zip(columns, zip(*rows)):\n"
+            "                column.extend(cells)\n"
+            "    finally:\n"
+            "        db.close()\n"
+            "    import numpy as np\n"
+            "    values = {}\n"
+            "    for name, column in zip(names, columns):\n"
+            "        kinds = set(map(type, column))\n"
+            "        if column and kinds <= {int, float}:\n"
+            "            column = np.array(column, np.int64 if kinds == {int} else np.float64)\n"
+            "        values[name] = column\n"
+            "    return values\n\n");
+    }
+    if (csv_reader_emitted || json_reader_emitted) {
+        // One file per column, so a later program reading other columns of
+        // the same file only parses those
+        fprintf(out,
+            "def _wizuall_load(path, names, read%s):\n"
+            "    # Columns of `path` (all of them for names=None) from the cache in\n"
+            "    # $WIZUALL_CACHE_DIR (default .wizuall_cache, empty to disable). Entries\n"
+            "    # are keyed by path, size and mtime; numeric arrays are memory-mapped.\n",
+            csv_reader_emitted ? ", sample=None" : "");
+        if (csv_reader_emitted) {
+            // The command line's --sample overrides an import's own sample
+            fprintf(out,
+                "    # Samples of CSV files are previews and never cached.\n"
+                "    if read is _wizuall_read_csv and (_wizuall_sample_option() or sample):\n"
+                "        return read(path, names, _wizuall_sample_option() or sample)\n");
+        }
+        fprintf(out,
+            "    import hashlib, json, os, pickle, shutil\n"
+            "    root = os.environ.get('WIZUALL_CACHE_DIR', '.wizuall_cache')\n"
+            "    if not root:\n"
+            "        return read(path, names)\n"
+            "    import numpy as np\n"
+            "    source = os.path.abspath(path)\n"
+            "    files = _wizuall_files(path)\n"
+            "    if files == [path]:\n"
+            "        st = os.stat(path)\n"
+            "        key = {'source': source, 'size': st.st_size, 'mtime_ns': st.st_mtime_ns}\n"
+            "    else:\n"
+            "        # A pattern's entry is stale once a file is added, removed or changed\n"
+            "        key = {'source': source, 'files': [[file, st.st_size, st.st_mtime_ns]\n"
+            "                                           for file in files for st in [os.stat(file)]]}\n"
+            "    folder = os.path.join(root, hashlib.sha1(source.encode()).hexdigest()[:16])\n"
+            "    meta_path = os.path.join(folder, 'meta.json')\n"
+            "    try:\n"
+            "        with open(meta_path, 'r') as f:\n"
+            "            meta = json.load(f)\n"
+            "    except (OSError, ValueError):\n"
+            "        meta = None\n"
+            "    if not meta or meta.get('key') != key:\n"
+            "        # Missing or stale: the file changed since it was cached\n"
+            "        shutil.rmtree(folder, ignore_errors=True)\n"
+            "        meta = {'key': key, 'columns': {}, 'complete': False}\n"
+            "    stored = meta['columns']\n"
+            "    if names is None and meta['complete']:\n"
+            "        names = list(stored)\n"
+            "    missing = None if names is None else [name for name in names if name not in stored]\n"
+            "    fresh = {}\n"
+            "    if missing is None or missing:\n"
+            "        fresh = read(path, missing)\n"
+            "        try:\n"
+            "            os.makedirs(folder, exist_ok=True)\n"
+            "            for name, value in fresh.items():\n"
+            "                if name in stored:\n"
+            "                    continue\n"
+            "                array = isinstance(value, np.ndarray) and value.dtype.kind in 'iuf'\n"
+            "                file = '%%d.%%s' %% (len(stored), 'npy' if array else 'pkl')\n"
+            "                with open(os.path.join(folder, file + '.tmp'), 'wb') as f:\n"
+            "                    if array:\n"
+            "                        np.save(f, value)\n"
+            "                    else:\n"
+            "                        pickle.dump(value, f, pickle.HIGHEST_PROTOCOL)\n"
+            "                os.replace(os.path.join(folder, file + '.tmp'), os.path.join(folder, file))\n"
+            "                stored[name] = file\n"
+            "            meta['complete'] = meta['complete'] or missing is None\n"
+            "            with open(meta_path + '.tmp', 'w') as f:\n"
+            "                json.dump(meta, f)\n"
+            "            os.replace(meta_path + '.tmp', meta_path)\n"
+            "        except OSError:\n"
+            "            pass  # an unwritable cache only costs the next run a parse\n"
+            "    result = {}\n"
+            "    for name in (fresh if names is None else names):\n"
+            "        if name in fresh:\n"
+            "            result[name] = fresh[name]\n"
+            "        elif stored[name].endswith('.npy'):\n"
+            "            result[name] = np.load(os.path.join(folder, stored[name]), mmap_mode='c').view(np.ndarray)\n"
+            "        else:\n"
+            "            with open(os.path.join(folder, stored[name]), 'rb') as f:\n"
+            "                result[name] = pickle.load(f)\n"
+            "    return result\n\n");
     }
 }
 
@@ -128,27 +1596,68 @@ void emit_labels(ASTList* args, FILE* out, int indent) {
 
 // Helper to emit Python for WizuAll built-in functions
 void generate_builtin_func(const char* func, ASTList* args, FILE* out, int indent) {
+    if (args && !args->next && is_stream_column(args->node)
+        && (streq(func, "avg") || streq(func, "runningSum"))) {
+        // Computed while streaming the file
+        fprintf(out, "%s.%s", args->node->id_name, streq(func, "avg") ? "avg" : "running_sum");
+        return;
+    }
+    if (args && !args->next && args->node->type == NODE_ID && live_source(args->node->id_name) >= 0
+        && (streq(func, "avg") || streq(func, "runningSum"))) {
+        // Carried forward by the live import as rows are appended
+        fprintf(out, "_wizuall_live_%d.%s('%s')", live_source(args->node->id_name),
+                streq(func, "avg") ? "avg" : "running_sum", args->node->id_name);
+        return;
+    }
+    TypeInfo t = args ? infer_expr_type(args->node) : type_unknown();
     if (streq(func, "avg")) {
+        if (t.kind == TYPE_VECTOR) {
+            // Summed by a SIMD kernel instead of element by element
+            fprintf(out, "_wizuall_avg(");
+            generate_expr(args->node, out, indent);
+            fprintf(out, ")");
+            return;
+        }
         fprintf(out, "(sum(");
         generate_expr(args->node, out, indent);
         fprintf(out, ") / len(");
         generate_expr(args->node, out, indent);
         fprintf(out, "))");
     } else if (streq(func, "sort")) {
-        fprintf(out, "sorted(");
+        fprintf(out, t.kind == TYPE_VECTOR ? "_wizuall_sorted(" : t.kind == TYPE_UNKNOWN ? "_wizuall_sort(" : "sorted(");
         generate_expr(args->node, out, indent);
         fprintf(out, ")");
     } else if (streq(func, "reverse")) {
-        fprintf(out, "list(reversed(");
+        if (t.kind == TYPE_VECTOR) {
+            fprintf(out, "_wizuall_reversed(");
+            generate_expr(args->node, out, indent);
+            fprintf(out, ")");
+            return;
+        }
+        fprintf(out, t.kind == TYPE_UNKNOWN ? "_wizuall_reverse(" : "list(reversed(");
         generate_expr(args->node, out, indent);
-        fprintf(out, "))");
+        fprintf(out, t.kind == TYPE_UNKNOWN ? ")" : "))");
+    } else if (streq(func, "concat")) {
+        fprintf(out, "_wizuall_concat(");
+        for (ASTList* arg = args; arg; arg = arg->next) {
+            generate_expr(arg->node, out, indent);
+            if (arg->next) fprintf(out, ", ");
+        }
+        fprintf(out, ")");
     } else if (streq(func, "slice")) {
         ASTList* a1 = args;
         ASTList* a2 = a1 ? a1->next : NULL;
         ASTList* a3 = a2 ? a2->next : NULL;
-        if (a1 && a2 && a3) {
+        const RowWindow* rows = a1 && a1->node->type == NODE_ID ? column_row_window(a1->node->id_name) : NULL;
+        if (a1 && a2 && a3 && rows) {
+            // Only the rows plan_pushdown found were read; bounds are literals
+            fprintf(out, "%s[%ld:%ld]", a1->node->id_name,
+                    (long)a2->node->num_value - rows->start, (long)a3->node->num_value - rows->start);
+        } else if (a1 && a2 && a3) {
+            bool compound = a1->node->type == NODE_BINARY_OP;
+            if (compound) fprintf(out, "(");
             generate_expr(a1->node, out, indent);
-            fprintf(out, "[");
+            fprintf(out, compound ? ")[" : "[");
             generate_expr(a2->node, out, indent);
             fprintf(out, ":");
             generate_expr(a3->node, out, indent);
@@ -156,12 +1665,20 @@ void generate_builtin_func(const char* func, ASTList* args, FILE* out, int inden
         } else {
             fprintf(out, "# ERROR: slice expects 3 arguments");
         }
+    } else if (streq(func, "transpose") && t.kind == TYPE_MATRIX && t.columns >= 0) {
+        fprintf(out, "np.transpose(");
+        generate_expr(args->node, out, indent);
+        fprintf(out, ")");
     } else if (streq(func, "transpose")) {
         fprintf(out, "list(map(list, zip(*");
         generate_expr(args->node, out, indent);
         fprintf(out, ")))" );
     } else if (streq(func, "runningSum")) {
-        fprintf(out, "np.cumsum(");
+        fprintf(out, "_wizuall_running_sum(");
+        generate_expr(args->node, out, indent);
+        fprintf(out, ")");
+    } else if (streq(func, "pairwiseCompare") && t.kind == TYPE_VECTOR) {
+        fprintf(out, "_wizuall_diff(");
         generate_expr(args->node, out, indent);
         fprintf(out, ")");
     } else if (streq(func, "pairwiseCompare")) {
@@ -349,17 +1866,27 @@ void generate_viz_call(const char* func, ASTList* args, FILE* out, int indent) {
         // Histogram visualization with extended parameters
         fprintf(out, "plt.hist(");
         
-        // Generate positional arguments first
-        generate_pos_args(pos_count);
+        // Generate positional arguments first; a streamed column passes its
+        // bin edges and counts (x, bins and weights) instead of its values
+        bool streamed = pos_count == 1 && is_stream_column(pos_args[0]);
+        if (streamed) {
+            int bins = 10;
+            for (int i = 0; i < kw_count; ++i)
+                if (streq(kw_keys[i]->id_name, "bins")) bins = (int)kw_vals[i]->num_value;
+            fprintf(out, "**%s.hist[%d]", pos_args[0]->id_name, bins);
+        } else {
+            generate_pos_args(pos_count);
+        }
         
         // Add keyword arguments
-        bool has_bins = false, has_color = false, has_edgecolor = false, has_density = false;
+        bool has_bins = streamed, has_color = false, has_edgecolor = false, has_density = false;
         
         bool first_kw = true;
         for (int i = 0; i < kw_count; ++i) {
             const char* key = kw_keys[i]->id_name;
             if (streq(key, "title") || streq(key, "xlabel") || streq(key, "ylabel") || 
                 streq(key, "grid")) continue;
+            if (streamed && streq(key, "bins")) continue;
             
             if (streq(key, "bins")) has_bins = true;
             if (streq(key, "color")) has_color = true;
@@ -786,6 +2313,10 @@ void generate_viz_call(const char* func, ASTList* args, FILE* out, int indent) {
             if (i > 0) fprintf(out, ", ");
             generate_expr(pos_args[i], out, indent);
         }
+        // A streamed column passes the five values matplotlib draws as its box
+        // and whiskers, plus the notch of the whole column
+        bool streamed = pos_count == 1 && is_stream_column(pos_args[0]);
+        if (streamed) fprintf(out, ".box, conf_intervals=[%s.box_notch]", pos_args[0]->id_name);
         // Only add a comma if there is at least one keyword argument to emit
         bool has_boxplot_kwarg = false;
         bool has_notch = false, has_vert = false, has_patch_artist = false, has_tick_labels = false;
@@ -995,6 +2526,18 @@ void generate_viz_call(const char* func, ASTList* args, FILE* out, int indent) {
     }
 }
 
+// Writes a vector literal's elements as a Python list; `rows` writes nested
+// literals as plain lists too, the rows of a 2-D array
+static void generate_elements(ASTNode* literal, bool rows, FILE* out, int indent) {
+    fprintf(out, "[");
+    for (ASTList* e = literal->vector_literal.elements; e; e = e->next) {
+        if (rows && e->node->type == NODE_VECTOR_LITERAL) generate_elements(e->node, false, out, indent);
+        else generate_expr(e->node, out, indent);
+        if (e->next) fprintf(out, ", ");
+    }
+    fprintf(out, "]");
+}
+
 void generate_expr(ASTNode* node, FILE* out, int indent) {
     if (!node) return;
     switch (node->type) {
@@ -1007,18 +2550,34 @@ void generate_expr(ASTNode* node, FILE* out, int indent) {
         case NODE_STRING:
             fprintf(out, "%s", node->id_name); // Already quoted in lexer
             break;
-        case NODE_VECTOR_LITERAL: {
-            fprintf(out, "[");
-            ASTList* e = node->vector_literal.elements;
-            while (e) {
-                generate_expr(e->node, out, indent);
-                if (e->next) fprintf(out, ", ");
-                e = e->next;
+        case NODE_VECTOR_LITERAL:
+            switch (literal_form(node)) {
+                case LITERAL_ARRAY:
+                    fprintf(out, "np.asarray(");
+                    generate_elements(node, true, out, indent);
+                    fprintf(out, ")");
+                    break;
+                case LITERAL_DYNAMIC:
+                    fprintf(out, "_wizuall_vector(");
+                    generate_elements(node, false, out, indent);
+                    fprintf(out, ")");
+                    break;
+                case LITERAL_LIST:
+                    generate_elements(node, false, out, indent);
+                    break;
             }
-            fprintf(out, "]");
             break;
-        }
         case NODE_BINARY_OP:
+            if (parallel_arith(node)) {
+                BinaryOpType op = node->binary_op.op;
+                const char* symbol = op == OP_PLUS ? "+" : op == OP_MINUS ? "-" : op == OP_TIMES ? "*" : "/";
+                fprintf(out, "_wizuall_arith('%s', ", symbol);
+                generate_expr(node->binary_op.left, out, indent);
+                fprintf(out, ", ");
+                generate_expr(node->binary_op.right, out, indent);
+                fprintf(out, ")");
+                break;
+            }
             generate_expr(node->binary_op.left, out, indent);
             switch (node->binary_op.op) {
                 case OP_PLUS: fprintf(out, " + "); break;
@@ -1034,12 +2593,15 @@ void generate_expr(ASTNode* node, FILE* out, int indent) {
             break;
         case NODE_FUNCTION_CALL: {
             const char* func = node->function_call.func_name;
-            if (streq(func, "avg") || streq(func, "sort") || streq(func, "reverse") || streq(func, "slice") || streq(func, "transpose") || streq(func, "runningSum") || streq(func, "pairwiseCompare") || streq(func, "paretoSet")) {
+            if (lookup_builtin(func)) {
                 generate_builtin_func(func, node->function_call.args, out, indent);
             } else {
                 fprintf(out, "%s(", func);
                 for (ASTList* arg = node->function_call.args; arg; arg = arg->next) {
+                    bool shown = streq(func, "print") && printed_as_list(arg->node);
+                    if (shown) fprintf(out, "_wizuall_shown(");
                     generate_expr(arg->node, out, indent);
+                    if (shown) fprintf(out, ")");
                     if (arg->next) fprintf(out, ", ");
                 }
                 fprintf(out, ")");
@@ -1051,25 +2613,921 @@ void generate_expr(ASTNode* node, FILE* out, int indent) {
     }
 }
 
+// A list of strings no other name can reach may be extended or repeated in place
+static bool updatable_in_place(const char* name) {
+    return lookup_var_type(name).kind == TYPE_STRING_VECTOR && var_is_unaliased(name);
+}
+
+// `x = concat(x, v)`: the appended operand, else NULL
+static ASTNode* appended_operand(ASTNode* assign) {
+    ASTNode* e = assign->assignment.expr;
+    if (!e || e->type != NODE_FUNCTION_CALL || !streq(e->function_call.func_name, "concat")) return NULL;
+    ASTList* args = e->function_call.args;
+    if (!args || args->node->type != NODE_ID || !streq(args->node->id_name, assign->assignment.var_name)) return NULL;
+    return args->next && !args->next->next ? args->next->node : NULL;
+}
+
+// `x = x + v` or `x = concat(x, v)` (v a list) and `x = x * n` / `x = n * x`
+// (n an int) on an unaliased list of strings become `x += v` / `x *= n`, which
+// grow the list in place instead of copying it on every update. Returns the
+// operator and the operand.
+static const char* in_place_operator(ASTNode* assign, ASTNode** operand) {
+    const char* x = assign->assignment.var_name;
+    ASTNode* e = assign->assignment.expr;
+    if (!updatable_in_place(x)) return NULL;
+    ASTNode* appended = appended_operand(assign);
+    if (appended && infer_expr_type(appended).kind == TYPE_STRING_VECTOR) {
+        *operand = appended;
+        return "+=";
+    }
+    if (!e || e->type != NODE_BINARY_OP) return NULL;
+    ASTNode* l = e->binary_op.left;
+    ASTNode* r = e->binary_op.right;
+    bool left_self = l->type == NODE_ID && streq(l->id_name, x);
+    bool right_self = r->type == NODE_ID && streq(r->id_name, x);
+    if (e->binary_op.op == OP_PLUS && left_self && infer_expr_type(r).kind == TYPE_STRING_VECTOR) {
+        *operand = r;
+        return "+=";
+    }
+    if (e->binary_op.op == OP_TIMES && (left_self || right_self)) {
+        TypeInfo n = infer_expr_type(left_self ? r : l);
+        if (n.kind != TYPE_NUMBER || n.dtype != DTYPE_INT) return NULL;
+        *operand = left_self ? r : l;
+        return "*=";
+    }
+    return NULL;
+}
+
+// `x = x op y` (or `x = y op x` for + and *) on an unaliased numeric vector,
+// op one of + - * /: the NumPy ufunc _wizuall_update writes the result over x
+// with, and the operand y. Int vectors are only updated from int operands and
+// never by /, so the result keeps x's dtype; _wizuall_update checks the
+// values again at run time.
+static const char* array_update(ASTNode* assign, ASTNode** operand) {
+    const char* x = assign->assignment.var_name;
+    ASTNode* e = assign->assignment.expr;
+    TypeInfo t = lookup_var_type(x);
+    if (t.kind != TYPE_VECTOR || t.dtype == DTYPE_NONE || !var_is_unaliased(x)) return NULL;
+    if (!e || e->type != NODE_BINARY_OP) return NULL;
+    ASTNode* l = e->binary_op.left;
+    ASTNode* r = e->binary_op.right;
+    bool left_self = l->type == NODE_ID && streq(l->id_name, x);
+    bool right_self = r->type == NODE_ID && streq(r->id_name, x);
+    const char* ufunc;
+    switch (e->binary_op.op) {
+        case OP_PLUS: ufunc = "np.add"; break;
+        case OP_TIMES: ufunc = "np.multiply"; break;
+        case OP_MINUS: ufunc = "np.subtract"; right_self = false; break;
+        case OP_DIVIDE: ufunc = "np.true_divide"; right_self = false; break;
+        default: return NULL;
+    }
+    if (left_self == right_self) return NULL;
+    ASTNode* other = left_self ? r : l;
+    TypeInfo o = infer_expr_type(other);
+    if ((o.kind != TYPE_NUMBER && o.kind != TYPE_VECTOR) || o.dtype == DTYPE_NONE) return NULL;
+    if (t.dtype == DTYPE_INT && (o.dtype != DTYPE_INT || e->binary_op.op == OP_DIVIDE)) return NULL;
+    *operand = other;
+    return ufunc;
+}
+
+// Emits a for loop matched by lower_counted_loops as native range() iteration.
+// The loop variable ends up one step past the last value, or at the start
+// value if the loop never ran, exactly like the while-loop lowering.
+static int range_counter = 0;
+
+void generate_range_loop(ASTNode* node, FILE* out, int indent) {
+    const char* var = node->for_loop.init->assignment.var_name;
+    long start = node->for_loop.range_start;
+    long step = node->for_loop.range_step;
+    ASTNode* bound = node->for_loop.range_bound;
+    char range_name[32] = "";
+
+    print_indent(out, indent);
+    if (node->for_loop.keep_final) {
+        snprintf(range_name, sizeof(range_name), "_range_%d", ++range_counter);
+        fprintf(out, "%s = ", range_name);
+    } else {
+        fprintf(out, "for %s in ", var);
+    }
+    fprintf(out, "range(%ld, ", start);
+    if (bound->type == NODE_NUMBER) {
+        // Integer i satisfies i < b exactly when i < ceil(b) (floor for i > b)
+        fprintf(out, "%.0f", step > 0 ? ceil(bound->num_value) : floor(bound->num_value));
+    } else if (!bound_needs_rounding(bound)) {
+        generate_expr(bound, out, indent);
+    } else {
+        fprintf(out, "math.%s(", step > 0 ? "ceil" : "floor");
+        generate_expr(bound, out, indent);
+        fprintf(out, ")");
+    }
+    if (step != 1) fprintf(out, ", %ld", step);
+    fprintf(out, ")");
+    if (node->for_loop.keep_final) {
+        fprintf(out, "\n");
+        print_indent(out, indent);
+        fprintf(out, "for %s in %s", var, range_name);
+    }
+    fprintf(out, ":\n");
+    generate_block(node->for_loop.body, out, indent + 1);
+    if (node->for_loop.keep_final) {
+        print_indent(out, indent);
+        fprintf(out, "%s = %ld + len(%s) * %ld\n", var, start, range_name, step);
+    }
+}
+
+// Replaces reads of `from` in a cloned term with `to`
+static void rename_var(ASTNode* node, const char* from, const char* to) {
+    if (!node) return;
+    switch (node->type) {
+        case NODE_ID:
+            if (streq(node->id_name, from)) node->id_name = strdup(to);
+            break;
+        case NODE_BINARY_OP:
+            rename_var(node->binary_op.left, from, to);
+            rename_var(node->binary_op.right, from, to);
+            break;
+        default:
+            break;
+    }
+}
+
+static bool term_reads(ASTNode* node, const char* var) {
+    if (!node) return false;
+    if (node->type == NODE_ID) return streq(node->id_name, var);
+    if (node->type == NODE_BINARY_OP)
+        return term_reads(node->binary_op.left, var) || term_reads(node->binary_op.right, var);
+    return false;
+}
+
+// Emits a VectorOp term evaluated over every iteration at once; `operand`
+// parenthesises compound terms that are followed by a method call or negated
+static void generate_vector_term(ASTNode* term, const char* var, const char* idx, bool operand, FILE* out, int indent) {
+    ASTNode* copy = cloneAST(term);
+    bool uses_var = term_reads(copy, var);
+    rename_var(copy, var, idx);
+    if (uses_var) {
+        bool wrap = operand && copy->type == NODE_BINARY_OP;
+        if (wrap) fprintf(out, "(");
+        generate_expr(copy, out, indent);
+        if (wrap) fprintf(out, ")");
+    } else {
+        // A term that ignores the loop variable still contributes once per iteration
+        fprintf(out, "np.full(%s.shape, ", idx);
+        generate_expr(copy, out, indent);
+        fprintf(out, ", dtype=np.int64)");
+    }
+}
+
+// Emits a loop planned by vectorize_loops: every iteration's terms are
+// computed over np.arange(), then folded into the accumulators with exact
+// integer results (the planner proved nothing leaves int64).
+static int vector_counter = 0;
+
+void generate_vectorized_loop(ASTNode* node, FILE* out, int indent) {
+    const char* var = node->for_loop.init->assignment.var_name;
+    long start = node->for_loop.range_start;
+    long step = node->for_loop.range_step;
+    double bound = node->for_loop.range_bound->num_value;
+    int id = ++vector_counter;
+    char idx[32], scan[32];
+    snprintf(idx, sizeof(idx), "_vidx_%d", id);
+    snprintf(scan, sizeof(scan), "_vscan_%d", id);
+    bool scanned = false;
+
+    print_indent(out, indent);
+    fprintf(out, "%s = np.arange(%ld, %.0f, %ld, dtype=np.int64)\n", idx, start,
+            step > 0 ? ceil(bound) : floor(bound), step);
+    for (VectorOp* op = node->for_loop.vector_ops; op; op = op->next) {
+        const char* t = op->target;
+        print_indent(out, indent);
+        if (op->kind == VEC_MAP) {
+            fprintf(out, "%s = _wizuall_concat(%s, ", t, t);
+            generate_vector_term(op->term, var, idx, false, out, indent);
+            fprintf(out, ")\n");
+            continue;
+        }
+        bool sum = op->kind == VEC_SUM;
+        const char* sign = op->negate ? "-" : "";
+        if (!op->scan_into) {
+            fprintf(out, "%s = %s %s int(np.%s(", t, t, sum ? (op->negate ? "-" : "+") : "*", sum ? "sum" : "prod");
+            generate_vector_term(op->term, var, idx, false, out, indent);
+            fprintf(out, "))\n");
+            continue;
+        }
+        scanned = true;
+        fprintf(out, "%s = np.%s(%s", scan, sum ? "cumsum" : "cumprod", sign);
+        generate_vector_term(op->term, var, idx, op->negate, out, indent);
+        fprintf(out, ")\n");
+        print_indent(out, indent);
+        fprintf(out, "%s = _wizuall_concat(%s, %s %s %s)\n", op->scan_into, op->scan_into, t, sum ? "+" : "*", scan);
+        print_indent(out, indent);
+        fprintf(out, "%s = %s %s int(%s[-1]) if %s.size else %s\n", t, t, sum ? "+" : "*", scan, scan, t);
+    }
+    if (node->for_loop.keep_final) {
+        print_indent(out, indent);
+        fprintf(out, "%s = %ld + len(%s) * %ld\n", var, start, idx, step);
+    }
+    // The index (and scan) arrays hold one element per iteration
+    print_indent(out, indent);
+    fprintf(out, "del %s%s%s\n", idx, scanned ? ", " : "", scanned ? scan : "");
+}
+
+// Emits the call returning the columns an import binds, as a dict: the
+// referenced ones of a static import, all of them otherwise. Tables are
+// queried each time: the cache key (size and mtime) misses writes that are
+// still in a database's write-ahead log.
+static void emit_import_load(const char* path, ImportFormat format, const ASTNode* import, const ImportSchema* schema, FILE* out) {
+    const char* table = import ? import->import.table : NULL;
+    if (format == IMPORT_SQLITE) fprintf(out, "_wizuall_read_sqlite('%s', '%s', ", path, table);
+    else fprintf(out, "_wizuall_load('%s', ", path);
+    if (schema) {
+        bool first = true;
+        fprintf(out, "[");
+        for (int i = 0; i < schema->count; i++) {
+            const char* name = schema->columns[i].name;
+            if (!column_loaded(path, name)) continue;
+            fprintf(out, "%s'%s'", first ? "" : ", ", name);
+            first = false;
+        }
+        fprintf(out, "]");
+    } else {
+        fprintf(out, "None");
+    }
+    if (format == IMPORT_SQLITE) {
+        const RowWindow* rows = find_row_window(path, table);
+        if (rows) fprintf(out, ", %ld, %ld", rows->start, rows->stop);
+        fprintf(out, ")");
+        return;
+    }
+    fprintf(out, ", %s", format == IMPORT_JSON ? "_wizuall_read_json" : "_wizuall_read_csv");
+    // A sampled fraction is a Python float, a row count an int
+    double sample = import ? import->import.sample : 0;
+    if (sample > 0 && import->import.sample_rows) {
+        fprintf(out, ", %lld", (long long)sample);
+    } else if (sample > 0 && sample < 1) {
+        char text[32];
+        snprintf(text, sizeof(text), "%.15g", sample);
+        fprintf(out, ", %s%s", text, strpbrk(text, ".e") ? "" : ".0");
+    }
+    fprintf(out, ")");
+}
+
+// Binds the streamed columns of `path` to objects holding the aggregates the
+// program reads from them (see plan_streams)
+static void generate_stream_import(const char* path, const ImportSchema* schema, FILE* out, int indent) {
+    bool first = true;
+    print_indent(out, indent);
+    fprintf(out, "[");
+    for (int i = 0; i < schema->count; i++) {
+        if (!column_streamed(path, schema->columns[i].name)) continue;
+        fprintf(out, "%s%s", first ? "" : ", ", schema->columns[i].name);
+        first = false;
+    }
+    fprintf(out, "] = _wizuall_stream_csv('%s', {", path);
+    first = true;
+    for (int i = 0; i < schema->count; i++) {
+        const StreamColumn* c = find_stream_column(schema->columns[i].name);
+        if (!c || !streq(c->path, path)) continue;
+        fprintf(out, "%s'%s': {", first ? "" : ", ", c->name);
+        bool first_need = true;
+        if (c->needs & STREAM_AVG) {
+            fprintf(out, "'avg': True");
+            first_need = false;
+        }
+        if (c->needs & STREAM_RUNNING_SUM) {
+            fprintf(out, "%s'running_sum': True", first_need ? "" : ", ");
+            first_need = false;
+        }
+        if (c->needs & STREAM_HISTOGRAM) {
+            fprintf(out, "%s'hist': (", first_need ? "" : ", ");
+            for (int b = 0; b < c->bin_count; b++)
+                fprintf(out, "%s%d", b ? ", " : "", c->bins[b]);
+            fprintf(out, c->bin_count == 1 ? ",)" : ")");
+            first_need = false;
+        }
+        if (c->needs & STREAM_BOXPLOT)
+            fprintf(out, "%s'box': True", first_need ? "" : ", ");
+        fprintf(out, "}");
+        first = false;
+    }
+    fprintf(out, "}).values()\n");
+}
+
+// The reader returns the referenced columns in schema order, parsing no others
+static void emit_import_targets(const char* path, const ImportSchema* schema, FILE* out, int indent) {
+    bool first = true;
+    print_indent(out, indent);
+    fprintf(out, "[");
+    for (int i = 0; i < schema->count; i++) {
+        const char* name = schema->columns[i].name;
+        if (!column_loaded(path, name)) continue;
+        fprintf(out, "%s%s", first ? "" : ", ", name);
+        first = false;
+    }
+    fprintf(out, "] = ");
+}
+
+static void generate_static_import(const char* path, const ASTNode* import, const ImportSchema* schema, FILE* out, int indent) {
+    bool streams = import_streams_columns(path, schema);
+    if (streams) generate_stream_import(path, schema, out, indent);
+    if (!import_reads_columns(path, schema)) {
+        if (streams) return;
+        print_indent(out, indent);
+        fprintf(out, "# %s: no columns referenced\n", path);
+        return;
+    }
+    emit_import_targets(path, schema, out, indent);
+    emit_import_load(path, schema->format, import, schema, out);
+    fprintf(out, ".values()\n");
+}
+
+// Fallback for files that could not be read when compiling: every key or
+// column is bound through globals() at run time
+static void generate_dynamic_import(const char* path, ImportFormat format, const ASTNode* import, FILE* out, int indent) {
+    print_indent(out, indent);
+    fprintf(out, "globals().update(");
+    emit_import_load(path, format, import, NULL, out);
+    fprintf(out, ")\n");
+}
+
+// Emits the load of every import that reads a file into `out` (when not
+// NULL); returns whether there is any
+static bool emit_cache_loads(ASTList* stmts, FILE* out) {
+    bool any = false;
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        switch (n->type) {
+            case NODE_IMPORT: {
+                char path[256];
+                import_path(n->import.filename, path, sizeof(path));
+                ImportFormat format = import_format(path);
+                const ImportSchema* schema = static_imports ? find_import_schema(path, n->import.table) : NULL;
+                // Samples and live imports are not cached
+                if (format == IMPORT_UNSUPPORTED || format == IMPORT_SQLITE || n->import.sample > 0 || n->import.live) break;
+                if (schema && !import_reads_columns(path, schema)) break;
+                any = true;
+                if (!out) break;
+                print_indent(out, 1);
+                emit_import_load(path, format, NULL, schema, out);
+                fprintf(out, "\n");
+                break;
+            }
+            case NODE_IF_ELSE:
+                any |= emit_cache_loads(n->if_else.if_body, out);
+                any |= emit_cache_loads(n->if_else.else_body, out);
+                break;
+            case NODE_WHILE_LOOP:
+                any |= emit_cache_loads(n->while_loop.body, out);
+                break;
+            case NODE_FOR_LOOP:
+                any |= emit_cache_loads(n->for_loop.body, out);
+                break;
+            default:
+                break;
+        }
+    }
+    return any;
+}
+
+// ---------------------------------------------------------------------------
+// Live imports
+// ---------------------------------------------------------------------------
+
+// After the program has run once, output.py waits for rows appended to its
+// top-level live imports and runs again only the top-level statements that
+// read what those imports bind, directly or through an earlier such
+// statement. Plots they draw replace the images of their first run.
+static ASTNode** live_imports = NULL;
+static int live_import_count = 0;
+static ASTNode** live_reruns = NULL;
+static int live_rerun_count = 0;
+// Columns bound by a static live import and nothing else: avg and
+// runningSum of them are carried forward by the import as rows arrive
+static NameSet live_columns;
+static int* live_column_sources = NULL;
+
+static void collect_import_binds(ASTNode* stmt, NameSet* names);
+
+static bool stmt_draws(ASTNode* stmt) {
+    if (!stmt) return false;
+    switch (stmt->type) {
+        case NODE_VIZ_CALL:
+            return true;
+        case NODE_IF_ELSE:
+            for (ASTList* s = stmt->if_else.if_body; s; s = s->next) if (stmt_draws(s->node)) return true;
+            for (ASTList* s = stmt->if_else.else_body; s; s = s->next) if (stmt_draws(s->node)) return true;
+            return false;
+        case NODE_WHILE_LOOP:
+            for (ASTList* s = stmt->while_loop.body; s; s = s->next) if (stmt_draws(s->node)) return true;
+            return false;
+        case NODE_FOR_LOOP:
+            for (ASTList* s = stmt->for_loop.body; s; s = s->next) if (stmt_draws(s->node)) return true;
+            return false;
+        default:
+            return false;
+    }
+}
+
+static const ImportSchema* live_schema(ASTNode* import, char* path, size_t size) {
+    import_path(import->import.filename, path, size);
+    return static_imports ? find_import_schema(path, NULL) : NULL;
+}
+
+static void plan_live(ASTList* stmts) {
+    free(live_imports);
+    free(live_reruns);
+    free(live_column_sources);
+    live_imports = live_reruns = NULL;
+    live_column_sources = NULL;
+    live_import_count = live_rerun_count = 0;
+    nameset_free(&live_columns);
+    nameset_init(&live_columns);
+
+    NameSet tainted, assigned, imported;
+    nameset_init(&tainted);
+    nameset_init(&assigned);
+    nameset_init(&imported);
+    collect_list_defs(stmts, &assigned);
+    bool all = false;
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        if (n->type == NODE_IMPORT && n->import.live) {
+            char path[256];
+            const ImportSchema* schema = live_schema(n, path, sizeof(path));
+            if (schema && !import_reads_columns(path, schema)) continue;
+            live_imports = realloc(live_imports, (live_import_count + 1) * sizeof(ASTNode*));
+            live_imports[live_import_count++] = n;
+            if (!schema) {
+                all = true;   // any name may be one of its columns
+                continue;
+            }
+            for (int i = 0; i < schema->count; i++) {
+                const char* name = schema->columns[i].name;
+                if (!column_loaded(path, name)) continue;
+                nameset_add(&tainted, name);
+                if (nameset_contains(&assigned, name) || !nameset_add(&live_columns, name)) continue;
+                live_column_sources = realloc(live_column_sources, live_columns.count * sizeof(int));
+                live_column_sources[live_columns.count - 1] = live_import_count - 1;
+            }
+            continue;
+        }
+        collect_import_binds(n, &imported);
+        if (!live_import_count || n->type == NODE_IMPORT) continue;   // imports are read once
+        NameSet uses;
+        nameset_init(&uses);
+        collect_stmt_uses(n, &uses);
+        bool depends = all;
+        for (int i = 0; i < uses.count && !depends; i++)
+            depends = nameset_contains(&tainted, uses.names[i]);
+        nameset_free(&uses);
+        if (!depends) continue;
+        ASTList single = { n, NULL };
+        collect_list_defs(&single, &tainted);
+        live_reruns = realloc(live_reruns, (live_rerun_count + 1) * sizeof(ASTNode*));
+        live_reruns[live_rerun_count++] = n;
+    }
+    // A column another import may rebind is read from wherever it was bound last
+    for (int i = 0; i < live_columns.count; i++)
+        if (nameset_contains(&imported, live_columns.names[i])) live_column_sources[i] = -1;
+    nameset_free(&tainted);
+    nameset_free(&assigned);
+    nameset_free(&imported);
+}
+
+static int find_live_import(ASTNode* import) {
+    for (int i = 0; i < live_import_count; i++)
+        if (live_imports[i] == import) return i;
+    return -1;
+}
+
+static int find_live_rerun(ASTNode* stmt) {
+    for (int i = 0; i < live_rerun_count; i++)
+        if (live_reruns[i] == stmt) return i;
+    return -1;
+}
+
+// Index of the live import that carries avg/runningSum of a column, or -1
+static int live_source(const char* name) {
+    for (int i = 0; i < live_columns.count; i++)
+        if (streq(live_columns.names[i], name)) return live_column_sources[i];
+    return -1;
+}
+
+// Binds the columns of a live import from `source`, a _WizuallLive
+static void emit_live_binding(ASTNode* import, const char* source, FILE* out, int indent) {
+    char path[256];
+    const ImportSchema* schema = live_schema(import, path, sizeof(path));
+    if (schema) {
+        emit_import_targets(path, schema, out, indent);
+        fprintf(out, "%s.columns().values()\n", source);
+    } else {
+        print_indent(out, indent);
+        fprintf(out, "globals().update(%s.columns())\n", source);
+    }
+}
+
+static void generate_live_import(ASTNode* node, FILE* out, int indent) {
+    char path[256], source[32];
+    const ImportSchema* schema = live_schema(node, path, sizeof(path));
+    if (schema && !import_reads_columns(path, schema)) {
+        print_indent(out, indent);
+        fprintf(out, "# %s: no columns referenced\n", path);
+        return;
+    }
+    int index = find_live_import(node);
+    if (index >= 0) {
+        snprintf(source, sizeof(source), "_wizuall_live_%d", index);
+    } else {
+        fprintf(stderr, "warning: %s is imported live inside if/loop and read once\n", path);
+        snprintf(source, sizeof(source), "_wizuall_live");
+    }
+    print_indent(out, indent);
+    fprintf(out, "%s = _WizuallLive('%s', ", source, path);
+    if (schema) {
+        fprintf(out, "[");
+        bool first = true;
+        for (int i = 0; i < schema->count; i++) {
+            if (!column_loaded(path, schema->columns[i].name)) continue;
+            fprintf(out, "%s'%s'", first ? "" : ", ", schema->columns[i].name);
+            first = false;
+        }
+        fprintf(out, "])\n");
+    } else {
+        fprintf(out, "None)\n");
+    }
+    emit_live_binding(node, source, out, indent);
+}
+
+// In the first run, records the plot number a re-run statement starts at
+static void emit_live_mark(ASTNode* stmt, FILE* out, int indent) {
+    int index = find_live_rerun(stmt);
+    if (index < 0 || !stmt_draws(stmt)) return;
+    print_indent(out, indent);
+    fprintf(out, "_wizuall_plot_%d = plot_counter\n", index);
+}
+
+static void generate_live_loop(FILE* out, int indent) {
+    if (!live_import_count) return;
+    print_indent(out, indent);
+    fprintf(out, "# Run what reads the live imports again as rows are appended\n");
+    print_indent(out, indent);
+    fprintf(out, "while _wizuall_live_wait([");
+    for (int i = 0; i < live_import_count; i++)
+        fprintf(out, "%s_wizuall_live_%d", i ? ", " : "", i);
+    fprintf(out, "]):\n");
+    for (int i = 0; i < live_import_count; i++) {
+        char source[32];
+        snprintf(source, sizeof(source), "_wizuall_live_%d", i);
+        emit_live_binding(live_imports[i], source, out, indent + 1);
+    }
+    for (int i = 0; i < live_rerun_count; i++) {
+        if (stmt_draws(live_reruns[i])) {
+            print_indent(out, indent + 1);
+            fprintf(out, "plot_counter = _wizuall_plot_%d\n", i);
+        }
+        generate_code(live_reruns[i], out, indent + 1);
+    }
+}
+
+// Emit Python code to import data from JSON, CSV or a SQLite table
+void generate_import(ASTNode* node, FILE* out, int indent) {
+    char path[256];
+    import_path(node->import.filename, path, sizeof(path));
+    ImportFormat format = import_format(path);
+    if (format == IMPORT_UNSUPPORTED) {
+        print_indent(out, indent);
+        fprintf(out, "# Unsupported import file type: %s\n", node->import.filename);
+        return;
+    }
+    if (node->import.live) {
+        generate_live_import(node, out, indent);
+        return;
+    }
+    const ImportSchema* schema = static_imports ? find_import_schema(path, node->import.table) : NULL;
+    if (schema)
+        generate_static_import(path, node, schema, out, indent);
+    else
+        generate_dynamic_import(path, format, node, out, indent);
+}
+
+// ---------------------------------------------------------------------------
+// Prefetch
+// ---------------------------------------------------------------------------
+
+// A top-level static import whose load is submitted to a background thread
+// when the program starts; its columns are bound in front of `bind_before`,
+// the first statement that reads, assigns, releases or imports one of them
+// (NULL: the end of the program)
+typedef struct {
+    ASTNode* import;
+    ASTNode* bind_before;
+} Prefetch;
+
+static Prefetch* prefetches = NULL;
+static int prefetch_count = 0;
+
+static const ImportSchema* import_schema_of(ASTNode* import, char* path, size_t size) {
+    import_path(import->import.filename, path, size);
+    if (import_format(path) == IMPORT_UNSUPPORTED) return NULL;
+    return find_import_schema(path, import->import.table);
+}
+
+// Adds the columns the imports inside a statement bind to names
+static void collect_import_binds(ASTNode* stmt, NameSet* names) {
+    if (!stmt) return;
+    switch (stmt->type) {
+        case NODE_IMPORT: {
+            char path[256];
+            const ImportSchema* schema = import_schema_of(stmt, path, sizeof(path));
+            for (int i = 0; schema && i < schema->count; i++)
+                if (nameset_contains(&referenced_names, schema->columns[i].name))
+                    nameset_add(names, schema->columns[i].name);
+            break;
+        }
+        case NODE_IF_ELSE:
+            for (ASTList* s = stmt->if_else.if_body; s; s = s->next) collect_import_binds(s->node, names);
+            for (ASTList* s = stmt->if_else.else_body; s; s = s->next) collect_import_binds(s->node, names);
+            break;
+        case NODE_WHILE_LOOP:
+            for (ASTList* s = stmt->while_loop.body; s; s = s->next) collect_import_binds(s->node, names);
+            break;
+        case NODE_FOR_LOOP:
+            for (ASTList* s = stmt->for_loop.body; s; s = s->next) collect_import_binds(s->node, names);
+            break;
+        default:
+            break;
+    }
+}
+
+// Only imports whose whole result is a dict of loaded columns are
+// prefetched: streamed columns are computed in passes over the file, and a
+// file imported twice would race on its cache entry
+static bool prefetchable(ASTList* stmts, ASTNode* import) {
+    char path[256], other[256];
+    const ImportSchema* schema = import_schema_of(import, path, sizeof(path));
+    if (import->import.live) return false;   // read from the file as it grows
+    if (!schema || !import_reads_columns(path, schema) || import_streams_columns(path, schema)) return false;
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (n && n != import && n->type == NODE_IMPORT) {
+            import_path(n->import.filename, other, sizeof(other));
+            if (streq(other, path)) return false;
+        }
+        if (n && (n->type == NODE_IF_ELSE || n->type == NODE_WHILE_LOOP || n->type == NODE_FOR_LOOP)) {
+            NameSet nested;
+            nameset_init(&nested);
+            collect_import_binds(n, &nested);
+            bool any = nested.count > 0;
+            nameset_free(&nested);
+            if (any) return false;   // nested imports run conditionally or repeatedly
+        }
+    }
+    return true;
+}
+
+static bool stmt_touches(ASTNode* stmt, const NameSet* names) {
+    NameSet seen;
+    nameset_init(&seen);
+    ASTList single = { stmt, NULL };
+    collect_stmt_uses(stmt, &seen);
+    collect_list_defs(&single, &seen);
+    collect_import_binds(stmt, &seen);
+    bool touches = false;
+    for (int i = 0; i < seen.count && !touches; i++)
+        touches = nameset_contains(names, seen.names[i]);
+    nameset_free(&seen);
+    return touches;
+}
+
+// An import is prefetched when some other statement runs before its columns
+// are needed, so loading it overlaps with that work
+static void plan_prefetches(ASTList* stmts) {
+    free(prefetches);
+    prefetches = NULL;
+    prefetch_count = 0;
+    if (!static_imports || has_dynamic_imports()) return;
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n || n->type != NODE_IMPORT || !prefetchable(stmts, n)) continue;
+        NameSet names;
+        nameset_init(&names);
+        collect_import_binds(n, &names);
+        ASTList* use = s->next;
+        while (use && !stmt_touches(use->node, &names))
+            use = use->next;
+        nameset_free(&names);
+        prefetches = realloc(prefetches, (prefetch_count + 1) * sizeof(Prefetch));
+        prefetches[prefetch_count].import = n;
+        prefetches[prefetch_count++].bind_before = use ? use->node : NULL;
+    }
+    // Work is any statement that is not itself a prefetched import
+    int kept = 0;
+    for (int p = 0; p < prefetch_count; p++) {
+        bool work = false;
+        for (ASTList* s = stmts; s && s->node != prefetches[p].bind_before && !work; s = s->next) {
+            bool prefetched = false;
+            for (int q = 0; q < prefetch_count; q++)
+                prefetched |= prefetches[q].import == s->node;
+            work = !prefetched;
+        }
+        if (work) prefetches[kept++] = prefetches[p];
+    }
+    prefetch_count = kept;
+    prefetch_emitted = prefetch_count > 0;
+}
+
+static int find_prefetch(ASTNode* import) {
+    for (int p = 0; p < prefetch_count; p++)
+        if (prefetches[p].import == import) return p;
+    return -1;
+}
+
+// Binds the columns of the prefetched imports due in front of `stmt`
+static void emit_prefetch_bindings(ASTNode* stmt, FILE* out) {
+    for (int p = 0; p < prefetch_count; p++) {
+        if (prefetches[p].bind_before != stmt) continue;
+        char path[256];
+        const ImportSchema* schema = import_schema_of(prefetches[p].import, path, sizeof(path));
+        emit_import_targets(path, schema, out, 1);
+        fprintf(out, "_wizuall_import_%d().values()\n", p);
+    }
+}
+
+// The program body runs inside a function so its variables are fast locals
+// instead of module dictionary entries. When an import has to bind names
+// through globals(), everything the program assigns (or deletes) stays
+// global so it sees those names; the plot counter is always global.
+void generate_main_function(ASTList* stmts, FILE* out) {
+    NameSet bound, globals;
+    nameset_init(&bound);
+    nameset_init(&globals);
+    collect_list_defs(stmts, &bound);
+    if (matplotlib_imported) nameset_add(&globals, "plot_counter");
+    if (has_dynamic_imports()) {
+        // Static imports assign the names they bind as well
+        nameset_union(&globals, &bound);
+        nameset_union(&globals, &referenced_names);
+    }
+
+    fprintf(out, "def _wizuall_main():\n");
+    if (globals.count > 0) {
+        print_indent(out, 1);
+        fprintf(out, "global ");
+        for (int i = 0; i < globals.count; i++)
+            fprintf(out, "%s%s", i ? ", " : "", globals.names[i]);
+        fprintf(out, "\n");
+    }
+    if (prefetch_count > 0) {
+        // Each load starts with the program; its columns are bound where
+        // they are first needed
+        for (int p = 0; p < prefetch_count; p++) {
+            char path[256];
+            const ImportSchema* schema = import_schema_of(prefetches[p].import, path, sizeof(path));
+            print_indent(out, 1);
+            fprintf(out, "_wizuall_import_%d = _wizuall_prefetch(lambda: ", p);
+            emit_import_load(path, schema->format, prefetches[p].import, schema, out);
+            fprintf(out, ")\n");
+        }
+        for (ASTList* s = stmts; s; s = s->next) {
+            emit_prefetch_bindings(s->node, out);
+            if (find_prefetch(s->node) >= 0) continue;
+            emit_live_mark(s->node, out, 1);
+            generate_code(s->node, out, 1);
+        }
+        emit_prefetch_bindings(NULL, out);
+    } else if (live_import_count > 0) {
+        for (ASTList* s = stmts; s; s = s->next) {
+            emit_live_mark(s->node, out, 1);
+            generate_code(s->node, out, 1);
+        }
+    } else {
+        generate_block(stmts, out, 1);
+    }
+    generate_live_loop(out, 1);
+    // `python3 output.py --warm-cache` only fills the import cache
+    bool loads = emit_cache_loads(stmts, NULL);
+    if (loads) {
+        fprintf(out, "\n\ndef _wizuall_warm_cache():\n");
+        emit_cache_loads(stmts, out);
+    }
+    fprintf(out, "\n\nif __name__ == '__main__':\n");
+    if (loads) {
+        print_indent(out, 1);
+        fprintf(out, "import sys\n");
+        print_indent(out, 1);
+        fprintf(out, "if '--warm-cache' in sys.argv[1:]:\n");
+        print_indent(out, 2);
+        fprintf(out, "_wizuall_warm_cache()\n");
+        print_indent(out, 1);
+        fprintf(out, "else:\n");
+        print_indent(out, 2);
+        fprintf(out, "_wizuall_main()\n");
+    } else {
+        print_indent(out, 1);
+        fprintf(out, "_wizuall_main()\n");
+    }
+    nameset_free(&bound);
+    nameset_free(&globals);
+}
+
+// Emits an indented statement list; Python needs `pass` for an empty body
+void generate_block(ASTList* stmts, FILE* out, int indent) {
+    if (!stmts) {
+        print_indent(out, indent);
+        fprintf(out, "pass\n");
+        return;
+    }
+    for (ASTList* s = stmts; s; s = s->next)
+        generate_code(s->node, out, indent);
+}
+
 void generate_code(ASTNode* node, FILE* out, int indent) {
     if (!node) return;
     switch (node->type) {
-        case NODE_PROGRAM:
+        case NODE_PROGRAM: {
+            // Aux blocks may expect module-level names, so they keep the flat
+            // layout and imports bind every column dynamically
+            bool opaque = list_has_opaque_code(node->program.statements);
+            if (!opaque) {
+                static_imports = true;
+                for (ASTList* s = node->program.statements; s; s = s->next)
+                    collect_stmt_uses(s->node, &referenced_names);
+            }
+            // Planned first: the scan leaves out kernels for what live imports carry
+            plan_live(node->program.statements);
+            plan_prefetches(node->program.statements);
             scan_for_imports_and_helpers(node);
             emit_imports(out);
             emit_helpers(out);
-            // Add code to create 'plots' directory if it doesn't exist
-            fprintf(out, "import os\n");
-            fprintf(out, "os.makedirs('plots', exist_ok=True)\n");
-            for (ASTList* s = node->program.statements; s; s = s->next)
-                generate_code(s->node, out, indent);
+            if (opaque) {
+                for (ASTList* s = node->program.statements; s; s = s->next) {
+                    emit_live_mark(s->node, out, indent);
+                    generate_code(s->node, out, indent);
+                }
+                generate_live_loop(out, indent);
+                break;
+            }
+            generate_main_function(node->program.statements, out);
             break;
-        case NODE_ASSIGNMENT:
+        }
+        case NODE_ASSIGNMENT: {
+            ASTNode* operand;
+            const char* update = in_place_operator(node, &operand);
+            ASTNode* appended = appended_operand(node);
+            const char* x = node->assignment.var_name;
+            ASTNode* e = node->assignment.expr;
+            const char* ufunc = update ? NULL : array_update(node, &operand);
+            bool vectors = false;
             print_indent(out, indent);
-            fprintf(out, "%s = ", node->assignment.var_name);
-            generate_expr(node->assignment.expr, out, indent);
+            if (update) {
+                fprintf(out, "%s %s ", x, update);
+                generate_expr(operand, out, indent);
+            } else if (ufunc) {
+                fprintf(out, "%s = _wizuall_update(%s, %s, ", x, ufunc, x);
+                generate_expr(operand, out, indent);
+                fprintf(out, ")");
+            } else if (appended && appended->type == NODE_VECTOR_LITERAL && appended->vector_literal.elements
+                       && !appended->vector_literal.elements->next && literal_form(appended) != LITERAL_LIST) {
+                // One number appended: stored straight into the vector's buffer
+                fprintf(out, "%s = _wizuall_append(%s, ", x, x);
+                generate_expr(appended->vector_literal.elements->node, out, indent);
+                fprintf(out, ")");
+            } else if (appended) {
+                fprintf(out, "%s = _wizuall_concat(%s, ", x, x);
+                generate_expr(appended, out, indent);
+                fprintf(out, ", True)");
+            } else if (e && e->type == NODE_VECTOR_LITERAL && !e->vector_literal.elements
+                       && lookup_var_type(x).kind == TYPE_STRING_VECTOR) {
+                // `[]` starting a list of strings
+                fprintf(out, "%s = []", x);
+            } else if (may_spill(e) && elementwise(e, &vectors) && vectors) {
+                // A function of its vectors, which _wizuall_spill may call on
+                // blocks of them to fill a scratch file past the budget
+                NameSet names;
+                nameset_init(&names);
+                collect_vector_operands(e, &names);
+                fprintf(out, "%s = _wizuall_spill(lambda ", x);
+                for (int i = 0; i < names.count; i++)
+                    fprintf(out, "%s%s", i ? ", " : "", names.names[i]);
+                fprintf(out, ": ");
+                generate_expr(e, out, indent);
+                for (int i = 0; i < names.count; i++)
+                    fprintf(out, ", %s", names.names[i]);
+                fprintf(out, ")");
+                nameset_free(&names);
+            } else if (may_spill(e)) {
+                fprintf(out, "%s = _wizuall_spill(", x);
+                generate_expr(e, out, indent);
+                fprintf(out, ")");
+            } else {
+                fprintf(out, "%s = ", node->assignment.var_name);
+                generate_expr(node->assignment.expr, out, indent);
+            }
             fprintf(out, "\n");
             break;
+        }
         case NODE_FUNCTION_CALL:
             print_indent(out, indent);
             generate_expr(node, out, indent);
@@ -1083,75 +3541,54 @@ void generate_code(ASTNode* node, FILE* out, int indent) {
             fprintf(out, "if ");
             generate_expr(node->if_else.condition, out, indent);
             fprintf(out, ":\n");
-            for (ASTList* s = node->if_else.if_body; s; s = s->next)
-                generate_code(s->node, out, indent + 1);
-            print_indent(out, indent);
-            fprintf(out, "else:\n");
-            for (ASTList* s = node->if_else.else_body; s; s = s->next)
-                generate_code(s->node, out, indent + 1);
+            generate_block(node->if_else.if_body, out, indent + 1);
+            if (node->if_else.else_body) {
+                print_indent(out, indent);
+                fprintf(out, "else:\n");
+                generate_block(node->if_else.else_body, out, indent + 1);
+            }
             break;
         case NODE_WHILE_LOOP:
             print_indent(out, indent);
             fprintf(out, "while ");
             generate_expr(node->while_loop.condition, out, indent);
             fprintf(out, ":\n");
-            for (ASTList* s = node->while_loop.body; s; s = s->next)
-                generate_code(s->node, out, indent + 1);
+            generate_block(node->while_loop.body, out, indent + 1);
             break;
         case NODE_FOR_LOOP:
-            print_indent(out, indent);
+            if (node->for_loop.vector_ops) {
+                generate_vectorized_loop(node, out, indent);
+                break;
+            }
+            if (node->for_loop.counted) {
+                generate_range_loop(node, out, indent);
+                break;
+            }
             generate_code(node->for_loop.init, out, indent);
             print_indent(out, indent);
             fprintf(out, "while ");
             generate_expr(node->for_loop.condition, out, indent);
             fprintf(out, ":\n");
-            for (ASTList* s = node->for_loop.body; s; s = s->next)
-                generate_code(s->node, out, indent + 1);
+            generate_block(node->for_loop.body, out, indent + 1);
             generate_code(node->for_loop.increment, out, indent + 1);
             break;
-        case NODE_IMPORT: {
-            // Emit Python code to import data from JSON or CSV
-            const char* fname = node->import.filename;
-            int len = strlen(fname);
-            // Remove quotes if present
-            char clean_fname[256];
-            if (fname[0] == '"' && fname[len-1] == '"') {
-                strncpy(clean_fname, fname+1, len-2);
-                clean_fname[len-2] = '\0';
-            } else {
-                strncpy(clean_fname, fname, sizeof(clean_fname)-1);
-                clean_fname[sizeof(clean_fname)-1] = '\0';
-            }
-            if (len > 5 && strcmp(clean_fname + strlen(clean_fname) - 5, ".json") == 0) {
-                print_indent(out, indent);
-                fprintf(out, "import json\n");
-                print_indent(out, indent);
-                fprintf(out, "with open('%s', 'r') as f:\n", clean_fname);
-                print_indent(out, indent+1);
-                fprintf(out, "_data = json.load(f)\n");
-                print_indent(out, indent+1);
-                fprintf(out, "globals().update(_data)\n");
-            } else if (len > 4 && strcmp(clean_fname + strlen(clean_fname) - 4, ".csv") == 0) {
-                print_indent(out, indent);
-                fprintf(out, "import csv\n");
-                print_indent(out, indent);
-                fprintf(out, "with open('%s', 'r') as f:\n", clean_fname);
-                print_indent(out, indent+1);
-                fprintf(out, "reader = csv.DictReader(f)\n");
-                print_indent(out, indent+1);
-                fprintf(out, "_csv_data = list(reader)\n");
-                print_indent(out, indent+1);
-                fprintf(out, "if _csv_data:\n");
-                print_indent(out, indent+2);
-                fprintf(out, "for k in _csv_data[0].keys():\n");
-                print_indent(out, indent+3);
-                fprintf(out, "globals()[k] = [row[k] for row in _csv_data]\n");
-            } else {
-                print_indent(out, indent);
-                fprintf(out, "# Unsupported import file type: %s\n", fname);
-            }
+        case NODE_IMPORT:
+            generate_import(node, out, indent);
+            break;
+        case NODE_EXPORT:
+            print_indent(out, indent);
+            fprintf(out, "_wizuall_export('%s', {", node->export.filename);
+            for (ASTList* n = node->export.names; n; n = n->next)
+                fprintf(out, "'%s': %s%s", n->node->id_name, n->node->id_name, n->next ? ", " : "");
+            fprintf(out, "})\n");
+            break;
+        case NODE_RELEASE:
+            print_indent(out, indent);
+            if (node->release.rebind)
+                fprintf(out, "%s = None\n", node->release.var_name);
+            else
+                fprintf(out, "del %s\n", node->release.var_name);
             break;
-        }
         default:
             print_indent(out, indent);
             fprintf(out, "# unsupported node\n");
@@ -0,0 +1,432 @@
+#define _GNU_SOURCE   // fopencookie
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <glob.h>
+#include <limits.h>
+#include <sqlite3.h>
+#include <sys/stat.h>
+#include <zlib.h>
+#include "import_schema.h"
+
+// Rows sampled to guess CSV column types
+#define CSV_SAMPLE_ROWS 1000
+#define CSV_MAX_COLUMNS 1024
+#define SCHEMA_NAME_MAX 256
+
+void import_path(const char* raw, char* buf, size_t size) {
+    size_t len = strlen(raw);
+    if (len >= 2 && raw[0] == '"' && raw[len-1] == '"') {
+        raw++;
+        len -= 2;
+    }
+    if (len >= size) len = size - 1;
+    memcpy(buf, raw, len);
+    buf[len] = '\0';
+}
+
+static bool has_suffix(const char* s, const char* suffix) {
+    size_t n = strlen(s), m = strlen(suffix);
+    return n > m && strcmp(s + n - m, suffix) == 0;
+}
+
+ImportFormat import_format(const char* path) {
+    if (has_suffix(path, ".json") || has_suffix(path, ".json.gz")) return IMPORT_JSON;
+    if (has_suffix(path, ".csv") || has_suffix(path, ".csv.gz")) return IMPORT_CSV;
+    if (has_suffix(path, ".db") || has_suffix(path, ".sqlite") || has_suffix(path, ".sqlite3")) return IMPORT_SQLITE;
+    return IMPORT_UNSUPPORTED;
+}
+
+bool import_is_pattern(const char* path) {
+    return strpbrk(path, "*?[") != NULL;
+}
+
+bool import_is_gzip(const char* path) {
+    return has_suffix(path, ".gz");
+}
+
+static ssize_t gz_read(void* cookie, char* buf, size_t size) {
+    return gzread((gzFile)cookie, buf, size > INT_MAX ? INT_MAX : (unsigned)size);
+}
+
+static int gz_close(void* cookie) {
+    return gzclose((gzFile)cookie) == Z_OK ? 0 : EOF;
+}
+
+// gzread passes files that are not gzip through unchanged, so every import
+// is read this way and decompressed as it is scanned
+static FILE* open_data_file(const char* path) {
+    gzFile gz = gzopen(path, "rb");
+    if (!gz) return NULL;
+    cookie_io_functions_t io = { gz_read, NULL, NULL, gz_close };
+    FILE* f = fopencookie(gz, "r", io);
+    if (!f) gzclose(gz);
+    return f;
+}
+
+static void add_column(ImportSchema* schema, const char* name, TypeInfo type) {
+    schema->columns = realloc(schema->columns, (schema->count + 1) * sizeof(ImportColumn));
+    schema->columns[schema->count].name = strdup(name);
+    schema->columns[schema->count].type = type;
+    schema->count++;
+}
+
+const ImportColumn* find_import_column(const ImportSchema* schema, const char* name) {
+    for (int i = 0; i < schema->count; i++)
+        if (strcmp(schema->columns[i].name, name) == 0) return &schema->columns[i];
+    return NULL;
+}
+
+void free_import_schema(ImportSchema* schema) {
+    for (int i = 0; i < schema->count; i++)
+        free(schema->columns[i].name);
+    free(schema->columns);
+    schema->columns = NULL;
+    schema->count = 0;
+}
+
+// ---------------------------------------------------------------------------
+// CSV
+// ---------------------------------------------------------------------------
+
+// Splits one CSV record in place (double quotes group, "" escapes a quote)
+static int split_csv_line(char* line, char** fields, int max_fields) {
+    int n = 0;
+    char* p = line;
+    while (n < max_fields) {
+        char* out = p;
+        fields[n++] = p;
+        bool quoted = false;
+        while (*p && (quoted || *p != ',')) {
+            if (*p == '"') {
+                if (quoted && p[1] == '"') { *out++ = '"'; p += 2; continue; }
+                quoted = !quoted;
+                p++;
+                continue;
+            }
+            *out++ = *p++;
+        }
+        bool more = *p == ',';
+        if (*p) p++;
+        *out = '\0';
+        if (!more) break;
+    }
+    return n;
+}
+
+static void chomp(char* line) {
+    size_t len = strlen(line);
+    while (len > 0 && (line[len-1] == '\n' || line[len-1] == '\r')) line[--len] = '\0';
+}
+
+// Classifies a cell the way Python's int()/float() would accept it
+static ElemType cell_type(const char* cell) {
+    while (isspace((unsigned char)*cell)) cell++;
+    if (!*cell) return DTYPE_NONE;
+    char* end;
+    strtol(cell, &end, 10);
+    while (isspace((unsigned char)*end)) end++;
+    if (!*end) return DTYPE_INT;
+    strtod(cell, &end);
+    while (isspace((unsigned char)*end)) end++;
+    return *end ? DTYPE_NONE : DTYPE_FLOAT;
+}
+
+// *sampled is the number of rows the types come from
+static bool read_csv_schema(FILE* f, ImportSchema* schema, int* sampled) {
+    static char line[1 << 16];
+    char* fields[CSV_MAX_COLUMNS];
+    if (!fgets(line, sizeof(line), f)) return false;
+    chomp(line);
+    int ncols = split_csv_line(line, fields, CSV_MAX_COLUMNS);
+    ElemType* types = calloc(ncols, sizeof(ElemType));
+    bool* numeric = malloc(ncols * sizeof(bool));
+    char** names = malloc(ncols * sizeof(char*));
+    for (int i = 0; i < ncols; i++) {
+        names[i] = strdup(fields[i]);
+        numeric[i] = true;
+    }
+
+    int rows = 0;
+    while (rows < CSV_SAMPLE_ROWS && fgets(line, sizeof(line), f)) {
+        chomp(line);
+        if (!line[0]) continue;                  // csv.DictReader skips blank rows
+        rows++;
+        int n = split_csv_line(line, fields, CSV_MAX_COLUMNS);
+        for (int i = 0; i < ncols; i++) {
+            ElemType t = i < n ? cell_type(fields[i]) : DTYPE_NONE;
+            if (t == DTYPE_NONE) numeric[i] = false;
+            else if (t == DTYPE_FLOAT) types[i] = DTYPE_FLOAT;
+            else if (types[i] == DTYPE_NONE) types[i] = DTYPE_INT;
+        }
+    }
+    // Without rows to sample, every column is read as (empty) text
+    for (int i = 0; i < ncols; i++) {
+        TypeInfo t = rows > 0 && numeric[i]
+            ? type_of_kind(TYPE_VECTOR, types[i], -1, -1)
+            : type_of_kind(TYPE_STRING_VECTOR, DTYPE_NONE, -1, -1);
+        add_column(schema, names[i], t);
+        free(names[i]);
+    }
+    free(names);
+    free(types);
+    free(numeric);
+    *sampled = rows;
+    return true;
+}
+
+// Columns of every file `pattern` matches (in name order, as the generated
+// code concatenates them): those of the first file that all files have,
+// typed like one column holding the samples of every file that has rows
+static bool read_csv_pattern_schema(const char* pattern, ImportSchema* schema) {
+    glob_t g;
+    if (glob(pattern, 0, NULL, &g) != 0) return false;
+    bool ok = true, sampled = false;
+    for (size_t i = 0; ok && i < g.gl_pathc; i++) {
+        ImportSchema part = { IMPORT_CSV, false, 0, NULL };
+        int rows = 0;
+        FILE* f = open_data_file(g.gl_pathv[i]);
+        ok = f && read_csv_schema(f, &part, &rows);
+        if (f) fclose(f);
+        for (int c = 0; ok && c < (i ? schema->count : part.count); c++) {
+            if (i == 0) {
+                add_column(schema, part.columns[c].name, part.columns[c].type);
+                continue;
+            }
+            ImportColumn* col = &schema->columns[c];
+            const ImportColumn* other = find_import_column(&part, col->name);
+            if (!other) {
+                // Not in every file: dropped, so the name stays unbound
+                free(col->name);
+                memmove(col, col + 1, (schema->count - c - 1) * sizeof(ImportColumn));
+                schema->count--;
+                c--;
+            } else if (rows > 0 && sampled) {
+                TypeInfo a = col->type, b = other->type;
+                bool numeric = a.kind == TYPE_VECTOR && b.kind == TYPE_VECTOR;
+                ElemType dtype = a.dtype == DTYPE_FLOAT || b.dtype == DTYPE_FLOAT ? DTYPE_FLOAT : DTYPE_INT;
+                col->type = numeric ? type_of_kind(TYPE_VECTOR, dtype, -1, -1)
+                                    : type_of_kind(TYPE_STRING_VECTOR, DTYPE_NONE, -1, -1);
+            } else if (rows > 0) {
+                col->type = other->type;
+            }
+        }
+        sampled |= rows > 0;
+        free_import_schema(&part);
+    }
+    globfree(&g);
+    if (!ok) free_import_schema(schema);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// JSON
+//
+// A small streaming scanner: values are classified and skipped, never
+// materialised, so large files only cost one sequential read.
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    FILE* f;
+    int c;       // one character of lookahead
+} JsonReader;
+
+static void jr_advance(JsonReader* r) { r->c = fgetc(r->f); }
+
+static void jr_skip_ws(JsonReader* r) {
+    while (r->c != EOF && isspace(r->c)) jr_advance(r);
+}
+
+// Reads a string token, keeping up to size-1 bytes of it in buf (may be NULL)
+static bool jr_string(JsonReader* r, char* buf, size_t size) {
+    size_t n = 0;
+    if (r->c != '"') return false;
+    jr_advance(r);
+    while (r->c != EOF && r->c != '"') {
+        int ch = r->c;
+        if (ch == '\\') {
+            jr_advance(r);
+            ch = r->c;
+            if (ch == EOF) return false;
+        }
+        if (buf && n + 1 < size) buf[n++] = (char)ch;
+        jr_advance(r);
+    }
+    if (buf) buf[n] = '\0';
+    if (r->c != '"') return false;
+    jr_advance(r);
+    return true;
+}
+
+static bool jr_value(JsonReader* r, TypeInfo* type, int depth);
+
+// Element types of an array: numbers -> vector, strings -> string vector,
+// equally sized numeric vectors -> matrix
+static bool jr_array(JsonReader* r, TypeInfo* type, int depth) {
+    jr_advance(r);   // '['
+    jr_skip_ws(r);
+    long count = 0;
+    TypeInfo elem = type_none();
+    if (r->c == ']') {
+        jr_advance(r);
+        *type = type_of_kind(TYPE_VECTOR, DTYPE_NONE, 0, -1);
+        return true;
+    }
+    for (;;) {
+        TypeInfo t;
+        if (!jr_value(r, &t, depth + 1)) return false;
+        elem = count == 0 ? t : type_join(elem, t);
+        count++;
+        jr_skip_ws(r);
+        if (r->c == ',') { jr_advance(r); continue; }
+        if (r->c == ']') { jr_advance(r); break; }
+        return false;
+    }
+    if (elem.kind == TYPE_NUMBER)
+        *type = type_of_kind(TYPE_VECTOR, elem.dtype, count, -1);
+    else if (elem.kind == TYPE_STRING)
+        *type = type_of_kind(TYPE_STRING_VECTOR, DTYPE_NONE, count, -1);
+    else if (elem.kind == TYPE_VECTOR)
+        *type = type_of_kind(TYPE_MATRIX, elem.dtype, count, elem.length);
+    else
+        *type = type_unknown();
+    return true;
+}
+
+static bool jr_object(JsonReader* r, ImportSchema* top, int depth) {
+    jr_advance(r);   // '{'
+    jr_skip_ws(r);
+    if (r->c == '}') { jr_advance(r); return true; }
+    for (;;) {
+        char key[SCHEMA_NAME_MAX];
+        jr_skip_ws(r);
+        if (!jr_string(r, key, sizeof(key))) return false;
+        jr_skip_ws(r);
+        if (r->c != ':') return false;
+        jr_advance(r);
+        TypeInfo t;
+        if (!jr_value(r, &t, depth + 1)) return false;
+        if (top) add_column(top, key, t);
+        jr_skip_ws(r);
+        if (r->c == ',') { jr_advance(r); continue; }
+        if (r->c == '}') { jr_advance(r); return true; }
+        return false;
+    }
+}
+
+static bool jr_value(JsonReader* r, TypeInfo* type, int depth) {
+    if (depth > 64) return false;
+    jr_skip_ws(r);
+    if (r->c == '{') {
+        *type = type_unknown();
+        return jr_object(r, NULL, depth);
+    }
+    if (r->c == '[') return jr_array(r, type, depth);
+    if (r->c == '"') {
+        *type = type_of_kind(TYPE_STRING, DTYPE_NONE, 1, -1);
+        return jr_string(r, NULL, 0);
+    }
+    if (r->c == '-' || isdigit(r->c)) {
+        ElemType dtype = DTYPE_INT;
+        while (r->c == '-' || r->c == '+' || r->c == '.' || r->c == 'e' || r->c == 'E' || isdigit(r->c)) {
+            if (r->c == '.' || r->c == 'e' || r->c == 'E') dtype = DTYPE_FLOAT;
+            jr_advance(r);
+        }
+        if (r->c == 'I') return jr_value(r, type, depth);   // -Infinity
+        *type = type_number(dtype);
+        return true;
+    }
+    if (isalpha(r->c)) {
+        // true / false / null, and NaN / Infinity as Python writes them
+        char word[9];
+        int n = 0;
+        while (isalpha(r->c) && n < 8) { word[n++] = (char)r->c; jr_advance(r); }
+        word[n] = '\0';
+        if (strcmp(word, "null") == 0) *type = type_unknown();
+        else if (strcmp(word, "NaN") == 0 || strcmp(word, "Infinity") == 0) *type = type_number(DTYPE_FLOAT);
+        else *type = type_number(DTYPE_INT);
+        return true;
+    }
+    return false;
+}
+
+static bool read_json_schema(FILE* f, ImportSchema* schema) {
+    JsonReader r = { f, 0 };
+    jr_advance(&r);
+    jr_skip_ws(&r);
+    // Only a top-level object binds variables
+    if (r.c != '{') return false;
+    if (!jr_object(&r, schema, 0)) {
+        free_import_schema(schema);
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// SQLite
+// ---------------------------------------------------------------------------
+
+// Column types follow the storage classes of a sample of rows, as the loader
+// types whole columns: all INTEGER -> int vector, INTEGER/REAL -> float
+// vector, all TEXT -> string vector; NULLs and blobs leave a plain list
+static bool read_sqlite_schema(const char* path, const char* table, ImportSchema* schema) {
+    sqlite3* db;
+    if (sqlite3_open_v2(path, &db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) {
+        sqlite3_close(db);
+        return false;
+    }
+    char* sql = sqlite3_mprintf("SELECT * FROM \"%w\" LIMIT %d", table, CSV_SAMPLE_ROWS);
+    sqlite3_stmt* stmt = NULL;
+    bool ok = sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) == SQLITE_OK;
+    sqlite3_free(sql);
+    int ncols = ok ? sqlite3_column_count(stmt) : 0;
+    unsigned* seen = calloc(ncols > 0 ? ncols : 1, sizeof(unsigned));   // bit per storage class
+    int rows = 0;
+    while (ok && sqlite3_step(stmt) == SQLITE_ROW) {
+        rows++;
+        for (int i = 0; i < ncols; i++)
+            seen[i] |= 1u << sqlite3_column_type(stmt, i);
+    }
+    for (int i = 0; i < ncols; i++) {
+        TypeInfo t = type_unknown();
+        if (rows == 0 || seen[i] == 1u << SQLITE_TEXT)
+            t = type_of_kind(TYPE_STRING_VECTOR, DTYPE_NONE, -1, -1);
+        else if (seen[i] == 1u << SQLITE_INTEGER)
+            t = type_of_kind(TYPE_VECTOR, DTYPE_INT, -1, -1);
+        else if ((seen[i] & ~(1u << SQLITE_INTEGER | 1u << SQLITE_FLOAT)) == 0)
+            t = type_of_kind(TYPE_VECTOR, DTYPE_FLOAT, -1, -1);
+        add_column(schema, sqlite3_column_name(stmt, i), t);
+    }
+    free(seen);
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return ok;
+}
+
+bool read_import_schema(const char* path, const char* table, ImportSchema* schema) {
+    schema->format = import_format(path);
+    schema->known = false;
+    schema->count = 0;
+    schema->columns = NULL;
+    if (schema->format == IMPORT_UNSUPPORTED) return false;
+    if (schema->format == IMPORT_SQLITE) {
+        schema->known = table && read_sqlite_schema(path, table, schema);
+        return schema->known;
+    }
+    if (import_is_pattern(path)) {
+        schema->known = schema->format == IMPORT_CSV && read_csv_pattern_schema(path, schema);
+        return schema->known;
+    }
+    // Opening a FIFO would wait for a writer, and reading it would take the
+    // rows from output.py
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISFIFO(st.st_mode)) return false;
+    FILE* f = open_data_file(path);
+    if (!f) return false;
+    int rows;
+    schema->known = schema->format == IMPORT_JSON ? read_json_schema(f, schema) : read_csv_schema(f, schema, &rows);
+    fclose(f);
+    return schema->known;
+}
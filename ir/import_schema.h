@@ -0,0 +1,51 @@
+#ifndef IMPORT_SCHEMA_H
+#define IMPORT_SCHEMA_H
+#include <stdbool.h>
+#include <stddef.h>
+#include "types.h"
+
+typedef enum {
+    IMPORT_JSON,
+    IMPORT_CSV,
+    IMPORT_SQLITE,           // a table of the database, see import.table
+    IMPORT_UNSUPPORTED
+} ImportFormat;
+
+// Content type of one column (CSV, SQLite) or top-level key (JSON) of a data file
+typedef struct {
+    char* name;
+    TypeInfo type;
+} ImportColumn;
+
+// What the compiler could learn about an imported file at compile time
+typedef struct {
+    ImportFormat format;
+    bool known;              // the file was readable when compiling
+    int count;
+    ImportColumn* columns;
+} ImportSchema;
+
+// Strips the quotes the lexer keeps around an import file name
+void import_path(const char* raw, char* buf, size_t size);
+
+// By suffix: .json or .csv, optionally gzip-compressed (.json.gz, .csv.gz),
+// or a SQLite database (.db, .sqlite, .sqlite3)
+ImportFormat import_format(const char* path);
+
+// A CSV file name with wildcards (*, ?, [...]), e.g. "logs/*.csv", imports
+// the rows of every file it matches, concatenated
+bool import_is_pattern(const char* path);
+
+// A .csv.gz or .json.gz file (or a pattern only such files match)
+bool import_is_gzip(const char* path);
+
+// Reads the CSV header (plus a sample of rows for types), the JSON top-level
+// keys or the columns of SQLite `table` of `path` (table is NULL for files).
+// A pattern is read as the concatenation of the files it matches; none
+// matching leaves it unknown. Returns schema->known.
+bool read_import_schema(const char* path, const char* table, ImportSchema* schema);
+void free_import_schema(ImportSchema* schema);
+
+const ImportColumn* find_import_column(const ImportSchema* schema, const char* name);
+
+#endif
@@ -0,0 +1,244 @@
+#include <stdlib.h>
+#include "liveness.h"
+#include "builtins.h"
+
+void collect_expr_uses(ASTNode* expr, NameSet* uses) {
+    if (!expr) return;
+    switch (expr->type) {
+        case NODE_ID:
+            nameset_add(uses, expr->id_name);
+            break;
+        case NODE_BINARY_OP:
+            // Keyword arguments (key=value) only read the value
+            if (expr->binary_op.op != OP_ASSIGN)
+                collect_expr_uses(expr->binary_op.left, uses);
+            collect_expr_uses(expr->binary_op.right, uses);
+            break;
+        case NODE_VECTOR_LITERAL:
+            for (ASTList* e = expr->vector_literal.elements; e; e = e->next)
+                collect_expr_uses(e->node, uses);
+            break;
+        case NODE_FUNCTION_CALL:
+            for (ASTList* a = expr->function_call.args; a; a = a->next)
+                collect_expr_uses(a->node, uses);
+            break;
+        default:
+            break;
+    }
+}
+
+static void collect_list_uses(ASTList* stmts, NameSet* uses) {
+    for (ASTList* s = stmts; s; s = s->next)
+        collect_stmt_uses(s->node, uses);
+}
+
+void collect_stmt_uses(ASTNode* stmt, NameSet* uses) {
+    if (!stmt) return;
+    switch (stmt->type) {
+        case NODE_ASSIGNMENT:
+            collect_expr_uses(stmt->assignment.expr, uses);
+            break;
+        case NODE_FUNCTION_CALL:
+            collect_expr_uses(stmt, uses);
+            break;
+        case NODE_VIZ_CALL:
+            for (ASTList* a = stmt->viz_call.args; a; a = a->next)
+                collect_expr_uses(a->node, uses);
+            break;
+        case NODE_EXPORT:
+            for (ASTList* n = stmt->export.names; n; n = n->next)
+                collect_expr_uses(n->node, uses);
+            break;
+        case NODE_IF_ELSE:
+            collect_expr_uses(stmt->if_else.condition, uses);
+            collect_list_uses(stmt->if_else.if_body, uses);
+            collect_list_uses(stmt->if_else.else_body, uses);
+            break;
+        case NODE_WHILE_LOOP:
+            collect_expr_uses(stmt->while_loop.condition, uses);
+            collect_list_uses(stmt->while_loop.body, uses);
+            break;
+        case NODE_FOR_LOOP:
+            collect_stmt_uses(stmt->for_loop.init, uses);
+            collect_expr_uses(stmt->for_loop.condition, uses);
+            collect_stmt_uses(stmt->for_loop.increment, uses);
+            collect_list_uses(stmt->for_loop.body, uses);
+            break;
+        default:
+            break;
+    }
+}
+
+void collect_list_defs(ASTList* stmts, NameSet* defs) {
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        switch (n->type) {
+            case NODE_ASSIGNMENT:
+                nameset_add(defs, n->assignment.var_name);
+                break;
+            case NODE_IF_ELSE:
+                collect_list_defs(n->if_else.if_body, defs);
+                collect_list_defs(n->if_else.else_body, defs);
+                break;
+            case NODE_WHILE_LOOP:
+                collect_list_defs(n->while_loop.body, defs);
+                break;
+            case NODE_FOR_LOOP:
+                nameset_add(defs, n->for_loop.init->assignment.var_name);
+                nameset_add(defs, n->for_loop.increment->assignment.var_name);
+                collect_list_defs(n->for_loop.body, defs);
+                break;
+            case NODE_RELEASE:
+                nameset_add(defs, n->release.var_name);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// Arithmetic and built-in calls are treated as pure: a runtime error they might
+// raise is not considered an observable effect worth preserving.
+bool expr_is_pure(ASTNode* expr) {
+    if (!expr) return true;
+    switch (expr->type) {
+        case NODE_NUMBER:
+        case NODE_ID:
+        case NODE_STRING:
+            return true;
+        case NODE_BINARY_OP:
+            return expr_is_pure(expr->binary_op.left) && expr_is_pure(expr->binary_op.right);
+        case NODE_VECTOR_LITERAL:
+            for (ASTList* e = expr->vector_literal.elements; e; e = e->next)
+                if (!expr_is_pure(e->node)) return false;
+            return true;
+        case NODE_FUNCTION_CALL: {
+            const BuiltinInfo* info = lookup_builtin(expr->function_call.func_name);
+            if (!info || !info->pure) return false;
+            for (ASTList* a = expr->function_call.args; a; a = a->next)
+                if (!expr_is_pure(a->node)) return false;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool list_has_opaque_code(ASTList* stmts) {
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        switch (n->type) {
+            case NODE_AUX_BLOCK:
+                return true;
+            case NODE_IF_ELSE:
+                if (list_has_opaque_code(n->if_else.if_body) ||
+                    list_has_opaque_code(n->if_else.else_body)) return true;
+                break;
+            case NODE_WHILE_LOOP:
+                if (list_has_opaque_code(n->while_loop.body)) return true;
+                break;
+            case NODE_FOR_LOOP:
+                if (list_has_opaque_code(n->for_loop.body)) return true;
+                break;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+bool list_has_import(ASTList* stmts) {
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        if (n->type == NODE_IMPORT) return true;
+        if (n->type == NODE_IF_ELSE && (list_has_import(n->if_else.if_body) || list_has_import(n->if_else.else_body))) return true;
+        if (n->type == NODE_WHILE_LOOP && list_has_import(n->while_loop.body)) return true;
+        if (n->type == NODE_FOR_LOOP && list_has_import(n->for_loop.body)) return true;
+    }
+    return false;
+}
+
+bool list_has_live_import(ASTList* stmts) {
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        if (n->type == NODE_IMPORT && n->import.live) return true;
+        if (n->type == NODE_IF_ELSE && (list_has_live_import(n->if_else.if_body) || list_has_live_import(n->if_else.else_body))) return true;
+        if (n->type == NODE_WHILE_LOOP && list_has_live_import(n->while_loop.body)) return true;
+        if (n->type == NODE_FOR_LOOP && list_has_live_import(n->for_loop.body)) return true;
+    }
+    return false;
+}
+
+void live_through_list(ASTList* stmts, NameSet* live) {
+    if (!stmts) return;
+    live_through_list(stmts->next, live);
+    live_through_stmt(stmts->node, live);
+}
+
+void loop_live_in(ASTNode* cond, ASTList* body, ASTNode* incr, const NameSet* live_out, NameSet* result) {
+    NameSet next;
+    nameset_init(&next);
+    nameset_copy(result, live_out);
+    collect_expr_uses(cond, result);
+    // Iterate to a fixpoint over the back edge
+    for (;;) {
+        nameset_copy(&next, result);
+        live_through_stmt(incr, &next);
+        live_through_list(body, &next);
+        collect_expr_uses(cond, &next);
+        nameset_union(&next, live_out);
+        if (nameset_equal(&next, result)) break;
+        nameset_copy(result, &next);
+    }
+    nameset_free(&next);
+}
+
+void live_through_stmt(ASTNode* stmt, NameSet* live) {
+    if (!stmt) return;
+    switch (stmt->type) {
+        case NODE_ASSIGNMENT:
+            nameset_remove(live, stmt->assignment.var_name);
+            collect_expr_uses(stmt->assignment.expr, live);
+            break;
+        case NODE_FUNCTION_CALL:
+        case NODE_VIZ_CALL:
+        case NODE_EXPORT:
+            collect_stmt_uses(stmt, live);
+            break;
+        case NODE_IF_ELSE: {
+            NameSet else_live;
+            nameset_init(&else_live);
+            nameset_copy(&else_live, live);
+            live_through_list(stmt->if_else.if_body, live);
+            live_through_list(stmt->if_else.else_body, &else_live);
+            nameset_union(live, &else_live);
+            collect_expr_uses(stmt->if_else.condition, live);
+            nameset_free(&else_live);
+            break;
+        }
+        case NODE_WHILE_LOOP: {
+            NameSet head;
+            nameset_init(&head);
+            loop_live_in(stmt->while_loop.condition, stmt->while_loop.body, NULL, live, &head);
+            nameset_copy(live, &head);
+            nameset_free(&head);
+            break;
+        }
+        case NODE_FOR_LOOP: {
+            NameSet head;
+            nameset_init(&head);
+            loop_live_in(stmt->for_loop.condition, stmt->for_loop.body, stmt->for_loop.increment, live, &head);
+            nameset_copy(live, &head);
+            nameset_free(&head);
+            live_through_stmt(stmt->for_loop.init, live);
+            break;
+        }
+        default:
+            // Imports bind names dynamically but read nothing
+            break;
+    }
+}
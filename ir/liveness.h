@@ -0,0 +1,38 @@
+#ifndef LIVENESS_H
+#define LIVENESS_H
+#include <stdbool.h>
+#include "ast.h"
+#include "symbol_table.h"
+
+// Adds every variable read by an expression to uses
+void collect_expr_uses(ASTNode* expr, NameSet* uses);
+
+// Adds every variable read anywhere inside a statement (including nested bodies)
+void collect_stmt_uses(ASTNode* stmt, NameSet* uses);
+
+// Adds every variable assigned anywhere inside a statement list
+void collect_list_defs(ASTList* stmts, NameSet* defs);
+
+// True if evaluating the expression has no observable side effects
+bool expr_is_pure(ASTNode* expr);
+
+// True if the statements contain code the analyses cannot see into (aux blocks)
+bool list_has_opaque_code(ASTList* stmts);
+
+// True if the statements contain an import, which may rebind any name
+bool list_has_import(ASTList* stmts);
+
+// True if the statements contain a live import, after which output.py runs
+// statements again as rows are appended
+bool list_has_live_import(ASTList* stmts);
+
+// Backward liveness transfer: `live` holds the live-out set on entry
+// and the live-in set on return.
+void live_through_stmt(ASTNode* stmt, NameSet* live);
+void live_through_list(ASTList* stmts, NameSet* live);
+
+// Live-in set at the head of a loop `while (cond) { body; incr }` given the
+// set live after the loop. incr may be NULL.
+void loop_live_in(ASTNode* cond, ASTList* body, ASTNode* incr, const NameSet* live_out, NameSet* result);
+
+#endif
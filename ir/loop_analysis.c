@@ -0,0 +1,79 @@
+#include <string.h>
+#include <math.h>
+#include "loop_analysis.h"
+#include "liveness.h"
+#include "symbol_table.h"
+
+static bool is_var(ASTNode* node, const char* name) {
+    return node && node->type == NODE_ID && strcmp(node->id_name, name) == 0;
+}
+
+bool is_integer_literal(ASTNode* node, long* value) {
+    if (!node || node->type != NODE_NUMBER) return false;
+    double v = node->num_value;
+    if (v != floor(v) || fabs(v) > 1e15) return false;
+    if (value) *value = (long)v;
+    return true;
+}
+
+// Matches `i = i + c`, `i = c + i` and `i = i - c`
+static bool match_step(ASTNode* incr, const char* var, long* step) {
+    if (!incr || incr->type != NODE_ASSIGNMENT || strcmp(incr->assignment.var_name, var) != 0) return false;
+    ASTNode* e = incr->assignment.expr;
+    if (!e || e->type != NODE_BINARY_OP) return false;
+    long c;
+    if (e->binary_op.op == OP_PLUS) {
+        if (is_var(e->binary_op.left, var) && is_integer_literal(e->binary_op.right, &c)) { *step = c; return c != 0; }
+        if (is_var(e->binary_op.right, var) && is_integer_literal(e->binary_op.left, &c)) { *step = c; return c != 0; }
+    } else if (e->binary_op.op == OP_MINUS) {
+        if (is_var(e->binary_op.left, var) && is_integer_literal(e->binary_op.right, &c)) { *step = -c; return c != 0; }
+    }
+    return false;
+}
+
+// Matches `i < b` / `b > i` for ascending loops and `i > b` / `b < i` for descending ones
+static ASTNode* match_bound(ASTNode* cond, const char* var, long step) {
+    if (!cond || cond->type != NODE_BINARY_OP) return NULL;
+    BinaryOpType op = cond->binary_op.op;
+    ASTNode* l = cond->binary_op.left;
+    ASTNode* r = cond->binary_op.right;
+    if (step > 0) {
+        if (op == OP_LT && is_var(l, var)) return r;
+        if (op == OP_GT && is_var(r, var)) return l;
+    } else {
+        if (op == OP_GT && is_var(l, var)) return r;
+        if (op == OP_LT && is_var(r, var)) return l;
+    }
+    return NULL;
+}
+
+bool match_counted_loop(ASTNode* loop, CountedLoop* info) {
+    if (!loop || loop->type != NODE_FOR_LOOP) return false;
+    ASTNode* init = loop->for_loop.init;
+    const char* var = init->assignment.var_name;
+    long start, step;
+    if (!is_integer_literal(init->assignment.expr, &start)) return false;
+    if (!match_step(loop->for_loop.increment, var, &step)) return false;
+    ASTNode* bound = match_bound(loop->for_loop.condition, var, step);
+    if (!bound || !expr_is_pure(bound)) return false;
+
+    // The body must leave both the loop variable and the bound alone
+    NameSet defs, bound_uses;
+    nameset_init(&defs);
+    nameset_init(&bound_uses);
+    collect_list_defs(loop->for_loop.body, &defs);
+    collect_expr_uses(bound, &bound_uses);
+    bool ok = !nameset_contains(&defs, var) && !nameset_contains(&bound_uses, var)
+              && !list_has_import(loop->for_loop.body);
+    for (int i = 0; ok && i < bound_uses.count; i++)
+        if (nameset_contains(&defs, bound_uses.names[i])) ok = false;
+    nameset_free(&defs);
+    nameset_free(&bound_uses);
+    if (!ok) return false;
+
+    info->var = var;
+    info->start = start;
+    info->step = step;
+    info->bound = bound;
+    return true;
+}
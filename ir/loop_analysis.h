@@ -0,0 +1,21 @@
+#ifndef LOOP_ANALYSIS_H
+#define LOOP_ANALYSIS_H
+#include <stdbool.h>
+#include "ast.h"
+
+// A for loop of the shape `for (i = a; i < b; i = i + c)` (or the descending
+// form with `>` and `-`) where a and c are integer literals, the body never
+// assigns i and b does not change while the loop runs.
+typedef struct {
+    const char* var;
+    long start;
+    long step;        // non-zero; negative for descending loops
+    ASTNode* bound;   // exclusive bound, evaluated once
+} CountedLoop;
+
+bool match_counted_loop(ASTNode* loop, CountedLoop* info);
+
+// True if the node is a number literal holding an integer value
+bool is_integer_literal(ASTNode* node, long* value);
+
+#endif
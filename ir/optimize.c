@@ -0,0 +1,576 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "optimize.h"
+#include "liveness.h"
+#include "builtins.h"
+#include "loop_analysis.h"
+#include "vectorize.h"
+
+// ---------------------------------------------------------------------------
+// Dead code elimination
+//
+// Walks each statement list backwards with the set of variables that are live
+// after the current statement, dropping pure assignments whose target is dead
+// and pure calls whose result is discarded. Loops use the fixpoint live set at
+// their head so values carried around the back edge are kept.
+// ---------------------------------------------------------------------------
+
+static ASTList* dce_list(ASTList* stmts, NameSet* live, bool* changed);
+
+// Returns true if the statement can be removed; otherwise applies its
+// liveness transfer to `live` (and cleans up nested bodies).
+static bool dce_stmt(ASTNode* stmt, NameSet* live, bool* changed) {
+    switch (stmt->type) {
+        case NODE_ASSIGNMENT:
+            if (!nameset_contains(live, stmt->assignment.var_name) && expr_is_pure(stmt->assignment.expr))
+                return true;
+            break;
+        case NODE_FUNCTION_CALL:
+            if (expr_is_pure(stmt))
+                return true;
+            break;
+        case NODE_IF_ELSE: {
+            NameSet else_live;
+            nameset_init(&else_live);
+            nameset_copy(&else_live, live);
+            stmt->if_else.if_body = dce_list(stmt->if_else.if_body, live, changed);
+            stmt->if_else.else_body = dce_list(stmt->if_else.else_body, &else_live, changed);
+            nameset_union(live, &else_live);
+            nameset_free(&else_live);
+            if (!stmt->if_else.if_body && !stmt->if_else.else_body && expr_is_pure(stmt->if_else.condition))
+                return true;
+            collect_expr_uses(stmt->if_else.condition, live);
+            return false;
+        }
+        case NODE_WHILE_LOOP:
+        case NODE_FOR_LOOP: {
+            bool is_for = stmt->type == NODE_FOR_LOOP;
+            ASTNode* cond = is_for ? stmt->for_loop.condition : stmt->while_loop.condition;
+            ASTList** body = is_for ? &stmt->for_loop.body : &stmt->while_loop.body;
+            ASTNode* incr = is_for ? stmt->for_loop.increment : NULL;
+            NameSet head, body_out;
+            nameset_init(&head);
+            nameset_init(&body_out);
+            loop_live_in(cond, *body, incr, live, &head);
+            nameset_copy(&body_out, &head);
+            live_through_stmt(incr, &body_out);
+            *body = dce_list(*body, &body_out, changed);
+            nameset_copy(live, &head);
+            nameset_free(&head);
+            nameset_free(&body_out);
+            if (is_for) live_through_stmt(stmt->for_loop.init, live);
+            // Loops are never removed: doing so could change termination
+            return false;
+        }
+        default:
+            break;
+    }
+    live_through_stmt(stmt, live);
+    return false;
+}
+
+static ASTList* dce_list(ASTList* stmts, NameSet* live, bool* changed) {
+    if (!stmts) return NULL;
+    stmts->next = dce_list(stmts->next, live, changed);
+    if (stmts->node && dce_stmt(stmts->node, live, changed)) {
+        ASTList* next = stmts->next;
+        free(stmts);
+        *changed = true;
+        return next;
+    }
+    return stmts;
+}
+
+// A variable is faint when its value only ever flows into pure assignments to
+// itself (e.g. a counter `t = t + 1` nobody reads). Liveness alone keeps such
+// variables alive through the loop back edge, so they are found separately.
+static void collect_external_uses(ASTList* stmts, NameSet* external, NameSet* impure_defs) {
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        switch (n->type) {
+            case NODE_ASSIGNMENT: {
+                const char* target = n->assignment.var_name;
+                NameSet uses;
+                nameset_init(&uses);
+                collect_expr_uses(n->assignment.expr, &uses);
+                if (!expr_is_pure(n->assignment.expr)) nameset_add(impure_defs, target);
+                for (int i = 0; i < uses.count; i++) {
+                    if (strcmp(uses.names[i], target) != 0) nameset_add(external, uses.names[i]);
+                }
+                nameset_free(&uses);
+                break;
+            }
+            case NODE_IF_ELSE:
+                collect_expr_uses(n->if_else.condition, external);
+                collect_external_uses(n->if_else.if_body, external, impure_defs);
+                collect_external_uses(n->if_else.else_body, external, impure_defs);
+                break;
+            case NODE_WHILE_LOOP:
+                collect_expr_uses(n->while_loop.condition, external);
+                collect_external_uses(n->while_loop.body, external, impure_defs);
+                break;
+            case NODE_FOR_LOOP:
+                // The loop header is kept as is, so its variables count as used
+                nameset_add(external, n->for_loop.init->assignment.var_name);
+                nameset_add(external, n->for_loop.increment->assignment.var_name);
+                collect_stmt_uses(n->for_loop.init, external);
+                collect_expr_uses(n->for_loop.condition, external);
+                collect_stmt_uses(n->for_loop.increment, external);
+                collect_external_uses(n->for_loop.body, external, impure_defs);
+                break;
+            default:
+                collect_stmt_uses(n, external);
+                break;
+        }
+    }
+}
+
+static ASTList* remove_faint_assignments(ASTList* stmts, const NameSet* faint, bool* changed) {
+    if (!stmts) return NULL;
+    stmts->next = remove_faint_assignments(stmts->next, faint, changed);
+    ASTNode* n = stmts->node;
+    if (!n) return stmts;
+    switch (n->type) {
+        case NODE_ASSIGNMENT:
+            if (nameset_contains(faint, n->assignment.var_name)) {
+                ASTList* next = stmts->next;
+                free(stmts);
+                *changed = true;
+                return next;
+            }
+            break;
+        case NODE_IF_ELSE:
+            n->if_else.if_body = remove_faint_assignments(n->if_else.if_body, faint, changed);
+            n->if_else.else_body = remove_faint_assignments(n->if_else.else_body, faint, changed);
+            break;
+        case NODE_WHILE_LOOP:
+            n->while_loop.body = remove_faint_assignments(n->while_loop.body, faint, changed);
+            break;
+        case NODE_FOR_LOOP:
+            n->for_loop.body = remove_faint_assignments(n->for_loop.body, faint, changed);
+            break;
+        default:
+            break;
+    }
+    return stmts;
+}
+
+static bool eliminate_faint_variables(ASTNode* program) {
+    NameSet defs, external, impure_defs, faint;
+    nameset_init(&defs);
+    nameset_init(&external);
+    nameset_init(&impure_defs);
+    nameset_init(&faint);
+    collect_list_defs(program->program.statements, &defs);
+    collect_external_uses(program->program.statements, &external, &impure_defs);
+    for (int i = 0; i < defs.count; i++) {
+        if (!nameset_contains(&external, defs.names[i]) && !nameset_contains(&impure_defs, defs.names[i]))
+            nameset_add(&faint, defs.names[i]);
+    }
+    bool changed = false;
+    if (faint.count > 0)
+        program->program.statements = remove_faint_assignments(program->program.statements, &faint, &changed);
+    nameset_free(&defs);
+    nameset_free(&external);
+    nameset_free(&impure_defs);
+    nameset_free(&faint);
+    return changed;
+}
+
+static void eliminate_dead_code(ASTNode* program) {
+    // Aux blocks may read any variable; leave such programs alone
+    if (list_has_opaque_code(program->program.statements)) return;
+    NameSet live;
+    nameset_init(&live);
+    bool changed;
+    do {
+        changed = false;
+        nameset_clear(&live);
+        program->program.statements = dce_list(program->program.statements, &live, &changed);
+        if (eliminate_faint_variables(program)) changed = true;
+    } while (changed);
+    nameset_free(&live);
+}
+
+// ---------------------------------------------------------------------------
+// Loop-invariant code motion
+//
+// Pure built-in calls (and the maximal pure expressions around them) whose
+// operands are not assigned inside a while/for loop are computed once in a
+// preheader and read from a `_licm_<n>` temporary inside the loop. Invariant
+// parts of the loop condition are always evaluated, so they are hoisted as is;
+// body expressions are hoisted under `if <cond>:` so a loop that never runs
+// does not evaluate them. Preheaders of inner loops are themselves hoisted
+// when they are invariant in the enclosing loop.
+// ---------------------------------------------------------------------------
+
+#define LICM_PREFIX "_licm_"
+
+static int licm_counter = 0;
+
+static bool is_licm_temp(const char* name) {
+    return strncmp(name, LICM_PREFIX, strlen(LICM_PREFIX)) == 0;
+}
+
+static bool expr_has_builtin_call(ASTNode* expr) {
+    if (!expr) return false;
+    switch (expr->type) {
+        case NODE_BINARY_OP:
+            return expr_has_builtin_call(expr->binary_op.left) || expr_has_builtin_call(expr->binary_op.right);
+        case NODE_VECTOR_LITERAL:
+            for (ASTList* e = expr->vector_literal.elements; e; e = e->next)
+                if (expr_has_builtin_call(e->node)) return true;
+            return false;
+        case NODE_FUNCTION_CALL:
+            return lookup_builtin(expr->function_call.func_name) != NULL;
+        default:
+            return false;
+    }
+}
+
+static bool reads_none_of(ASTNode* expr, const NameSet* variant) {
+    NameSet uses;
+    nameset_init(&uses);
+    collect_expr_uses(expr, &uses);
+    bool ok = true;
+    for (int i = 0; i < uses.count && ok; i++)
+        if (nameset_contains(variant, uses.names[i])) ok = false;
+    nameset_free(&uses);
+    return ok;
+}
+
+static bool expr_is_invariant(ASTNode* expr, const NameSet* variant) {
+    return expr_is_pure(expr) && reads_none_of(expr, variant);
+}
+
+// Replaces maximal invariant subexpressions containing a built-in call with
+// temporaries, appending their definitions to *hoisted.
+static ASTNode* hoist_expr(ASTNode* expr, const NameSet* variant, ASTList** hoisted) {
+    if (!expr) return NULL;
+    if (expr->type != NODE_ID && expr_has_builtin_call(expr) && expr_is_invariant(expr, variant)) {
+        char name[32];
+        snprintf(name, sizeof(name), LICM_PREFIX "%d", ++licm_counter);
+        *hoisted = appendASTList(*hoisted, createAssignmentNode(name, expr));
+        return createIdNode(name);
+    }
+    switch (expr->type) {
+        case NODE_BINARY_OP:
+            if (expr->binary_op.op != OP_ASSIGN)
+                expr->binary_op.left = hoist_expr(expr->binary_op.left, variant, hoisted);
+            expr->binary_op.right = hoist_expr(expr->binary_op.right, variant, hoisted);
+            break;
+        case NODE_VECTOR_LITERAL:
+            for (ASTList* e = expr->vector_literal.elements; e; e = e->next)
+                e->node = hoist_expr(e->node, variant, hoisted);
+            break;
+        case NODE_FUNCTION_CALL:
+            for (ASTList* a = expr->function_call.args; a; a = a->next)
+                a->node = hoist_expr(a->node, variant, hoisted);
+            break;
+        default:
+            break;
+    }
+    return expr;
+}
+
+// A preheader statement created for an inner loop: a temporary definition or
+// a guard whose body only defines temporaries.
+static bool is_licm_stmt(ASTNode* stmt) {
+    if (stmt->type == NODE_ASSIGNMENT)
+        return is_licm_temp(stmt->assignment.var_name);
+    if (stmt->type == NODE_IF_ELSE && !stmt->if_else.else_body && stmt->if_else.if_body) {
+        for (ASTList* s = stmt->if_else.if_body; s; s = s->next)
+            if (!is_licm_stmt(s->node)) return false;
+        return true;
+    }
+    return false;
+}
+
+static bool licm_stmt_is_invariant(ASTNode* stmt, const NameSet* variant) {
+    if (stmt->type == NODE_ASSIGNMENT)
+        return expr_is_invariant(stmt->assignment.expr, variant);
+    if (!expr_is_invariant(stmt->if_else.condition, variant)) return false;
+    for (ASTList* s = stmt->if_else.if_body; s; s = s->next)
+        if (!licm_stmt_is_invariant(s->node, variant)) return false;
+    return true;
+}
+
+static void forget_licm_defs(ASTNode* stmt, NameSet* variant) {
+    if (stmt->type == NODE_ASSIGNMENT) {
+        nameset_remove(variant, stmt->assignment.var_name);
+        return;
+    }
+    for (ASTList* s = stmt->if_else.if_body; s; s = s->next)
+        forget_licm_defs(s->node, variant);
+}
+
+// Hoists out of one loop; returns the statements to place before it
+static ASTList* hoist_loop(ASTNode* loop) {
+    bool is_for = loop->type == NODE_FOR_LOOP;
+    ASTNode** cond = is_for ? &loop->for_loop.condition : &loop->while_loop.condition;
+    ASTList** body = is_for ? &loop->for_loop.body : &loop->while_loop.body;
+
+    // Imports inside the loop may rebind any name
+    if (list_has_import(*body)) return NULL;
+
+    NameSet variant;
+    nameset_init(&variant);
+    collect_list_defs(*body, &variant);
+    if (is_for) {
+        nameset_add(&variant, loop->for_loop.init->assignment.var_name);
+        nameset_add(&variant, loop->for_loop.increment->assignment.var_name);
+    }
+
+    ASTList* pre = NULL;       // evaluated unconditionally before the loop
+    ASTList* guarded = NULL;   // evaluated only if the loop runs at least once
+    *cond = hoist_expr(*cond, &variant, &pre);
+
+    // Guarding a for loop needs its init first, so only pure inits qualify
+    bool can_guard = !is_for || expr_is_pure(loop->for_loop.init->assignment.expr);
+    ASTList* kept = NULL;
+    for (ASTList* s = *body; s && can_guard; ) {
+        ASTList* next = s->next;
+        ASTNode* n = s->node;
+        s->next = NULL;
+        if (is_licm_stmt(n) && licm_stmt_is_invariant(n, &variant)) {
+            forget_licm_defs(n, &variant);
+            guarded = appendASTList(guarded, n);
+            free(s);
+            s = next;
+            continue;
+        }
+        switch (n->type) {
+            case NODE_ASSIGNMENT:
+                n->assignment.expr = hoist_expr(n->assignment.expr, &variant, &guarded);
+                break;
+            case NODE_FUNCTION_CALL:
+                for (ASTList* a = n->function_call.args; a; a = a->next)
+                    a->node = hoist_expr(a->node, &variant, &guarded);
+                break;
+            case NODE_VIZ_CALL:
+                for (ASTList* a = n->viz_call.args; a; a = a->next)
+                    a->node = hoist_expr(a->node, &variant, &guarded);
+                break;
+            case NODE_IF_ELSE:
+                n->if_else.condition = hoist_expr(n->if_else.condition, &variant, &guarded);
+                break;
+            default:
+                break;
+        }
+        if (!kept) kept = s;
+        else {
+            ASTList* tail = kept;
+            while (tail->next) tail = tail->next;
+            tail->next = s;
+        }
+        s = next;
+    }
+    if (can_guard) *body = kept;
+    nameset_free(&variant);
+
+    if (guarded) {
+        if (is_for) pre = appendASTList(pre, cloneAST(loop->for_loop.init));
+        pre = appendASTList(pre, createIfElseNode(cloneAST(*cond), guarded, NULL));
+    }
+    return pre;
+}
+
+static ASTList* licm_list(ASTList* stmts) {
+    ASTList* result = NULL;
+    ASTList* tail = NULL;
+    for (ASTList* s = stmts; s; ) {
+        ASTList* next = s->next;
+        ASTNode* n = s->node;
+        ASTList* pre = NULL;
+        if (n) {
+            switch (n->type) {
+                case NODE_IF_ELSE:
+                    n->if_else.if_body = licm_list(n->if_else.if_body);
+                    n->if_else.else_body = licm_list(n->if_else.else_body);
+                    break;
+                case NODE_WHILE_LOOP:
+                    n->while_loop.body = licm_list(n->while_loop.body);
+                    pre = hoist_loop(n);
+                    break;
+                case NODE_FOR_LOOP:
+                    n->for_loop.body = licm_list(n->for_loop.body);
+                    pre = hoist_loop(n);
+                    break;
+                default:
+                    break;
+            }
+        }
+        // Splice the preheader in front of the loop
+        s->next = NULL;
+        if (pre) {
+            if (tail) tail->next = pre; else result = pre;
+            tail = pre;
+            while (tail->next) tail = tail->next;
+        }
+        if (tail) tail->next = s; else result = s;
+        tail = s;
+        s = next;
+    }
+    return result;
+}
+
+static void hoist_loop_invariants(ASTNode* program) {
+    if (list_has_opaque_code(program->program.statements)) return;
+    program->program.statements = licm_list(program->program.statements);
+}
+
+// ---------------------------------------------------------------------------
+// Counted while loops
+//
+// `i = a; while (i < b) { ...; i = i + c; }` is the same loop as
+// `for (i = a; i < b; i = i + c) { ... }`. Rewriting it when it is a counted
+// loop lets the for-loop lowerings below apply to while loops too.
+// ---------------------------------------------------------------------------
+
+static ASTNode* while_as_counted_for(ASTNode* init, ASTNode* loop) {
+    if (init->type != NODE_ASSIGNMENT || !is_integer_literal(init->assignment.expr, NULL)) return NULL;
+    ASTList* body = loop->while_loop.body;
+    if (!body) return NULL;
+    ASTList* last = body;
+    ASTList* before_last = NULL;
+    while (last->next) {
+        before_last = last;
+        last = last->next;
+    }
+    ASTNode* incr = last->node;
+    if (!incr || incr->type != NODE_ASSIGNMENT || strcmp(incr->assignment.var_name, init->assignment.var_name) != 0)
+        return NULL;
+    ASTNode* candidate = createForNode(init, loop->while_loop.condition, incr, before_last ? body : NULL);
+    if (before_last) before_last->next = NULL;
+    CountedLoop info;
+    if (match_counted_loop(candidate, &info)) {
+        free(last);
+        return candidate;
+    }
+    // Not a counted loop: put the body back together
+    if (before_last) before_last->next = last;
+    free(candidate);
+    return NULL;
+}
+
+static ASTList* canonicalize_list(ASTList* stmts) {
+    ASTList* prev = NULL;
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        switch (n->type) {
+            case NODE_IF_ELSE:
+                n->if_else.if_body = canonicalize_list(n->if_else.if_body);
+                n->if_else.else_body = canonicalize_list(n->if_else.else_body);
+                break;
+            case NODE_WHILE_LOOP:
+                n->while_loop.body = canonicalize_list(n->while_loop.body);
+                break;
+            case NODE_FOR_LOOP:
+                n->for_loop.body = canonicalize_list(n->for_loop.body);
+                break;
+            default:
+                break;
+        }
+        if (n->type == NODE_WHILE_LOOP && prev && prev->node) {
+            ASTNode* loop = while_as_counted_for(prev->node, n);
+            if (loop) {
+                // The init assignment moves into the loop header
+                prev->node = loop;
+                prev->next = s->next;
+                free(s);
+                s = prev;
+            }
+        }
+        prev = s;
+    }
+    return stmts;
+}
+
+static void canonicalize_counted_whiles(ASTNode* program) {
+    program->program.statements = canonicalize_list(program->program.statements);
+}
+
+// ---------------------------------------------------------------------------
+// Counted loop lowering
+//
+// Marks for loops that match CountedLoop so codegen emits `for i in range()`
+// instead of the interpreted init/compare/increment sequence, and records
+// whether the loop variable's final value is read afterwards.
+// ---------------------------------------------------------------------------
+
+static bool lower_keep_all_finals = false;
+
+static void lower_list(ASTList* stmts, NameSet* live);
+
+static void lower_stmt(ASTNode* stmt, NameSet* live) {
+    switch (stmt->type) {
+        case NODE_IF_ELSE: {
+            NameSet else_live;
+            nameset_init(&else_live);
+            nameset_copy(&else_live, live);
+            lower_list(stmt->if_else.if_body, live);
+            lower_list(stmt->if_else.else_body, &else_live);
+            nameset_union(live, &else_live);
+            collect_expr_uses(stmt->if_else.condition, live);
+            nameset_free(&else_live);
+            break;
+        }
+        case NODE_WHILE_LOOP:
+        case NODE_FOR_LOOP: {
+            bool is_for = stmt->type == NODE_FOR_LOOP;
+            ASTNode* cond = is_for ? stmt->for_loop.condition : stmt->while_loop.condition;
+            ASTList* body = is_for ? stmt->for_loop.body : stmt->while_loop.body;
+            ASTNode* incr = is_for ? stmt->for_loop.increment : NULL;
+            NameSet head, body_out;
+            nameset_init(&head);
+            nameset_init(&body_out);
+            loop_live_in(cond, body, incr, live, &head);
+            nameset_copy(&body_out, &head);
+            live_through_stmt(incr, &body_out);
+            lower_list(body, &body_out);
+            CountedLoop info;
+            if (is_for && match_counted_loop(stmt, &info)) {
+                stmt->for_loop.counted = true;
+                stmt->for_loop.range_start = info.start;
+                stmt->for_loop.range_step = info.step;
+                stmt->for_loop.range_bound = info.bound;
+                stmt->for_loop.keep_final = lower_keep_all_finals || nameset_contains(live, info.var);
+            }
+            nameset_copy(live, &head);
+            nameset_free(&head);
+            nameset_free(&body_out);
+            if (is_for) live_through_stmt(stmt->for_loop.init, live);
+            break;
+        }
+        default:
+            live_through_stmt(stmt, live);
+            break;
+    }
+}
+
+static void lower_list(ASTList* stmts, NameSet* live) {
+    if (!stmts) return;
+    lower_list(stmts->next, live);
+    if (stmts->node) lower_stmt(stmts->node, live);
+}
+
+static void lower_counted_loops(ASTNode* program) {
+    NameSet live;
+    nameset_init(&live);
+    lower_keep_all_finals = list_has_opaque_code(program->program.statements);
+    lower_list(program->program.statements, &live);
+    nameset_free(&live);
+}
+
+void optimize_program(ASTNode* program) {
+    if (!program || program->type != NODE_PROGRAM) return;
+    eliminate_dead_code(program);
+    canonicalize_counted_whiles(program);
+    hoist_loop_invariants(program);
+    vectorize_loops(program);
+    lower_counted_loops(program);
+}
@@ -0,0 +1,8 @@
+#ifndef OPTIMIZE_H
+#define OPTIMIZE_H
+#include "ast.h"
+
+// Runs the AST-level optimisation passes over a NODE_PROGRAM in place
+void optimize_program(ASTNode* program);
+
+#endif
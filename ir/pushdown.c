@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pushdown.h"
+#include "semantic_checks.h"
+#include "liveness.h"
+
+// The language has no filter, so the predicate pushed into the query of a
+// table import is the row range of its slices: when every read of every
+// referenced column of the import is
+//   slice(x, lo, hi)     with integer literals 0 <= lo <= hi
+// and no statement assigns those columns, only rows [min lo, max hi) are
+// read, and generated code shifts the slice bounds by min lo.
+
+typedef struct {
+    const char* name;
+    int window;              // index into windows
+} Column;
+
+typedef struct {
+    RowWindow rows;
+    bool sliced;             // some slice was seen
+    bool rejected;
+} Window;
+
+static Window* windows = NULL;
+static int window_count = 0;
+static Column* columns = NULL;
+static int column_count = 0;
+
+static bool streq(const char* a, const char* b) {
+    return strcmp(a, b) == 0;
+}
+
+static Column* find_column(const char* name) {
+    for (int i = 0; i < column_count; i++)
+        if (streq(columns[i].name, name)) return &columns[i];
+    return NULL;
+}
+
+static void reject_name(const char* name) {
+    Column* c = find_column(name);
+    if (c) windows[c->window].rejected = true;
+}
+
+// ---------------------------------------------------------------------------
+// Imports
+// ---------------------------------------------------------------------------
+
+static void add_import(const char* path, const char* table, const ImportSchema* schema) {
+    windows = realloc(windows, (window_count + 1) * sizeof(Window));
+    Window* w = &windows[window_count];
+    memset(w, 0, sizeof(Window));
+    w->rows.path = strdup(path);
+    w->rows.table = table ? strdup(table) : NULL;
+    // Only table imports are queried; files bind their names as candidates
+    // too, so a column they rebind is rejected
+    w->rejected = schema->format != IMPORT_SQLITE;
+    for (int i = 0; i < schema->count; i++) {
+        const char* name = schema->columns[i].name;
+        Column* c = find_column(name);
+        if (c) {
+            windows[c->window].rejected = true;
+            w->rejected = true;
+            continue;
+        }
+        columns = realloc(columns, (column_count + 1) * sizeof(Column));
+        columns[column_count].name = name;
+        columns[column_count].window = window_count;
+        column_count++;
+    }
+    window_count++;
+}
+
+static void collect_imports(ASTList* stmts) {
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        switch (n->type) {
+            case NODE_IMPORT: {
+                char path[256];
+                import_path(n->import.filename, path, sizeof(path));
+                const ImportSchema* schema = find_import_schema(path, n->import.table);
+                if (schema) add_import(path, n->import.table, schema);
+                break;
+            }
+            case NODE_IF_ELSE:
+                collect_imports(n->if_else.if_body);
+                collect_imports(n->if_else.else_body);
+                break;
+            case NODE_WHILE_LOOP:
+                collect_imports(n->while_loop.body);
+                break;
+            case NODE_FOR_LOOP:
+                collect_imports(n->for_loop.body);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Uses
+// ---------------------------------------------------------------------------
+
+static bool row_index(ASTNode* e, long* value) {
+    if (!e || e->type != NODE_NUMBER || e->num_value < 0 || e->num_value != (long)e->num_value) return false;
+    *value = (long)e->num_value;
+    return true;
+}
+
+static void check_expr(ASTNode* e) {
+    if (!e) return;
+    switch (e->type) {
+        case NODE_ID:
+            reject_name(e->id_name);
+            break;
+        case NODE_BINARY_OP:
+            check_expr(e->binary_op.left);
+            check_expr(e->binary_op.right);
+            break;
+        case NODE_VECTOR_LITERAL:
+            for (ASTList* el = e->vector_literal.elements; el; el = el->next)
+                check_expr(el->node);
+            break;
+        case NODE_FUNCTION_CALL: {
+            ASTList* args = e->function_call.args;
+            long lo, hi;
+            Column* c = args && args->node->type == NODE_ID ? find_column(args->node->id_name) : NULL;
+            if (c && streq(e->function_call.func_name, "slice") && args->next && args->next->next
+                && !args->next->next->next && row_index(args->next->node, &lo)
+                && row_index(args->next->next->node, &hi) && lo <= hi) {
+                Window* w = &windows[c->window];
+                if (!w->sliced || lo < w->rows.start) w->rows.start = lo;
+                if (!w->sliced || hi > w->rows.stop) w->rows.stop = hi;
+                w->sliced = true;
+                break;
+            }
+            for (ASTList* a = args; a; a = a->next)
+                check_expr(a->node);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void check_list(ASTList* stmts);
+
+static void check_stmt(ASTNode* n) {
+    if (!n) return;
+    switch (n->type) {
+        case NODE_ASSIGNMENT:
+            reject_name(n->assignment.var_name);
+            check_expr(n->assignment.expr);
+            break;
+        case NODE_FUNCTION_CALL:
+            check_expr(n);
+            break;
+        case NODE_VIZ_CALL:
+            for (ASTList* a = n->viz_call.args; a; a = a->next)
+                check_expr(a->node);
+            break;
+        case NODE_EXPORT:
+            for (ASTList* e = n->export.names; e; e = e->next)
+                check_expr(e->node);
+            break;
+        case NODE_IF_ELSE:
+            check_expr(n->if_else.condition);
+            check_list(n->if_else.if_body);
+            check_list(n->if_else.else_body);
+            break;
+        case NODE_WHILE_LOOP:
+            check_expr(n->while_loop.condition);
+            check_list(n->while_loop.body);
+            break;
+        case NODE_FOR_LOOP:
+            check_stmt(n->for_loop.init);
+            check_expr(n->for_loop.condition);
+            check_stmt(n->for_loop.increment);
+            check_list(n->for_loop.body);
+            break;
+        default:
+            break;
+    }
+}
+
+static void check_list(ASTList* stmts) {
+    for (ASTList* s = stmts; s; s = s->next)
+        check_stmt(s->node);
+}
+
+void plan_pushdown(ASTNode* program) {
+    for (int i = 0; i < window_count; i++) {
+        free(windows[i].rows.path);
+        free(windows[i].rows.table);
+    }
+    free(windows);
+    free(columns);
+    windows = NULL;
+    columns = NULL;
+    window_count = column_count = 0;
+
+    // Aux code may read anything, and its imports are bound dynamically
+    ASTList* stmts = program->program.statements;
+    if (list_has_opaque_code(stmts)) return;
+    collect_imports(stmts);
+    check_list(stmts);
+}
+
+const RowWindow* find_row_window(const char* path, const char* table) {
+    for (int i = 0; i < window_count; i++) {
+        const Window* w = &windows[i];
+        if (w->sliced && !w->rejected && w->rows.table && table
+            && streq(w->rows.path, path) && streq(w->rows.table, table))
+            return &w->rows;
+    }
+    return NULL;
+}
+
+const RowWindow* column_row_window(const char* name) {
+    Column* c = find_column(name);
+    if (!c) return NULL;
+    const Window* w = &windows[c->window];
+    return w->sliced && !w->rejected ? &w->rows : NULL;
+}
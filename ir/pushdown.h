@@ -0,0 +1,25 @@
+#ifndef PUSHDOWN_H
+#define PUSHDOWN_H
+#include <stdbool.h>
+#include "ast.h"
+
+// Rows [start, stop) of a SQLite table import (`import "f.db" table "t";`),
+// the only ones the program reads: the query gets them with LIMIT/OFFSET
+typedef struct {
+    char* path;              // unquoted file name
+    char* table;
+    long start;
+    long stop;
+} RowWindow;
+
+// Decides which table imports are read as a window of rows. Needs the
+// results of analyze_types.
+void plan_pushdown(ASTNode* program);
+
+// The window read from `table` of `path`, or NULL for every row
+const RowWindow* find_row_window(const char* path, const char* table);
+
+// The window of the import binding `name`, or NULL
+const RowWindow* column_row_window(const char* name);
+
+#endif
@@ -0,0 +1,225 @@
+#include <stdlib.h>
+#include "release.h"
+#include "liveness.h"
+#include "semantic_checks.h"
+#include "symbol_table.h"
+
+// Releasing a value costs a statement (per iteration inside loops), so
+// vectors known to be this short are left alone.
+#define RELEASE_MIN_ELEMENTS 4096
+
+// A variable is released right after the statement that mentions it last on
+// a path. Inside loops that is only done for values that do not survive into
+// the next iteration; the others are released once after the loop. When a
+// value dies inside only one arm of an if, the other arm releases it on entry,
+// so every path drops it exactly once. `del` is used where the name is
+// definitely bound, `name = None` elsewhere so no path can raise NameError.
+
+static bool worth_releasing(const char* name) {
+    TypeInfo t = lookup_var_type(name);
+    switch (t.kind) {
+        case TYPE_NONE:
+        case TYPE_NUMBER:
+        case TYPE_STRING:
+            return false;
+        case TYPE_UNKNOWN:
+            return true;
+        default:
+            if (t.length < 0 || (t.kind == TYPE_MATRIX && t.columns < 0)) return true;
+            return (t.kind == TYPE_MATRIX ? t.length * t.columns : t.length) >= RELEASE_MIN_ELEMENTS;
+    }
+}
+
+static void collect_mentions(ASTList* stmts, NameSet* names) {
+    for (ASTList* s = stmts; s; s = s->next)
+        collect_stmt_uses(s->node, names);
+    collect_list_defs(stmts, names);
+}
+
+static bool list_mentions(ASTList* stmts, const char* name) {
+    NameSet names;
+    nameset_init(&names);
+    collect_mentions(stmts, &names);
+    bool found = nameset_contains(&names, name);
+    nameset_free(&names);
+    return found;
+}
+
+static void intersect(NameSet* dst, const NameSet* other) {
+    NameSet kept;
+    nameset_init(&kept);
+    for (int i = 0; i < dst->count; i++)
+        if (nameset_contains(other, dst->names[i])) nameset_add(&kept, dst->names[i]);
+    nameset_copy(dst, &kept);
+    nameset_free(&kept);
+}
+
+static void prepend_release(ASTList** head, const char* name, const NameSet* defined) {
+    ASTList* cell = createASTList(createReleaseNode(name, !nameset_contains(defined, name)));
+    cell->next = *head;
+    *head = cell;
+}
+
+static void release_list(ASTList** head, const NameSet* live_out, NameSet* defined, bool top_level);
+
+// Processes the bodies nested in `stmt` and updates `defined` for its effect.
+// Of the variables in `dead` (mentioned by stmt, dead after it), those not
+// already released inside are added to `after`.
+static void release_in_stmt(ASTNode* stmt, const NameSet* live_after, NameSet* defined,
+                            const NameSet* dead, NameSet* after) {
+    switch (stmt->type) {
+        case NODE_ASSIGNMENT:
+            nameset_add(defined, stmt->assignment.var_name);
+            nameset_union(after, dead);
+            break;
+        case NODE_RELEASE:
+            if (stmt->release.rebind) nameset_add(defined, stmt->release.var_name);
+            else nameset_remove(defined, stmt->release.var_name);
+            break;
+        case NODE_IF_ELSE: {
+            NameSet live_in, then_def, else_def;
+            nameset_init(&live_in);
+            nameset_copy(&live_in, live_after);
+            live_through_stmt(stmt, &live_in);
+            for (int i = 0; i < dead->count; i++) {
+                const char* v = dead->names[i];
+                bool in_then = list_mentions(stmt->if_else.if_body, v);
+                bool in_else = list_mentions(stmt->if_else.else_body, v);
+                if (!in_then && !in_else) {
+                    nameset_add(after, v);   // only the condition reads it
+                    continue;
+                }
+                // The arm that never touches a value read elsewhere drops it on entry
+                if (nameset_contains(&live_in, v)) {
+                    if (!in_then) prepend_release(&stmt->if_else.if_body, v, defined);
+                    if (!in_else) prepend_release(&stmt->if_else.else_body, v, defined);
+                }
+            }
+            nameset_init(&then_def);
+            nameset_init(&else_def);
+            nameset_copy(&then_def, defined);
+            nameset_copy(&else_def, defined);
+            release_list(&stmt->if_else.if_body, live_after, &then_def, false);
+            release_list(&stmt->if_else.else_body, live_after, &else_def, false);
+            nameset_copy(defined, &then_def);
+            intersect(defined, &else_def);
+            nameset_free(&live_in);
+            nameset_free(&then_def);
+            nameset_free(&else_def);
+            break;
+        }
+        case NODE_WHILE_LOOP:
+        case NODE_FOR_LOOP: {
+            bool is_for = stmt->type == NODE_FOR_LOOP;
+            ASTList** body = is_for ? &stmt->for_loop.body : &stmt->while_loop.body;
+            ASTNode* incr = is_for ? stmt->for_loop.increment : NULL;
+            NameSet head, body_out, body_def;
+            if (is_for) {
+                // range() loops only bind their variable if they run, unless codegen
+                // restores its final value
+                const char* var = stmt->for_loop.init->assignment.var_name;
+                if (!stmt->for_loop.counted || stmt->for_loop.keep_final) nameset_add(defined, var);
+                if (stmt->for_loop.vector_ops) {
+                    // The body is not emitted, so nothing can be released inside it
+                    nameset_union(after, dead);
+                    break;
+                }
+            }
+            nameset_init(&head);
+            nameset_init(&body_out);
+            nameset_init(&body_def);
+            loop_live_in(is_for ? stmt->for_loop.condition : stmt->while_loop.condition, *body, incr, live_after, &head);
+            nameset_copy(&body_out, &head);
+            live_through_stmt(incr, &body_out);
+            nameset_copy(&body_def, defined);
+            if (is_for) nameset_add(&body_def, stmt->for_loop.init->assignment.var_name);
+            release_list(body, &body_out, &body_def, false);
+            intersect(defined, &body_def);
+            // Values that die inside an iteration were released in the body
+            for (int i = 0; i < dead->count; i++)
+                if (nameset_contains(&head, dead->names[i])) nameset_add(after, dead->names[i]);
+            nameset_free(&head);
+            nameset_free(&body_out);
+            nameset_free(&body_def);
+            break;
+        }
+        default:
+            nameset_union(after, dead);
+            break;
+    }
+}
+
+// `live_out` is the live set after the list; `defined` holds the names
+// definitely bound on entry and is updated to those bound on exit.
+static void release_list(ASTList** head, const NameSet* live_out, NameSet* defined, bool top_level) {
+    int n = 0;
+    for (ASTList* s = *head; s; s = s->next) n++;
+    if (n == 0) return;
+
+    ASTList** cells = malloc(n * sizeof(ASTList*));
+    NameSet* live_after = malloc(n * sizeof(NameSet));
+    int i = 0;
+    for (ASTList* s = *head; s; s = s->next) cells[i++] = s;
+    NameSet live;
+    nameset_init(&live);
+    nameset_copy(&live, live_out);
+    for (i = n - 1; i >= 0; i--) {
+        nameset_init(&live_after[i]);
+        nameset_copy(&live_after[i], &live);
+        live_through_stmt(cells[i]->node, &live);
+    }
+    nameset_free(&live);
+
+    for (i = 0; i < n; i++) {
+        ASTNode* stmt = cells[i]->node;
+        if (!stmt) {
+            nameset_free(&live_after[i]);
+            continue;
+        }
+        NameSet mentioned, dead, after;
+        nameset_init(&mentioned);
+        nameset_init(&dead);
+        nameset_init(&after);
+        ASTList one = { stmt, NULL };
+        collect_mentions(&one, &mentioned);
+        for (int j = 0; j < mentioned.count; j++) {
+            const char* v = mentioned.names[j];
+            if (!nameset_contains(&live_after[i], v) && worth_releasing(v)) nameset_add(&dead, v);
+        }
+        release_in_stmt(stmt, &live_after[i], defined, &dead, &after);
+
+        // Nothing is gained by releasing values as the program ends
+        if (!(top_level && i == n - 1)) {
+            ASTList* pos = cells[i];
+            for (int j = 0; j < after.count; j++) {
+                const char* v = after.names[j];
+                bool bound = nameset_contains(defined, v);
+                ASTList* cell = createASTList(createReleaseNode(v, !bound));
+                cell->next = pos->next;
+                pos->next = cell;
+                pos = cell;
+                nameset_remove(defined, v);
+                if (!bound) nameset_add(defined, v);
+            }
+        }
+        nameset_free(&mentioned);
+        nameset_free(&dead);
+        nameset_free(&after);
+        nameset_free(&live_after[i]);
+    }
+    free(cells);
+    free(live_after);
+}
+
+void release_dead_values(ASTNode* program) {
+    ASTList** stmts = &program->program.statements;
+    // Aux blocks may read any variable, and the statements after a live
+    // import run again, reading values computed before
+    if (list_has_opaque_code(*stmts) || list_has_live_import(*stmts)) return;
+    NameSet live_out, defined;
+    nameset_init(&live_out);
+    nameset_init(&defined);
+    release_list(stmts, &live_out, &defined, true);
+    nameset_free(&live_out);
+    nameset_free(&defined);
+}
@@ -0,0 +1,10 @@
+#ifndef RELEASE_H
+#define RELEASE_H
+#include "ast.h"
+
+// Inserts NODE_RELEASE statements right after the last use of every variable
+// that may hold a large value, so its memory is reclaimed while the program
+// keeps running. Needs the results of analyze_types.
+void release_dead_values(ASTNode* program);
+
+#endif
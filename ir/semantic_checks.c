@@ -0,0 +1,566 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fnmatch.h>
+#include "semantic_checks.h"
+#include "import_schema.h"
+#include "liveness.h"
+#include "builtins.h"
+#include "symbol_table.h"
+
+// Flow-insensitive type and shape inference. Every variable gets the join of
+// the types of all its definitions (assignments anywhere in the program plus
+// the columns of imported files), iterated to a fixpoint. The lattice is
+// finite: lengths that disagree widen to -1 and kinds that disagree widen to
+// TYPE_UNKNOWN, so the iteration terminates.
+//
+// Types describe the values the generated Python produces: numeric vectors
+// (literals, imported columns and what operators and built-ins derive from
+// them) are NumPy arrays, whose operators are elementwise. Vectors of strings
+// are lists, so `+` on two of them concatenates; `concat` joins any two
+// vectors.
+
+// ---------------------------------------------------------------------------
+// Lattice
+// ---------------------------------------------------------------------------
+
+TypeInfo type_of_kind(ValueKind kind, ElemType dtype, long length, long columns) {
+    TypeInfo t = { kind, dtype, length, columns };
+    return t;
+}
+
+TypeInfo type_none(void) { return type_of_kind(TYPE_NONE, DTYPE_NONE, -1, -1); }
+TypeInfo type_unknown(void) { return type_of_kind(TYPE_UNKNOWN, DTYPE_NONE, -1, -1); }
+TypeInfo type_number(ElemType dtype) { return type_of_kind(TYPE_NUMBER, dtype, 1, -1); }
+
+bool type_equal(TypeInfo a, TypeInfo b) {
+    return a.kind == b.kind && a.dtype == b.dtype && a.length == b.length && a.columns == b.columns;
+}
+
+bool type_is_numeric_array(TypeInfo t) {
+    return t.kind == TYPE_VECTOR || t.kind == TYPE_MATRIX;
+}
+
+static bool is_list_kind(ValueKind kind) {
+    return kind == TYPE_VECTOR || kind == TYPE_MATRIX || kind == TYPE_STRING_VECTOR;
+}
+
+bool type_is_list(TypeInfo t) {
+    return is_list_kind(t.kind);
+}
+
+// `[]` belongs to every list kind
+static bool is_empty_list(TypeInfo t) {
+    return t.kind == TYPE_VECTOR && t.length == 0;
+}
+
+static ElemType dtype_join(ElemType a, ElemType b) {
+    if (a == DTYPE_NONE) return b;
+    if (b == DTYPE_NONE || a == b) return a;
+    return DTYPE_FLOAT;
+}
+
+TypeInfo type_join(TypeInfo a, TypeInfo b) {
+    if (a.kind == TYPE_NONE) return b;
+    if (b.kind == TYPE_NONE) return a;
+    if (a.kind == TYPE_UNKNOWN || b.kind == TYPE_UNKNOWN) return type_unknown();
+    if (is_empty_list(a) && is_list_kind(b.kind) && b.kind != TYPE_VECTOR)
+        return type_of_kind(b.kind, b.dtype, b.length == 0 ? 0 : -1, b.columns);
+    if (is_empty_list(b) && is_list_kind(a.kind) && a.kind != TYPE_VECTOR)
+        return type_of_kind(a.kind, a.dtype, a.length == 0 ? 0 : -1, a.columns);
+    if (a.kind != b.kind) return type_unknown();
+    return type_of_kind(a.kind, dtype_join(a.dtype, b.dtype),
+                        a.length == b.length ? a.length : -1,
+                        a.columns == b.columns ? a.columns : -1);
+}
+
+// ---------------------------------------------------------------------------
+// Variable types
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    char* name;
+    TypeInfo type;
+} VarType;
+
+static VarType* vars = NULL;
+static int var_count = 0;
+// Set when an aux block or an unreadable import may bind anything
+static bool all_unknown = false;
+// Variables that may share their value with another name or container
+static NameSet aliased;
+// Schemas of the imported files readable at compile time
+typedef struct {
+    char* path;
+    char* table;             // SQLite table, else NULL
+    ImportSchema schema;
+} KnownImport;
+
+static KnownImport* known_imports = NULL;
+static int known_import_count = 0;
+static bool dynamic_imports = false;
+// Files the program writes with `export`
+static NameSet exported_paths;
+
+static VarType* find_var(const char* name) {
+    for (int i = 0; i < var_count; i++)
+        if (strcmp(vars[i].name, name) == 0) return &vars[i];
+    return NULL;
+}
+
+static TypeInfo var_type(const char* name) {
+    VarType* v = find_var(name);
+    return v ? v->type : type_none();
+}
+
+// Joins a new definition into the variable's type; true if it changed
+static bool define_var(const char* name, TypeInfo t) {
+    VarType* v = find_var(name);
+    if (!v) {
+        vars = realloc(vars, (var_count + 1) * sizeof(VarType));
+        v = &vars[var_count++];
+        v->name = strdup(name);
+        v->type = type_none();
+    }
+    TypeInfo joined = type_join(v->type, t);
+    if (type_equal(joined, v->type)) return false;
+    v->type = joined;
+    return true;
+}
+
+static void reset_vars(void) {
+    for (int i = 0; i < var_count; i++)
+        free(vars[i].name);
+    free(vars);
+    vars = NULL;
+    var_count = 0;
+    all_unknown = false;
+    nameset_free(&aliased);
+    for (int i = 0; i < known_import_count; i++) {
+        free(known_imports[i].path);
+        free(known_imports[i].table);
+        free_import_schema(&known_imports[i].schema);
+    }
+    free(known_imports);
+    known_imports = NULL;
+    known_import_count = 0;
+    dynamic_imports = false;
+    nameset_free(&exported_paths);
+}
+
+// ---------------------------------------------------------------------------
+// Expressions
+// ---------------------------------------------------------------------------
+
+static TypeInfo expr_type(ASTNode* e);
+
+// %.15g prints larger integral literals in exponent form, which Python reads as float
+static bool is_int_literal(double v) {
+    return v == floor(v) && fabs(v) < 1e15;
+}
+
+static bool literal_long(ASTNode* e, long* value) {
+    if (!e || e->type != NODE_NUMBER || !is_int_literal(e->num_value)) return false;
+    *value = (long)e->num_value;
+    return true;
+}
+
+// `concat`, and `+` on lists: concatenation
+static TypeInfo concat_type(TypeInfo a, TypeInfo b) {
+    if (is_empty_list(a) && is_list_kind(b.kind)) return b;
+    if (is_empty_list(b) && is_list_kind(a.kind)) return a;
+    if (a.kind != b.kind || !is_list_kind(a.kind)) return type_unknown();
+    long length = a.length >= 0 && b.length >= 0 ? a.length + b.length : -1;
+    return type_of_kind(a.kind, dtype_join(a.dtype, b.dtype), length,
+                        a.columns == b.columns ? a.columns : -1);
+}
+
+// Arithmetic on numbers and numeric vectors. A number, or a vector of one
+// element, is broadcast over the other operand; vectors of other lengths
+// must match.
+static TypeInfo elementwise_type(BinaryOpType op, TypeInfo a, TypeInfo b) {
+    bool a_vector = a.kind == TYPE_VECTOR;
+    bool b_vector = b.kind == TYPE_VECTOR;
+    if ((!a_vector && a.kind != TYPE_NUMBER) || (!b_vector && b.kind != TYPE_NUMBER)) return type_unknown();
+    ElemType dtype = op == OP_DIVIDE ? DTYPE_FLOAT : dtype_join(a.dtype, b.dtype);
+    if (!a_vector && !b_vector) return type_number(dtype);
+    long length = !b_vector ? a.length
+                : !a_vector ? b.length
+                : a.length == b.length || b.length == 1 ? a.length
+                : a.length == 1 ? b.length : -1;
+    return type_of_kind(TYPE_VECTOR, dtype, length, -1);
+}
+
+static TypeInfo binary_type(BinaryOpType op, TypeInfo a, TypeInfo b) {
+    if (a.kind == TYPE_NONE || b.kind == TYPE_NONE) return type_none();
+    if (a.kind == TYPE_UNKNOWN || b.kind == TYPE_UNKNOWN) return type_unknown();
+    switch (op) {
+        case OP_LT:
+        case OP_GT:
+            // Vectors compare into arrays of bools
+            return a.kind == TYPE_NUMBER && b.kind == TYPE_NUMBER ? type_number(DTYPE_INT) : type_unknown();
+        case OP_PLUS:
+            if (a.kind == TYPE_STRING && b.kind == TYPE_STRING) return type_of_kind(TYPE_STRING, DTYPE_NONE, 1, -1);
+            if (a.kind == TYPE_STRING_VECTOR && b.kind == TYPE_STRING_VECTOR) return concat_type(a, b);
+            return elementwise_type(op, a, b);
+        case OP_TIMES:
+            // A list of strings times an int repeats the list
+            if (a.kind == TYPE_STRING_VECTOR && b.kind == TYPE_NUMBER && b.dtype == DTYPE_INT)
+                return type_of_kind(a.kind, a.dtype, -1, -1);
+            if (b.kind == TYPE_STRING_VECTOR && a.kind == TYPE_NUMBER && a.dtype == DTYPE_INT)
+                return type_of_kind(b.kind, b.dtype, -1, -1);
+            return elementwise_type(op, a, b);
+        case OP_MINUS:
+        case OP_DIVIDE:
+            return elementwise_type(op, a, b);
+        default:
+            return type_unknown();
+    }
+}
+
+static TypeInfo vector_literal_type(ASTList* elements) {
+    long count = 0;
+    TypeInfo elem = type_none();
+    for (ASTList* e = elements; e; e = e->next) {
+        TypeInfo t = expr_type(e->node);
+        if (t.kind == TYPE_NONE) return type_none();
+        elem = count == 0 ? t : type_join(elem, t);
+        count++;
+    }
+    if (count == 0) return type_of_kind(TYPE_VECTOR, DTYPE_NONE, 0, -1);
+    switch (elem.kind) {
+        case TYPE_NUMBER: return type_of_kind(TYPE_VECTOR, elem.dtype, count, -1);
+        case TYPE_STRING: return type_of_kind(TYPE_STRING_VECTOR, DTYPE_NONE, count, -1);
+        case TYPE_VECTOR: return type_of_kind(TYPE_MATRIX, elem.dtype, count, elem.length);
+        default:          return type_unknown();
+    }
+}
+
+// Python slice length of a sequence of known length
+static long slice_length(long length, long start, long stop) {
+    if (start < 0) start += length;
+    if (stop < 0) stop += length;
+    if (start < 0) start = 0;
+    if (stop > length) stop = length;
+    return stop > start ? stop - start : 0;
+}
+
+static TypeInfo builtin_type(const char* func, ASTList* args) {
+    if (!args) return type_unknown();
+    TypeInfo arg = expr_type(args->node);
+    if (arg.kind == TYPE_NONE) return type_none();
+    if (strcmp(func, "avg") == 0)
+        return type_number(DTYPE_FLOAT);
+    if (arg.kind == TYPE_UNKNOWN) return type_unknown();
+
+    if (strcmp(func, "sort") == 0 || strcmp(func, "reverse") == 0)
+        return is_list_kind(arg.kind) ? arg : type_unknown();
+    if (strcmp(func, "slice") == 0) {
+        if (!args->next || !args->next->next) return type_unknown();
+        if (arg.kind == TYPE_STRING) return arg;
+        if (!is_list_kind(arg.kind)) return type_unknown();
+        long start, stop;
+        bool known = arg.length >= 0 && literal_long(args->next->node, &start) && literal_long(args->next->next->node, &stop);
+        return type_of_kind(arg.kind, arg.dtype, known ? slice_length(arg.length, start, stop) : -1, arg.columns);
+    }
+    if (strcmp(func, "transpose") == 0) {
+        if (arg.kind != TYPE_MATRIX) return is_empty_list(arg) ? arg : type_unknown();
+        if (arg.length == 0) return type_of_kind(TYPE_VECTOR, DTYPE_NONE, 0, -1);
+        return type_of_kind(TYPE_MATRIX, arg.dtype, arg.columns, arg.length);
+    }
+    if (strcmp(func, "pairwiseCompare") == 0) {
+        if (arg.kind != TYPE_VECTOR) return type_unknown();
+        return type_of_kind(TYPE_VECTOR, arg.dtype, arg.length > 0 ? arg.length - 1 : arg.length, -1);
+    }
+    if (strcmp(func, "paretoSet") == 0)
+        return is_list_kind(arg.kind) ? type_of_kind(arg.kind, arg.dtype, arg.length == 0 ? 0 : -1, arg.columns) : type_unknown();
+    if (strcmp(func, "runningSum") == 0)
+        return arg.kind == TYPE_VECTOR ? arg : type_unknown();
+    if (strcmp(func, "concat") == 0) {
+        if (!args->next) return type_unknown();
+        TypeInfo other = expr_type(args->next->node);
+        return other.kind == TYPE_NONE ? type_none() : concat_type(arg, other);
+    }
+    return type_unknown();
+}
+
+static TypeInfo expr_type(ASTNode* e) {
+    if (!e) return type_unknown();
+    switch (e->type) {
+        case NODE_NUMBER:
+            return type_number(is_int_literal(e->num_value) ? DTYPE_INT : DTYPE_FLOAT);
+        case NODE_STRING:
+            return type_of_kind(TYPE_STRING, DTYPE_NONE, 1, -1);
+        case NODE_ID:
+            return var_type(e->id_name);
+        case NODE_BINARY_OP:
+            return binary_type(e->binary_op.op, expr_type(e->binary_op.left), expr_type(e->binary_op.right));
+        case NODE_VECTOR_LITERAL:
+            return vector_literal_type(e->vector_literal.elements);
+        case NODE_FUNCTION_CALL:
+            return builtin_type(e->function_call.func_name, e->function_call.args);
+        default:
+            return type_unknown();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Statements
+// ---------------------------------------------------------------------------
+
+static void collect_exports(ASTList* stmts) {
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        switch (n->type) {
+            case NODE_EXPORT:
+                nameset_add(&exported_paths, n->export.filename);
+                break;
+            case NODE_IF_ELSE:
+                collect_exports(n->if_else.if_body);
+                collect_exports(n->if_else.else_body);
+                break;
+            case NODE_WHILE_LOOP:
+                collect_exports(n->while_loop.body);
+                break;
+            case NODE_FOR_LOOP:
+                collect_exports(n->for_loop.body);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static bool reads_exported_file(const char* path) {
+    for (int i = 0; i < exported_paths.count; i++)
+        if (strcmp(path, exported_paths.names[i]) == 0
+            || (import_is_pattern(path) && fnmatch(path, exported_paths.names[i], FNM_PATHNAME) == 0))
+            return true;
+    return false;
+}
+
+static void import_types(ASTNode* node) {
+    char path[256];
+    ImportSchema schema;
+    import_path(node->import.filename, path, sizeof(path));
+    if (import_format(path) == IMPORT_UNSUPPORTED) return;   // codegen emits a comment only
+    // What a file the program writes itself holds is only known at run time
+    if (reads_exported_file(path) || !read_import_schema(path, node->import.table, &schema)) {
+        all_unknown = true;
+        dynamic_imports = true;
+        return;
+    }
+    for (int i = 0; i < schema.count; i++) {
+        TypeInfo t = schema.columns[i].type;
+        // Files are read again at run time, so row counts are not trusted
+        if (is_list_kind(t.kind)) t.length = -1;
+        // The loaders return numeric columns and non-empty JSON arrays of
+        // numbers as arrays, and empty JSON arrays as lists
+        if (t.kind == TYPE_VECTOR && t.dtype == DTYPE_NONE) t = type_unknown();
+        // Appended rows may widen a live column to floats or text
+        if (node->import.live) t = type_unknown();
+        define_var(schema.columns[i].name, t);
+    }
+    known_imports = realloc(known_imports, (known_import_count + 1) * sizeof(KnownImport));
+    known_imports[known_import_count].path = strdup(path);
+    known_imports[known_import_count].table = node->import.table ? strdup(node->import.table) : NULL;
+    known_imports[known_import_count].schema = schema;
+    known_import_count++;
+}
+
+static void collect_imports(ASTList* stmts) {
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        switch (n->type) {
+            case NODE_IMPORT:
+                import_types(n);
+                break;
+            case NODE_IF_ELSE:
+                collect_imports(n->if_else.if_body);
+                collect_imports(n->if_else.else_body);
+                break;
+            case NODE_WHILE_LOOP:
+                collect_imports(n->while_loop.body);
+                break;
+            case NODE_FOR_LOOP:
+                collect_imports(n->for_loop.body);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static bool infer_assignment(ASTNode* n) {
+    if (!n || n->type != NODE_ASSIGNMENT) return false;
+    return define_var(n->assignment.var_name, expr_type(n->assignment.expr));
+}
+
+// One round over every assignment; true if any variable's type changed
+static bool infer_list(ASTList* stmts) {
+    bool changed = false;
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        switch (n->type) {
+            case NODE_ASSIGNMENT:
+                changed |= infer_assignment(n);
+                break;
+            case NODE_IF_ELSE:
+                changed |= infer_list(n->if_else.if_body);
+                changed |= infer_list(n->if_else.else_body);
+                break;
+            case NODE_WHILE_LOOP:
+                changed |= infer_list(n->while_loop.body);
+                break;
+            case NODE_FOR_LOOP:
+                changed |= infer_assignment(n->for_loop.init);
+                changed |= infer_assignment(n->for_loop.increment);
+                changed |= infer_list(n->for_loop.body);
+                break;
+            default:
+                break;
+        }
+    }
+    return changed;
+}
+
+// ---------------------------------------------------------------------------
+// Aliasing
+//
+// A variable is aliased when one of its definitions does not create a fresh
+// object (`x = y`, an unknown call) or when its value is stored somewhere
+// else by reference: assigned whole to another name, put into a vector
+// literal or passed to an unknown function. Built-ins and operators always
+// return new objects, and plots are saved and cleared within the statement
+// that draws them. `slice` of an array is a view of it, so it counts as a
+// reference.
+// ---------------------------------------------------------------------------
+
+// Built-ins other than slice, and print, never keep a reference to their
+// arguments
+static bool retains_arguments(const char* func) {
+    if (strcmp(func, "slice") == 0) return true;
+    return lookup_builtin(func) == NULL && strcmp(func, "print") != 0;
+}
+
+static bool creates_fresh_value(ASTNode* e) {
+    if (!e) return false;
+    if (e->type == NODE_ID) return false;
+    if (e->type == NODE_FUNCTION_CALL)
+        return lookup_builtin(e->function_call.func_name) != NULL && !retains_arguments(e->function_call.func_name);
+    return true;
+}
+
+static void collect_escapes(ASTNode* e, bool whole) {
+    if (!e) return;
+    switch (e->type) {
+        case NODE_ID:
+            if (whole) nameset_add(&aliased, e->id_name);
+            break;
+        case NODE_BINARY_OP:
+            if (e->binary_op.op != OP_ASSIGN) collect_escapes(e->binary_op.left, false);
+            collect_escapes(e->binary_op.right, false);
+            break;
+        case NODE_VECTOR_LITERAL:
+            for (ASTList* el = e->vector_literal.elements; el; el = el->next)
+                collect_escapes(el->node, true);
+            break;
+        case NODE_FUNCTION_CALL: {
+            bool retains = retains_arguments(e->function_call.func_name);
+            for (ASTList* a = e->function_call.args; a; a = a->next)
+                collect_escapes(a->node, retains);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void collect_aliases(ASTList* stmts);
+
+static void alias_stmt(ASTNode* n) {
+    if (!n) return;
+    switch (n->type) {
+        case NODE_ASSIGNMENT:
+            if (!creates_fresh_value(n->assignment.expr)) nameset_add(&aliased, n->assignment.var_name);
+            collect_escapes(n->assignment.expr, true);
+            break;
+        case NODE_FUNCTION_CALL:
+            collect_escapes(n, false);
+            break;
+        case NODE_VIZ_CALL:
+            for (ASTList* a = n->viz_call.args; a; a = a->next)
+                collect_escapes(a->node, false);
+            break;
+        case NODE_IF_ELSE:
+            collect_escapes(n->if_else.condition, false);
+            collect_aliases(n->if_else.if_body);
+            collect_aliases(n->if_else.else_body);
+            break;
+        case NODE_WHILE_LOOP:
+            collect_escapes(n->while_loop.condition, false);
+            collect_aliases(n->while_loop.body);
+            break;
+        case NODE_FOR_LOOP:
+            alias_stmt(n->for_loop.init);
+            collect_escapes(n->for_loop.condition, false);
+            alias_stmt(n->for_loop.increment);
+            collect_aliases(n->for_loop.body);
+            break;
+        default:
+            break;
+    }
+}
+
+static void collect_aliases(ASTList* stmts) {
+    for (ASTList* s = stmts; s; s = s->next)
+        alias_stmt(s->node);
+}
+
+void analyze_types(ASTNode* program) {
+    reset_vars();
+    ASTList* stmts = program->program.statements;
+    if (list_has_opaque_code(stmts)) {
+        all_unknown = true;
+        return;
+    }
+    collect_exports(stmts);
+    collect_imports(stmts);
+    if (all_unknown) return;
+    while (infer_list(stmts))
+        ;
+    collect_aliases(stmts);
+}
+
+TypeInfo lookup_var_type(const char* name) {
+    if (all_unknown) return type_unknown();
+    TypeInfo t = var_type(name);
+    return t.kind == TYPE_NONE ? type_unknown() : t;
+}
+
+TypeInfo infer_expr_type(ASTNode* expr) {
+    if (all_unknown) return type_unknown();
+    TypeInfo t = expr_type(expr);
+    return t.kind == TYPE_NONE ? type_unknown() : t;
+}
+
+bool var_is_unaliased(const char* name) {
+    return !all_unknown && !nameset_contains(&aliased, name);
+}
+
+const ImportSchema* find_import_schema(const char* path, const char* table) {
+    for (int i = 0; i < known_import_count; i++) {
+        const KnownImport* k = &known_imports[i];
+        if (strcmp(k->path, path) == 0 && (k->table && table ? strcmp(k->table, table) == 0 : k->table == table))
+            return &k->schema;
+    }
+    return NULL;
+}
+
+bool has_dynamic_imports(void) {
+    return dynamic_imports;
+}
@@ -0,0 +1,29 @@
+#ifndef SEMANTIC_CHECKS_H
+#define SEMANTIC_CHECKS_H
+#include "ast.h"
+#include "types.h"
+#include "import_schema.h"
+
+// Infers a type and shape for every variable of a NODE_PROGRAM. Must run
+// after optimize_program, since codegen queries the results for the final AST.
+void analyze_types(ASTNode* program);
+
+// Type every definition of `name` can produce; TYPE_UNKNOWN when nothing is known
+TypeInfo lookup_var_type(const char* name);
+
+// Type of an expression under the inferred variable types
+TypeInfo infer_expr_type(ASTNode* expr);
+
+// True if every value `name` holds is a fresh object no other name or
+// container can reach, so updating it in place is unobservable
+bool var_is_unaliased(const char* name);
+
+// Schema read at compile time for an imported file (unquoted path) or SQLite
+// table (NULL for files), or NULL when it could not be read and its names are
+// bound dynamically
+const ImportSchema* find_import_schema(const char* path, const char* table);
+
+// True if some import binds its names through globals() at run time
+bool has_dynamic_imports(void);
+
+#endif
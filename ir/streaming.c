@@ -0,0 +1,316 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "streaming.h"
+#include "semantic_checks.h"
+#include "liveness.h"
+#include "symbol_table.h"
+
+// A column of a stream import is streamed when the schema read at compile
+// time says it is numeric, no statement assigns it, no other import binds
+// it, and every use is one of
+//   avg(x)  runningSum(x)  histogram(x, ...)  boxplot(x, ...)
+// where the plots get no other data and only keyword arguments that do not
+// need the individual values (histogram bins must be an integer literal).
+// Generated code then computes exactly those aggregates in passes over
+// blocks of the file; everything else is loaded whole as before.
+
+typedef struct {
+    StreamColumn column;
+    bool stream;             // bound by a stream import
+    const char* reason;      // why it is loaded whole, NULL while streamable
+} Candidate;
+
+static Candidate* candidates = NULL;
+static int candidate_count = 0;
+
+static bool streq(const char* a, const char* b) {
+    return strcmp(a, b) == 0;
+}
+
+static Candidate* find_candidate(const char* name) {
+    for (int i = 0; i < candidate_count; i++)
+        if (streq(candidates[i].column.name, name)) return &candidates[i];
+    return NULL;
+}
+
+static Candidate* candidate_expr(ASTNode* e) {
+    return e && e->type == NODE_ID ? find_candidate(e->id_name) : NULL;
+}
+
+static void reject(Candidate* c, const char* reason) {
+    if (c && !c->reason) c->reason = reason;
+}
+
+static void add_need(Candidate* c, unsigned need, int bins) {
+    c->column.needs |= need;
+    if (need != STREAM_HISTOGRAM) return;
+    for (int i = 0; i < c->column.bin_count; i++)
+        if (c->column.bins[i] == bins) return;
+    if (c->column.bin_count == STREAM_MAX_BINNINGS) {
+        reject(c, "it is plotted with too many different bin counts");
+        return;
+    }
+    c->column.bins[c->column.bin_count++] = bins;
+}
+
+// ---------------------------------------------------------------------------
+// Candidates
+// ---------------------------------------------------------------------------
+
+static void add_candidate(const char* name, const char* path, bool stream, const char* reason) {
+    Candidate* c = find_candidate(name);
+    if (c) {
+        c->stream |= stream;
+        reject(c, "more than one import binds it");
+        return;
+    }
+    candidates = realloc(candidates, (candidate_count + 1) * sizeof(Candidate));
+    c = &candidates[candidate_count++];
+    memset(c, 0, sizeof(Candidate));
+    c->column.name = name;
+    c->column.path = strdup(path);
+    c->stream = stream;
+    c->reason = reason;
+}
+
+static void collect_candidates(ASTList* stmts, bool opaque) {
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        switch (n->type) {
+            case NODE_IMPORT: {
+                char path[256];
+                import_path(n->import.filename, path, sizeof(path));
+                if (import_format(path) == IMPORT_UNSUPPORTED) break;
+                const ImportSchema* schema = opaque ? NULL : find_import_schema(path, n->import.table);
+                if (n->import.stream && opaque) {
+                    fprintf(stderr, "warning: %s is loaded whole: programs with aux blocks are not streamed\n", path);
+                } else if (n->import.stream && !schema) {
+                    fprintf(stderr, "warning: %s is loaded whole: it could not be read when compiling\n", path);
+                } else if (n->import.stream && schema->format != IMPORT_CSV) {
+                    fprintf(stderr, "warning: %s is loaded whole: only CSV files are streamed\n", path);
+                }
+                if (!schema) break;
+                // Names of plain imports are candidates too, so a stream
+                // import's column they rebind is rejected
+                bool stream = n->import.stream && schema->format == IMPORT_CSV;
+                for (int i = 0; i < schema->count; i++) {
+                    const ImportColumn* col = &schema->columns[i];
+                    const char* reason = !stream ? "it is imported without stream"
+                                       : col->type.kind != TYPE_VECTOR ? "it is not numeric"
+                                       : NULL;
+                    add_candidate(col->name, path, stream, reason);
+                }
+                break;
+            }
+            case NODE_IF_ELSE:
+                collect_candidates(n->if_else.if_body, opaque);
+                collect_candidates(n->if_else.else_body, opaque);
+                break;
+            case NODE_WHILE_LOOP:
+                collect_candidates(n->while_loop.body, opaque);
+                break;
+            case NODE_FOR_LOOP:
+                collect_candidates(n->for_loop.body, opaque);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Uses
+// ---------------------------------------------------------------------------
+
+static void check_expr(ASTNode* e) {
+    if (!e) return;
+    switch (e->type) {
+        case NODE_ID:
+            reject(find_candidate(e->id_name), "it is used outside avg, runningSum, histogram and boxplot");
+            break;
+        case NODE_BINARY_OP:
+            // Keyword arguments (key=value) only read the value
+            if (e->binary_op.op != OP_ASSIGN) check_expr(e->binary_op.left);
+            check_expr(e->binary_op.right);
+            break;
+        case NODE_VECTOR_LITERAL:
+            for (ASTList* el = e->vector_literal.elements; el; el = el->next)
+                check_expr(el->node);
+            break;
+        case NODE_FUNCTION_CALL: {
+            ASTList* args = e->function_call.args;
+            const char* func = e->function_call.func_name;
+            Candidate* c = args && !args->next ? candidate_expr(args->node) : NULL;
+            if (c && streq(func, "avg")) {
+                add_need(c, STREAM_AVG, 0);
+            } else if (c && streq(func, "runningSum")) {
+                add_need(c, STREAM_RUNNING_SUM, 0);
+            } else {
+                for (ASTList* a = args; a; a = a->next)
+                    check_expr(a->node);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static bool is_keyword_arg(ASTNode* n) {
+    return n->type == NODE_BINARY_OP && n->binary_op.op == OP_ASSIGN && n->binary_op.left->type == NODE_ID;
+}
+
+// Keyword arguments that style the plot without looking at the data
+static bool streamable_option(const char* func, const char* key) {
+    static const char* common[] = { "title", "xlabel", "ylabel", "grid", NULL };
+    static const char* histogram[] = { "bins", "color", "edgecolor", "density", "alpha", "label", NULL };
+    static const char* boxplot[] = { "notch", "vert", "patch_artist", "tick_labels", NULL };
+    for (int i = 0; common[i]; i++)
+        if (streq(key, common[i])) return true;
+    const char** own = streq(func, "histogram") ? histogram : boxplot;
+    for (int i = 0; own[i]; i++)
+        if (streq(key, own[i])) return true;
+    return false;
+}
+
+static void check_viz(ASTNode* n) {
+    const char* func = n->viz_call.viz_func;
+    ASTNode* data = NULL;
+    int positional = 0;
+    for (ASTList* a = n->viz_call.args; a; a = a->next) {
+        if (is_keyword_arg(a->node)) continue;
+        data = a->node;
+        positional++;
+    }
+    Candidate* c = NULL;
+    if ((streq(func, "histogram") || streq(func, "boxplot")) && positional == 1)
+        c = candidate_expr(data);
+    if (c) {
+        int bins = 10;   // matplotlib's default, which codegen passes explicitly
+        const char* reason = NULL;
+        for (ASTList* a = n->viz_call.args; a; a = a->next) {
+            if (!is_keyword_arg(a->node)) continue;
+            const char* key = a->node->binary_op.left->id_name;
+            ASTNode* value = a->node->binary_op.right;
+            if (!streamable_option(func, key)) {
+                reason = "it is plotted with an option that needs every value";
+            } else if (streq(key, "bins")) {
+                if (value->type != NODE_NUMBER || value->num_value < 1 || value->num_value != (int)value->num_value)
+                    reason = "histogram bins are not an integer literal";
+                else
+                    bins = (int)value->num_value;
+            }
+        }
+        if (reason) reject(c, reason);
+        else add_need(c, streq(func, "histogram") ? STREAM_HISTOGRAM : STREAM_BOXPLOT, bins);
+    }
+    for (ASTList* a = n->viz_call.args; a; a = a->next) {
+        if (a->node == data && c) continue;
+        check_expr(a->node);
+    }
+}
+
+static void check_list(ASTList* stmts);
+
+static void check_stmt(ASTNode* n) {
+    if (!n) return;
+    switch (n->type) {
+        case NODE_ASSIGNMENT:
+            reject(find_candidate(n->assignment.var_name), "it is assigned");
+            check_expr(n->assignment.expr);
+            break;
+        case NODE_FUNCTION_CALL:
+            check_expr(n);
+            break;
+        case NODE_VIZ_CALL:
+            check_viz(n);
+            break;
+        case NODE_EXPORT:
+            for (ASTList* e = n->export.names; e; e = e->next)
+                reject(find_candidate(e->node->id_name), "it is exported");
+            break;
+        case NODE_IF_ELSE:
+            check_expr(n->if_else.condition);
+            check_list(n->if_else.if_body);
+            check_list(n->if_else.else_body);
+            break;
+        case NODE_WHILE_LOOP:
+            check_expr(n->while_loop.condition);
+            check_list(n->while_loop.body);
+            break;
+        case NODE_FOR_LOOP:
+            check_stmt(n->for_loop.init);
+            check_expr(n->for_loop.condition);
+            check_stmt(n->for_loop.increment);
+            check_list(n->for_loop.body);
+            break;
+        default:
+            break;
+    }
+}
+
+static void check_list(ASTList* stmts) {
+    for (ASTList* s = stmts; s; s = s->next)
+        check_stmt(s->node);
+}
+
+static bool list_has_stream_import(ASTList* stmts) {
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        switch (n->type) {
+            case NODE_IMPORT:
+                if (n->import.stream) return true;
+                break;
+            case NODE_IF_ELSE:
+                if (list_has_stream_import(n->if_else.if_body) || list_has_stream_import(n->if_else.else_body)) return true;
+                break;
+            case NODE_WHILE_LOOP:
+                if (list_has_stream_import(n->while_loop.body)) return true;
+                break;
+            case NODE_FOR_LOOP:
+                if (list_has_stream_import(n->for_loop.body)) return true;
+                break;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+void plan_streams(ASTNode* program) {
+    for (int i = 0; i < candidate_count; i++)
+        free(candidates[i].column.path);
+    free(candidates);
+    candidates = NULL;
+    candidate_count = 0;
+
+    ASTList* stmts = program->program.statements;
+    if (!list_has_stream_import(stmts)) return;
+    collect_candidates(stmts, list_has_opaque_code(stmts));
+    check_list(stmts);
+
+    // Columns the program never reads are not loaded at all
+    NameSet uses;
+    nameset_init(&uses);
+    for (ASTList* s = stmts; s; s = s->next)
+        collect_stmt_uses(s->node, &uses);
+    for (int i = 0; i < candidate_count; i++) {
+        Candidate* c = &candidates[i];
+        if (!c->reason && !c->column.needs) c->reason = "it is not used";
+        if (c->stream && c->reason && nameset_contains(&uses, c->column.name))
+            fprintf(stderr, "warning: %s: column '%s' is loaded whole: %s\n", c->column.path, c->column.name, c->reason);
+    }
+    nameset_free(&uses);
+}
+
+const StreamColumn* find_stream_column(const char* name) {
+    Candidate* c = find_candidate(name);
+    return c && !c->reason ? &c->column : NULL;
+}
+
+bool is_stream_column(ASTNode* expr) {
+    return expr && expr->type == NODE_ID && find_stream_column(expr->id_name);
+}
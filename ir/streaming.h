@@ -0,0 +1,34 @@
+#ifndef STREAMING_H
+#define STREAMING_H
+#include <stdbool.h>
+#include "ast.h"
+
+// Aggregates a streamed column is read through
+#define STREAM_AVG          1u
+#define STREAM_RUNNING_SUM  2u
+#define STREAM_HISTOGRAM    4u
+#define STREAM_BOXPLOT      8u
+
+#define STREAM_MAX_BINNINGS 8
+
+// A numeric column of a stream import (`import "big.csv" stream;`) whose only
+// uses are aggregates that can be updated one block of rows at a time
+typedef struct {
+    const char* name;
+    char* path;                          // unquoted file name
+    unsigned needs;                      // STREAM_* flags
+    int bins[STREAM_MAX_BINNINGS];       // distinct histogram bin counts
+    int bin_count;
+} StreamColumn;
+
+// Decides which columns of stream imports are streamed; the others are
+// loaded whole, with a warning on stderr. Needs the results of analyze_types.
+void plan_streams(ASTNode* program);
+
+// The streamed column bound to `name`, or NULL
+const StreamColumn* find_stream_column(const char* name);
+
+// True if `expr` is a streamed column
+bool is_stream_column(ASTNode* expr);
+
+#endif
@@ -0,0 +1,66 @@
+#include <stdlib.h>
+#include <string.h>
+#include "symbol_table.h"
+
+void nameset_init(NameSet* set) {
+    set->names = NULL;
+    set->count = 0;
+    set->capacity = 0;
+}
+
+void nameset_free(NameSet* set) {
+    free(set->names);
+    nameset_init(set);
+}
+
+void nameset_clear(NameSet* set) {
+    set->count = 0;
+}
+
+bool nameset_contains(const NameSet* set, const char* name) {
+    for (int i = 0; i < set->count; i++) {
+        if (strcmp(set->names[i], name) == 0) return true;
+    }
+    return false;
+}
+
+bool nameset_add(NameSet* set, const char* name) {
+    if (nameset_contains(set, name)) return false;
+    if (set->count == set->capacity) {
+        set->capacity = set->capacity ? set->capacity * 2 : 8;
+        set->names = realloc(set->names, set->capacity * sizeof(char*));
+    }
+    set->names[set->count++] = name;
+    return true;
+}
+
+bool nameset_remove(NameSet* set, const char* name) {
+    for (int i = 0; i < set->count; i++) {
+        if (strcmp(set->names[i], name) == 0) {
+            set->names[i] = set->names[--set->count];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool nameset_union(NameSet* dst, const NameSet* src) {
+    bool changed = false;
+    for (int i = 0; i < src->count; i++) {
+        if (nameset_add(dst, src->names[i])) changed = true;
+    }
+    return changed;
+}
+
+void nameset_copy(NameSet* dst, const NameSet* src) {
+    nameset_clear(dst);
+    nameset_union(dst, src);
+}
+
+bool nameset_equal(const NameSet* a, const NameSet* b) {
+    if (a->count != b->count) return false;
+    for (int i = 0; i < a->count; i++) {
+        if (!nameset_contains(b, a->names[i])) return false;
+    }
+    return true;
+}
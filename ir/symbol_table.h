@@ -0,0 +1,22 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+#include <stdbool.h>
+
+// A small set of variable names. Names are borrowed from the AST, not copied.
+typedef struct {
+    const char** names;
+    int count;
+    int capacity;
+} NameSet;
+
+void nameset_init(NameSet* set);
+void nameset_free(NameSet* set);
+void nameset_clear(NameSet* set);
+bool nameset_contains(const NameSet* set, const char* name);
+bool nameset_add(NameSet* set, const char* name);       // true if newly added
+bool nameset_remove(NameSet* set, const char* name);    // true if it was present
+bool nameset_union(NameSet* dst, const NameSet* src);   // true if dst changed
+void nameset_copy(NameSet* dst, const NameSet* src);
+bool nameset_equal(const NameSet* a, const NameSet* b);
+
+#endif
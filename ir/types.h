@@ -0,0 +1,41 @@
+#ifndef TYPES_H
+#define TYPES_H
+#include <stdbool.h>
+
+// Static type and shape of a WizuAll value (see semantic_checks.c)
+typedef enum {
+    TYPE_NONE,           // no definition seen yet (lattice bottom)
+    TYPE_NUMBER,         // scalar number
+    TYPE_STRING,         // scalar string
+    TYPE_VECTOR,         // 1-D numeric vector (a NumPy array)
+    TYPE_MATRIX,         // 2-D numeric (list of equally typed rows)
+    TYPE_STRING_VECTOR,  // vector of strings (a list)
+    TYPE_UNKNOWN         // anything / conflicting definitions (lattice top)
+} ValueKind;
+
+typedef enum {
+    DTYPE_NONE,
+    DTYPE_INT,
+    DTYPE_FLOAT
+} ElemType;
+
+typedef struct {
+    ValueKind kind;
+    ElemType dtype;      // element type of numeric values
+    long length;         // scalars: 1; vectors/matrices: rows; -1 when unknown
+    long columns;        // matrices only; -1 when unknown
+} TypeInfo;
+
+TypeInfo type_none(void);
+TypeInfo type_unknown(void);
+TypeInfo type_number(ElemType dtype);
+TypeInfo type_of_kind(ValueKind kind, ElemType dtype, long length, long columns);
+
+// Least upper bound of two types
+TypeInfo type_join(TypeInfo a, TypeInfo b);
+bool type_equal(TypeInfo a, TypeInfo b);
+
+bool type_is_numeric_array(TypeInfo t);   // TYPE_VECTOR or TYPE_MATRIX
+bool type_is_list(TypeInfo t);            // any vector or matrix kind
+
+#endif
@@ -0,0 +1,245 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "vectorize.h"
+#include "loop_analysis.h"
+#include "liveness.h"
+#include "symbol_table.h"
+
+// The vectorised form materialises one int64 element per iteration, so very
+// long loops stay scalar rather than trading O(1) memory for O(n).
+#define VEC_MAX_TRIP (1L << 25)
+
+// Every intermediate must stay well inside int64 for NumPy to match Python's
+// arbitrary-precision integers exactly.
+#define VEC_INT_LIMIT 4611686018427387904.0   // 2^62
+
+typedef struct {
+    double lo, hi;
+} Interval;
+
+static bool is_named(ASTNode* node, const char* name) {
+    return node && node->type == NODE_ID && strcmp(node->id_name, name) == 0;
+}
+
+// Value range of an integer expression over the loop variable's range. Fails
+// for anything but integer literals, the loop variable, + - and *.
+static bool term_range(ASTNode* e, const char* var, Interval iv, Interval* out) {
+    long v;
+    if (!e) return false;
+    switch (e->type) {
+        case NODE_NUMBER:
+            if (!is_integer_literal(e, &v)) return false;
+            out->lo = out->hi = (double)v;
+            return true;
+        case NODE_ID:
+            if (strcmp(e->id_name, var) != 0) return false;
+            *out = iv;
+            return true;
+        case NODE_BINARY_OP: {
+            Interval a, b;
+            if (!term_range(e->binary_op.left, var, iv, &a) || !term_range(e->binary_op.right, var, iv, &b))
+                return false;
+            switch (e->binary_op.op) {
+                case OP_PLUS:  out->lo = a.lo + b.lo; out->hi = a.hi + b.hi; break;
+                case OP_MINUS: out->lo = a.lo - b.hi; out->hi = a.hi - b.lo; break;
+                case OP_TIMES: {
+                    double p[4] = { a.lo * b.lo, a.lo * b.hi, a.hi * b.lo, a.hi * b.hi };
+                    out->lo = out->hi = p[0];
+                    for (int i = 1; i < 4; i++) {
+                        if (p[i] < out->lo) out->lo = p[i];
+                        if (p[i] > out->hi) out->hi = p[i];
+                    }
+                    break;
+                }
+                default:
+                    return false;
+            }
+            return fabs(out->lo) < VEC_INT_LIMIT && fabs(out->hi) < VEC_INT_LIMIT;
+        }
+        default:
+            return false;
+    }
+}
+
+// Integer literal held by `name` just before the statement at `loop_pos`,
+// following straight-line assignments in the same statement list.
+static bool initial_value(ASTList* stmts, ASTList* loop_pos, const char* name, long* value) {
+    bool known = false;
+    for (ASTList* s = stmts; s && s != loop_pos; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        if (n->type == NODE_ASSIGNMENT) {
+            if (strcmp(n->assignment.var_name, name) == 0)
+                known = is_integer_literal(n->assignment.expr, value);
+        } else if (n->type == NODE_IMPORT) {
+            known = false;
+        } else {
+            NameSet defs;
+            nameset_init(&defs);
+            ASTList one = { n, NULL };
+            collect_list_defs(&one, &defs);
+            if (nameset_contains(&defs, name)) known = false;
+            nameset_free(&defs);
+        }
+    }
+    return known;
+}
+
+static VectorOp* find_op(VectorOp* ops, const char* target) {
+    for (VectorOp* op = ops; op; op = op->next)
+        if (strcmp(op->target, target) == 0) return op;
+    return NULL;
+}
+
+static void free_ops(VectorOp* ops) {
+    while (ops) {
+        VectorOp* next = ops->next;
+        free(ops);
+        ops = next;
+    }
+}
+
+// `t = concat(t, [value])`: the one element appended, else NULL
+static ASTNode* appended_element(ASTNode* e, const char* t) {
+    if (e->type != NODE_FUNCTION_CALL || strcmp(e->function_call.func_name, "concat") != 0) return NULL;
+    ASTList* args = e->function_call.args;
+    if (!args || !is_named(args->node, t) || !args->next || args->next->next) return NULL;
+    ASTNode* r = args->next->node;
+    if (r->type != NODE_VECTOR_LITERAL) return NULL;
+    ASTList* elems = r->vector_literal.elements;
+    return elems && !elems->next ? elems->node : NULL;
+}
+
+// Matches one body statement against the supported idioms and appends it to
+// the plan; scans attach to the reduction they append.
+static bool classify_stmt(ASTNode* stmt, const char* var, VectorOp** ops, NameSet* targets) {
+    if (!stmt || stmt->type != NODE_ASSIGNMENT) return false;
+    const char* t = stmt->assignment.var_name;
+    ASTNode* e = stmt->assignment.expr;
+    if (strcmp(t, var) == 0 || nameset_contains(targets, t)) return false;
+    if (!e) return false;
+    ASTNode* value = appended_element(e, t);
+    if (!value && e->type != NODE_BINARY_OP) return false;
+    ASTNode* l = value ? NULL : e->binary_op.left;
+    ASTNode* r = value ? NULL : e->binary_op.right;
+
+    VectorOp op = { VEC_SUM, t, NULL, false, NULL, NULL };
+    if (value) {
+        VectorOp* source = value->type == NODE_ID ? find_op(*ops, value->id_name) : NULL;
+        if (source) {
+            // Appending the running value of an earlier reduction: a prefix scan
+            if (source->kind == VEC_MAP || source->scan_into) return false;
+            source->scan_into = t;
+            nameset_add(targets, t);
+            return true;
+        }
+        op.kind = VEC_MAP;
+        op.term = value;
+    } else if (e->binary_op.op == OP_PLUS && is_named(l, t)) {
+        op.term = r;
+    } else if (e->binary_op.op == OP_PLUS && is_named(r, t)) {
+        op.term = l;
+    } else if (e->binary_op.op == OP_MINUS && is_named(l, t)) {
+        op.term = r;
+        op.negate = true;
+    } else if (e->binary_op.op == OP_TIMES && is_named(l, t)) {
+        op.kind = VEC_PRODUCT;
+        op.term = r;
+    } else if (e->binary_op.op == OP_TIMES && is_named(r, t)) {
+        op.kind = VEC_PRODUCT;
+        op.term = l;
+    } else {
+        return false;
+    }
+    if (op.term->type == NODE_VECTOR_LITERAL) return false;
+
+    VectorOp* copy = malloc(sizeof(VectorOp));
+    *copy = op;
+    VectorOp** tail = ops;
+    while (*tail) tail = &(*tail)->next;
+    *tail = copy;
+    nameset_add(targets, t);
+    return true;
+}
+
+// Number of iterations of a counted loop with a literal bound
+static long trip_count(const CountedLoop* info, double bound) {
+    double end = info->step > 0 ? ceil(bound) : floor(bound);
+    double span = info->step > 0 ? end - info->start : info->start - end;
+    if (span <= 0) return 0;
+    double step = labs(info->step);
+    double n = ceil(span / step);
+    return n > VEC_MAX_TRIP ? VEC_MAX_TRIP + 1 : (long)n;
+}
+
+static bool plan_loop(ASTNode* loop, ASTList* stmts, ASTList* loop_pos) {
+    CountedLoop info;
+    if (!match_counted_loop(loop, &info) || info.bound->type != NODE_NUMBER) return false;
+    if (!loop->for_loop.body) return false;
+    long n = trip_count(&info, info.bound->num_value);
+    if (n > VEC_MAX_TRIP) return false;
+
+    Interval iv;
+    double first = (double)info.start;
+    double last = n > 0 ? first + (double)(n - 1) * info.step : first;
+    iv.lo = fmin(first, last);
+    iv.hi = fmax(first, last);
+
+    VectorOp* ops = NULL;
+    NameSet targets;
+    nameset_init(&targets);
+    bool ok = true;
+    for (ASTList* s = loop->for_loop.body; s && ok; s = s->next)
+        ok = classify_stmt(s->node, info.var, &ops, &targets);
+    nameset_free(&targets);
+
+    // Prove every value NumPy computes fits in int64
+    for (VectorOp* op = ops; op && ok; op = op->next) {
+        Interval range;
+        if (!term_range(op->term, info.var, iv, &range)) { ok = false; break; }
+        if (op->kind == VEC_MAP) continue;
+        long init;
+        if (!initial_value(stmts, loop_pos, op->target, &init)) { ok = false; break; }
+        double m = fmax(fabs(range.lo), fabs(range.hi));
+        if (op->kind == VEC_SUM) {
+            ok = fabs((double)init) + (double)n * m < VEC_INT_LIMIT;
+        } else {
+            double bits = log2(fmax(fabs((double)init), 1.0)) + (double)n * log2(fmax(m, 1.0));
+            ok = bits < 62.0;
+        }
+    }
+    if (!ok) {
+        free_ops(ops);
+        return false;
+    }
+    loop->for_loop.vector_ops = ops;
+    return true;
+}
+
+static void vectorize_list(ASTList* stmts) {
+    for (ASTList* s = stmts; s; s = s->next) {
+        ASTNode* n = s->node;
+        if (!n) continue;
+        switch (n->type) {
+            case NODE_IF_ELSE:
+                vectorize_list(n->if_else.if_body);
+                vectorize_list(n->if_else.else_body);
+                break;
+            case NODE_WHILE_LOOP:
+                vectorize_list(n->while_loop.body);
+                break;
+            case NODE_FOR_LOOP:
+                if (!plan_loop(n, stmts, s))
+                    vectorize_list(n->for_loop.body);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void vectorize_loops(ASTNode* program) {
+    if (list_has_opaque_code(program->program.statements)) return;
+    vectorize_list(program->program.statements);
+}
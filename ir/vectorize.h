@@ -0,0 +1,9 @@
+#ifndef VECTORIZE_H
+#define VECTORIZE_H
+#include "ast.h"
+
+// Recognises sum/product reductions, their prefix scans and elementwise maps
+// in counted for loops and attaches a VectorOp plan codegen emits as NumPy.
+void vectorize_loops(ASTNode* program);
+
+#endif
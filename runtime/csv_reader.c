@@ -0,0 +1,631 @@
+#include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "csv_reader.h"
+#include "text_input.h"
+
+// Rows sampled to guess column types, as the compiler's schema reader does
+#define SAMPLE_ROWS 1000
+// Smallest byte range worth a thread of its own
+#define MIN_CHUNK_BYTES (1 << 20)
+#define MAX_THREADS 64
+
+// ---------------------------------------------------------------------------
+// Records
+//
+// Quotes follow Python's csv module: only a quote that opens a field starts
+// a quoted section, "" inside it is a literal quote, and whatever follows
+// the closing quote up to the next comma belongs to the field as is.
+// ---------------------------------------------------------------------------
+
+// Scans the record at p, storing the spans of its first `wanted` fields in
+// `fields` (may be NULL). Sets *count to the number of fields seen, 0 for a
+// blank line, and returns the start of the next record. Without quotes the
+// rest of a line is skipped once the wanted fields are found.
+static const char* scan_record(const char* p, const char* end, bool quotes,
+                               CsvSpan* fields, int wanted, int* count) {
+    int n = 0;
+    for (;;) {
+        const char* start = p;
+        bool quoted = quotes && p < end && *p == '"';
+        if (quoted) {
+            for (p++; p < end; p++) {
+                if (*p != '"') continue;
+                if (p + 1 < end && p[1] == '"') { p++; continue; }
+                p++;
+                break;
+            }
+        }
+        while (p < end && *p != ',' && *p != '\n') p++;
+        bool last = p == end || *p == '\n';
+        const char* stop = p;
+        if (last && stop > start && stop[-1] == '\r') stop--;
+        if (last && n == 0 && stop == start) {
+            *count = 0;
+            return p < end ? p + 1 : p;
+        }
+        if (fields && n < wanted) {
+            fields[n].start = start;
+            fields[n].len = stop - start;
+            fields[n].quoted = quoted;
+        }
+        n++;
+        if (last) {
+            *count = n;
+            return p < end ? p + 1 : p;
+        }
+        p++;   // ','
+        if (!quotes && fields && n >= wanted) {
+            const char* nl = memchr(p, '\n', end - p);
+            *count = n;
+            return nl ? nl + 1 : end;
+        }
+    }
+}
+
+size_t csv_unquote(const CsvSpan* span, char* out) {
+    const char* p = span->start;
+    const char* end = p + span->len;
+    size_t n = 0;
+    if (!span->quoted) {
+        memcpy(out, p, span->len);
+        return span->len;
+    }
+    for (p++; p < end; p++) {
+        if (*p == '"') {
+            if (p + 1 < end && p[1] == '"') { out[n++] = '"'; p++; continue; }
+            p++;
+            break;
+        }
+        // Text mode reading turns CRLF inside quoted fields into LF
+        if (*p == '\r' && p + 1 < end && p[1] == '\n') continue;
+        out[n++] = *p;
+    }
+    while (p < end) out[n++] = *p++;
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// Numbers
+//
+// Cells are accepted where Python's int()/float() would take them (surrounding
+// whitespace allowed).
+// ---------------------------------------------------------------------------
+
+// Trimmed bytes of a cell; quoted cells are decoded into buf first
+static bool cell_bytes(const CsvSpan* span, char* buf, const char** begin, const char** end) {
+    const char* b = span->start;
+    const char* e = b + span->len;
+    if (span->quoted) {
+        if (span->len >= MAX_NUMBER_LEN) return false;
+        b = buf;
+        e = buf + csv_unquote(span, buf);
+    }
+    while (b < e && isspace((unsigned char)*b)) b++;
+    while (e > b && isspace((unsigned char)e[-1])) e--;
+    if (b == e || e - b >= MAX_NUMBER_LEN) return false;
+    *begin = b;
+    *end = e;
+    return true;
+}
+
+static bool cell_int(const CsvSpan* span, int64_t* value) {
+    char buf[MAX_NUMBER_LEN];
+    const char *b, *e;
+    return cell_bytes(span, buf, &b, &e) && parse_int64(b, e, value);
+}
+
+static bool cell_float(const CsvSpan* span, double* value) {
+    char buf[MAX_NUMBER_LEN];
+    const char *b, *e;
+    return cell_bytes(span, buf, &b, &e) && parse_double(b, e, value);
+}
+
+// ---------------------------------------------------------------------------
+// Opening and column selection
+// ---------------------------------------------------------------------------
+
+static void read_header(CsvTable* table) {
+    table->header = malloc(sizeof(char*));
+    if (table->size == 0) return;
+
+    const char* end = table->data + table->size;
+    int count;
+    scan_record(table->data, end, true, NULL, 0, &count);
+    CsvSpan* spans = malloc((count > 0 ? count : 1) * sizeof(CsvSpan));
+    table->header = realloc(table->header, (count > 0 ? count : 1) * sizeof(char*));
+    const char* body = scan_record(table->data, end, true, spans, count, &count);
+    for (int i = 0; i < count; i++) {
+        table->header[i] = malloc(spans[i].len + 1);
+        table->header[i][csv_unquote(&spans[i], table->header[i])] = '\0';
+    }
+    free(spans);
+    table->field_count = count;
+    table->body = body - table->data;
+    table->limit = table->size;
+}
+
+bool csv_open(CsvTable* table, const char* path) {
+    memset(table, 0, sizeof(*table));
+    if (!open_text(path, &table->data, &table->size, &table->source)) return false;
+    read_header(table);
+    return true;
+}
+
+void csv_open_data(CsvTable* table, const char* data, size_t size) {
+    memset(table, 0, sizeof(*table));
+    table->data = size > 0 ? data : NULL;
+    table->size = size;
+    table->source = TEXT_BORROWED;
+    read_header(table);
+}
+
+// Offset of the first record starting at or after `offset`
+static size_t record_start(const CsvTable* table, size_t offset) {
+    if (offset <= table->body) return table->body;
+    if (offset >= table->size) return table->size;
+    const char* nl = memchr(table->data + offset - 1, '\n', table->size - offset + 1);
+    return nl ? (size_t)(nl + 1 - table->data) : table->size;
+}
+
+void csv_range(CsvTable* table, size_t start, size_t stop) {
+    size_t first = record_start(table, start);
+    size_t last = record_start(table, stop);
+    table->body = first;
+    table->limit = last > first ? last : first;
+}
+
+void csv_ranges(CsvTable* table, const size_t* bounds, int count) {
+    table->ranges = malloc((count > 0 ? 2 * count : 1) * sizeof(size_t));
+    table->range_count = 0;
+    size_t* r = table->ranges;
+    for (int i = 0; i < count; i++) {
+        size_t first = record_start(table, bounds[2 * i]);
+        size_t last = record_start(table, bounds[2 * i + 1]);
+        int n = table->range_count;
+        if (n > 0 && first < r[2 * n - 1]) first = r[2 * n - 1];
+        if (last <= first) continue;
+        if (n > 0 && first == r[2 * n - 1]) {
+            r[2 * n - 1] = last;   // adjacent blocks make one range
+            continue;
+        }
+        r[2 * n] = first;
+        r[2 * n + 1] = last;
+        table->range_count++;
+    }
+    // Only the type sample reads between the ranges
+    if (table->range_count > 0) {
+        table->body = r[0];
+        table->limit = r[2 * table->range_count - 1];
+    } else {
+        table->limit = table->body;
+    }
+    advise_sparse(table->source, table->data, table->size);
+}
+
+static void add_column(CsvTable* table, const char* name, int field) {
+    CsvColumn* c = &table->columns[table->column_count++];
+    c->name = strdup(name);
+    c->field = field;
+    c->kind = CSV_TEXT;
+    c->values = NULL;
+}
+
+// Index of the last header field called `name`, or -1
+static int last_field(const CsvTable* table, const char* name) {
+    for (int i = table->field_count - 1; i >= 0; i--)
+        if (strcmp(table->header[i], name) == 0) return i;
+    return -1;
+}
+
+bool csv_select(CsvTable* table, const char* const* names, int count) {
+    if (!names) {
+        // Like the keys of a csv.DictReader row: first position, last value
+        table->columns = malloc((table->field_count > 0 ? table->field_count : 1) * sizeof(CsvColumn));
+        for (int i = 0; i < table->field_count; i++) {
+            bool seen = false;
+            for (int j = 0; j < i && !seen; j++)
+                seen = strcmp(table->header[j], table->header[i]) == 0;
+            if (!seen) add_column(table, table->header[i], last_field(table, table->header[i]));
+        }
+        return true;
+    }
+    table->columns = malloc((count > 0 ? count : 1) * sizeof(CsvColumn));
+    for (int i = 0; i < count; i++) {
+        int field = last_field(table, names[i]);
+        if (field < 0) {
+            snprintf(table->error, sizeof(table->error), "%s", names[i]);
+            return false;
+        }
+        add_column(table, names[i], field);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Parsing
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    CsvTable* table;
+    const char* begin;
+    const char* end;
+    int wanted;           // fields to split out of each record
+    size_t rows;          // records in the range
+    bool quotes;          // the range contains a quote
+    size_t first_row;     // index of its first record
+    const bool* active;   // columns parsed in this pass
+    bool* need_float;     // an int column met a non-integer number
+    bool* need_text;      // a column met a cell that is not a number
+} Chunk;
+
+static void* count_chunk(void* arg) {
+    Chunk* c = arg;
+    const char* p = c->begin;
+    const char* done = c->begin;
+    size_t rows = 0;
+    int n;
+    if (c->table->quotes) {
+        while (p < c->end) {
+            p = scan_record(p, c->end, true, NULL, 0, &n);
+            if (n > 0) rows++;
+            if (p - done >= RELEASE_BYTES) done = release_behind(c->table->source, done, p);
+        }
+    } else {
+        while (p < c->end) {
+            const char* nl = memchr(p, '\n', c->end - p);
+            const char* stop = nl ? nl : c->end;
+            // Blank lines (possibly just "\r") hold no record
+            if (stop - p > 1 || (stop - p == 1 && *p != '\r')) rows++;
+            if (!c->quotes && memchr(p, '"', stop - p)) c->quotes = true;
+            p = nl ? nl + 1 : c->end;
+            if (p - done >= RELEASE_BYTES) done = release_behind(c->table->source, done, p);
+        }
+    }
+    release_behind(c->table->source, done, c->end);
+    c->rows = rows;
+    return NULL;
+}
+
+static void* fill_chunk(void* arg) {
+    Chunk* c = arg;
+    CsvTable* t = c->table;
+    CsvSpan* fields = malloc((c->wanted > 0 ? c->wanted : 1) * sizeof(CsvSpan));
+    const char* p = c->begin;
+    const char* done = c->begin;
+    size_t row = c->first_row;
+    int n;
+    while (p < c->end) {
+        p = scan_record(p, c->end, t->quotes, fields, c->wanted, &n);
+        if (p - done >= RELEASE_BYTES) done = release_behind(c->table->source, done, p);
+        if (n == 0) continue;
+        for (int i = 0; i < t->column_count; i++) {
+            if (!c->active[i] || c->need_text[i]) continue;
+            CsvColumn* col = &t->columns[i];
+            const CsvSpan* cell = col->field < n ? &fields[col->field] : NULL;
+            switch (col->kind) {
+                case CSV_INT: {
+                    int64_t v;
+                    double d;
+                    if (cell && cell_int(cell, &v)) ((int64_t*)col->values)[row] = v;
+                    else if (cell && cell_float(cell, &d)) c->need_float[i] = true;
+                    else c->need_text[i] = true;
+                    break;
+                }
+                case CSV_FLOAT: {
+                    double d;
+                    if (cell && cell_float(cell, &d)) ((double*)col->values)[row] = d;
+                    else c->need_text[i] = true;
+                    break;
+                }
+                case CSV_TEXT: {
+                    CsvSpan* out = &((CsvSpan*)col->values)[row];
+                    if (cell) *out = *cell;
+                    else out->start = NULL;
+                    break;
+                }
+            }
+        }
+        row++;
+    }
+    release_behind(c->table->source, done, c->end);
+    free(fields);
+    return NULL;
+}
+
+// Runs fn over every item on up to `workers` threads (the calling one
+// included), each taking the next item not yet started
+typedef struct {
+    char* items;
+    size_t size;
+    int count;
+    int next;
+    void* (*fn)(void*);
+} Pool;
+
+static void* pool_worker(void* arg) {
+    Pool* pool = arg;
+    for (;;) {
+        int i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED);
+        if (i >= pool->count) return NULL;
+        pool->fn(pool->items + (size_t)i * pool->size);
+    }
+}
+
+static void run_parallel(void* items, size_t size, int count, int workers, void* (*fn)(void*)) {
+    Pool pool = { items, size, count, 0, fn };
+    pthread_t threads[MAX_THREADS];
+    bool started[MAX_THREADS] = { false };
+    if (workers > count) workers = count;
+    if (workers > MAX_THREADS) workers = MAX_THREADS;
+    for (int i = 1; i < workers; i++)
+        started[i] = pthread_create(&threads[i], NULL, pool_worker, &pool) == 0;
+    pool_worker(&pool);
+    for (int i = 1; i < workers; i++)
+        if (started[i]) pthread_join(threads[i], NULL);
+}
+
+// Same rule as the compiler: int if every sampled cell is an integer, float
+// if every one is a number, text otherwise (also when there are no rows)
+static void infer_kinds(CsvTable* t, int wanted) {
+    CsvSpan* fields = malloc((wanted > 0 ? wanted : 1) * sizeof(CsvSpan));
+    bool* numeric = malloc((t->column_count > 0 ? t->column_count : 1) * sizeof(bool));
+    bool* fractional = calloc(t->column_count > 0 ? t->column_count : 1, sizeof(bool));
+    for (int i = 0; i < t->column_count; i++) numeric[i] = true;
+    const char* p = t->data + t->body;
+    const char* end = t->data + t->limit;
+    int rows = 0, n;
+    while (rows < SAMPLE_ROWS && p < end) {
+        p = scan_record(p, end, t->quotes, fields, wanted, &n);
+        if (n == 0) continue;
+        rows++;
+        for (int i = 0; i < t->column_count; i++) {
+            if (!numeric[i]) continue;
+            int f = t->columns[i].field;
+            int64_t v;
+            double d;
+            if (f < n && cell_int(&fields[f], &v)) continue;
+            if (f < n && cell_float(&fields[f], &d)) fractional[i] = true;
+            else numeric[i] = false;
+        }
+    }
+    for (int i = 0; i < t->column_count; i++)
+        t->columns[i].kind = rows == 0 || !numeric[i] ? CSV_TEXT : fractional[i] ? CSV_FLOAT : CSV_INT;
+    free(fields);
+    free(numeric);
+    free(fractional);
+}
+
+static size_t kind_size(CsvKind kind) {
+    return kind == CSV_INT ? sizeof(int64_t) : kind == CSV_FLOAT ? sizeof(double) : sizeof(CsvSpan);
+}
+
+static int default_threads(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+// Splits the records of t into `count` ranges, each ending right after a
+// newline; a table restricted by csv_ranges has exactly its own ranges
+static void split_ranges(CsvTable* t, Chunk* chunks, int count, int wanted) {
+    if (t->ranges) {
+        for (int i = 0; i < count; i++) {
+            chunks[i].table = t;
+            chunks[i].wanted = wanted;
+            chunks[i].begin = t->data + t->ranges[2 * i];
+            chunks[i].end = t->data + t->ranges[2 * i + 1];
+        }
+        return;
+    }
+    size_t length = t->limit - t->body;
+    const char* end = t->data + t->limit;
+    const char* start = t->data + t->body;
+    for (int i = 0; i < count; i++) {
+        Chunk* c = &chunks[i];
+        c->table = t;
+        c->wanted = wanted;
+        c->begin = start;
+        if (i == count - 1) {
+            c->end = end;
+        } else {
+            const char* cut = t->data + t->body + length * (i + 1) / count;
+            if (cut < start) cut = start;
+            const char* nl = cut > t->data ? memchr(cut - 1, '\n', end - (cut - 1)) : NULL;
+            c->end = nl ? nl + 1 : end;
+        }
+        start = c->end;
+    }
+}
+
+bool csv_read(CsvTable* t, int threads) {
+    return csv_read_files(t, 1, threads);
+}
+
+typedef struct {
+    CsvTable* table;
+    const char* path;
+    int error;            // errno of a failed open, else 0
+} OpenJob;
+
+static void* open_job(void* arg) {
+    OpenJob* job = arg;
+    job->error = csv_open(job->table, job->path) ? 0 : errno;
+    return NULL;
+}
+
+int csv_open_files(CsvTable* tables, const char* const* paths, int count, int threads) {
+    OpenJob* jobs = malloc((count > 0 ? count : 1) * sizeof(OpenJob));
+    for (int i = 0; i < count; i++)
+        jobs[i] = (OpenJob){ &tables[i], paths[i], 0 };
+    run_parallel(jobs, sizeof(OpenJob), count, threads > 0 ? threads : default_threads(), open_job);
+    int failed = -1;
+    for (int i = 0; i < count && failed < 0; i++)
+        if (jobs[i].error) failed = i;
+    if (failed >= 0) {
+        for (int i = 0; i < count; i++)
+            if (!jobs[i].error) csv_close(&tables[i]);
+        errno = jobs[failed].error;
+    }
+    free(jobs);
+    return failed;
+}
+
+bool csv_read_files(CsvTable* tables, int files, int threads) {
+    int workers = threads > 0 ? threads : default_threads();
+    if (workers > MAX_THREADS) workers = MAX_THREADS;
+    int columns = tables[0].column_count > 0 ? tables[0].column_count : 1;
+
+    // A file gets a range per MIN_CHUNK_BYTES, at most one per worker
+    int* first_chunk = malloc((files + 1) * sizeof(int));
+    int count = 0;
+    for (int f = 0; f < files; f++) {
+        size_t ranges = (tables[f].limit - tables[f].body) / MIN_CHUNK_BYTES;
+        first_chunk[f] = count;
+        if (tables[f].ranges) count += tables[f].range_count;
+        else count += ranges < 1 ? 1 : ranges > (size_t)workers ? workers : (int)ranges;
+    }
+    first_chunk[files] = count;
+    Chunk* chunks = calloc(count > 0 ? count : 1, sizeof(Chunk));
+    bool* active = malloc(columns * sizeof(bool));
+    bool* flags = calloc(2 * (size_t)count * columns, sizeof(bool));
+    for (int f = 0; f < files; f++) {
+        CsvTable* t = &tables[f];
+        int wanted = 0;
+        for (int i = 0; i < t->column_count; i++)
+            if (t->columns[i].field + 1 > wanted) wanted = t->columns[i].field + 1;
+        split_ranges(t, &chunks[first_chunk[f]], first_chunk[f + 1] - first_chunk[f], wanted);
+    }
+    for (int i = 0; i < count; i++) {
+        chunks[i].active = active;
+        chunks[i].need_float = flags + (2 * (size_t)i) * columns;
+        chunks[i].need_text = flags + (2 * (size_t)i + 1) * columns;
+    }
+
+    // Counting the records of every range first sizes each column once, for
+    // all files, so every range parses straight into its part of it
+    run_parallel(chunks, sizeof(Chunk), count, workers, count_chunk);
+    // Records may span lines once quotes appear, so such files are counted
+    // again as a single range. The ranges given to csv_ranges are kept, each
+    // counted again on its own.
+    Chunk* again = malloc((count > 0 ? count : 1) * sizeof(Chunk));
+    int* again_index = malloc((count > 0 ? count : 1) * sizeof(int));
+    int recount = 0;
+    for (int f = 0; f < files; f++) {
+        CsvTable* t = &tables[f];
+        for (int i = first_chunk[f]; i < first_chunk[f + 1]; i++)
+            t->quotes |= chunks[i].quotes;
+        if (!t->quotes || first_chunk[f] == first_chunk[f + 1]) continue;
+        if (t->ranges) {
+            for (int i = first_chunk[f]; i < first_chunk[f + 1]; i++) {
+                again_index[recount] = i;
+                again[recount++] = chunks[i];
+            }
+            continue;
+        }
+        Chunk* whole = &chunks[first_chunk[f]];
+        whole->end = t->data + t->limit;
+        for (int i = first_chunk[f] + 1; i < first_chunk[f + 1]; i++) {
+            chunks[i].begin = chunks[i].end = whole->end;
+            chunks[i].rows = 0;
+        }
+        again_index[recount] = first_chunk[f];
+        again[recount++] = *whole;
+    }
+    run_parallel(again, sizeof(Chunk), recount, workers, count_chunk);
+    for (int k = 0; k < recount; k++)
+        chunks[again_index[k]].rows = again[k].rows;
+    free(again);
+    free(again_index);
+
+    // A column is int if it is int in every file with rows, float if numeric
+    // in every one, text otherwise (also when no file has rows)
+    size_t rows = 0;
+    bool sampled = false;
+    for (int f = 0; f < files; f++) {
+        CsvTable* t = &tables[f];
+        t->rows = 0;
+        for (int i = first_chunk[f]; i < first_chunk[f + 1]; i++) {
+            chunks[i].first_row = rows;
+            rows += chunks[i].rows;
+            t->rows += chunks[i].rows;
+        }
+        if (!t->rows) continue;
+        infer_kinds(t, chunks[first_chunk[f]].wanted);
+        for (int i = 0; i < t->column_count; i++) {
+            CsvKind kind = t->columns[i].kind;
+            CsvKind* joined = &tables[0].columns[i].kind;
+            if (sampled && (*joined == CSV_TEXT || kind == CSV_TEXT)) *joined = CSV_TEXT;
+            else if (sampled && (*joined == CSV_FLOAT || kind == CSV_FLOAT)) *joined = CSV_FLOAT;
+            else *joined = kind;
+        }
+        sampled = true;
+    }
+    for (int i = 0; i < tables[0].column_count; i++) {
+        if (!sampled) tables[0].columns[i].kind = CSV_TEXT;
+        for (int f = 1; f < files; f++)
+            tables[f].columns[i].kind = tables[0].columns[i].kind;
+    }
+
+    // The columns of tables[0] hold the rows of every file; the other tables
+    // share them while parsing
+    for (int i = 0; i < tables[0].column_count; i++) active[i] = true;
+    bool ok = true;
+    for (;;) {
+        bool any = false;
+        for (int i = 0; i < tables[0].column_count; i++) {
+            CsvColumn* col = &tables[0].columns[i];
+            if (!active[i]) continue;
+            free(col->values);
+            col->values = malloc((rows > 0 ? rows : 1) * kind_size(col->kind));
+            if (!col->values) ok = false;
+            for (int f = 1; f < files; f++)
+                tables[f].columns[i].values = col->values;
+            any = true;
+        }
+        if (!any || !ok) break;
+        memset(flags, 0, 2 * (size_t)count * columns * sizeof(bool));
+        run_parallel(chunks, sizeof(Chunk), count, workers, fill_chunk);
+        // Columns whose later cells do not fit the sample are parsed again
+        for (int i = 0; i < tables[0].column_count; i++) {
+            CsvKind kind = tables[0].columns[i].kind;
+            bool to_float = false, to_text = false;
+            for (int j = 0; j < count; j++) {
+                to_float |= chunks[j].need_float[i];
+                to_text |= chunks[j].need_text[i];
+            }
+            active[i] = to_text || (to_float && kind == CSV_INT);
+            if (to_text) kind = CSV_TEXT;
+            else if (to_float && kind == CSV_INT) kind = CSV_FLOAT;
+            for (int f = 0; f < files; f++)
+                tables[f].columns[i].kind = kind;
+        }
+    }
+    for (int f = 1; f < files; f++)
+        for (int i = 0; i < tables[f].column_count; i++)
+            tables[f].columns[i].values = NULL;
+    tables[0].rows = rows;
+    if (!ok) snprintf(tables[0].error, sizeof(tables[0].error), "out of memory reading %zu rows", rows);
+    free(first_chunk);
+    free(chunks);
+    free(active);
+    free(flags);
+    return ok;
+}
+
+void csv_close(CsvTable* table) {
+    for (int i = 0; i < table->column_count; i++) {
+        free(table->columns[i].name);
+        free(table->columns[i].values);
+    }
+    free(table->columns);
+    for (int i = 0; i < table->field_count; i++)
+        free(table->header[i]);
+    free(table->header);
+    free(table->ranges);
+    close_text(table->data, table->size, table->source);
+    memset(table, 0, sizeof(*table));
+}
@@ -0,0 +1,93 @@
+#ifndef CSV_READER_H
+#define CSV_READER_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "text_input.h"
+
+// Typed, multithreaded CSV reader behind wizuall_rt.read_csv. The file is
+// memory-mapped (a gzip file is decompressed into memory first) and its
+// records are split into byte ranges parsed in parallel. Rows are the ones csv.DictReader yields: blank lines are skipped,
+// and missing fields are reported as absent.
+
+typedef enum {
+    CSV_INT,     // every cell is an integer that fits int64
+    CSV_FLOAT,   // every cell is a number
+    CSV_TEXT     // anything else; cells stay spans of the file
+} CsvKind;
+
+// A text cell. `start` is NULL when the record is too short to have it;
+// quoted cells must be decoded with csv_unquote.
+typedef struct {
+    const char* start;
+    size_t len;
+    bool quoted;
+} CsvSpan;
+
+typedef struct {
+    char* name;
+    int field;        // index of the field in each record
+    CsvKind kind;
+    void* values;     // int64_t*, double* or CsvSpan*, one per row
+} CsvColumn;
+
+typedef struct {
+    const char* data;     // text of the file
+    size_t size;
+    TextSource source;
+    size_t body;          // offset of the first record after the header
+    size_t limit;         // offset where the records to read end
+    size_t* ranges;       // csv_ranges: [start, stop) offset pairs of the records to read, else NULL
+    int range_count;
+    bool quotes;          // the body contains quotes: records may span lines (set by csv_read)
+    int field_count;
+    char** header;
+    size_t rows;
+    int column_count;
+    CsvColumn* columns;
+    char error[256];
+} CsvTable;
+
+// Maps the file (decompressing gzip) and parses its header
+bool csv_open(CsvTable* table, const char* path);
+
+// Opens several files on the worker pool. Returns -1, or the index of the
+// first file that failed with errno set and none of them left open.
+int csv_open_files(CsvTable* tables, const char* const* paths, int count, int threads);
+
+// Reads CSV text held by the caller, which must outlive the table
+void csv_open_data(CsvTable* table, const char* data, size_t size);
+
+// Restricts reading to the records that start within bytes [start, stop) of
+// the file, so a large file can be read in independent blocks. Records
+// spanning lines (quoted line breaks) must not cross a block boundary.
+void csv_range(CsvTable* table, size_t start, size_t stop);
+
+// Restricts reading to the records that start within the given byte ranges
+// (count pairs of start and stop, in order), e.g. random blocks of the file
+// for a preview. As with csv_range, records must not span a boundary.
+void csv_ranges(CsvTable* table, const size_t* bounds, int count);
+
+// Selects the columns to read: the named ones in that order, or every
+// distinct header name when names is NULL. The last of duplicate headers wins.
+bool csv_select(CsvTable* table, const char* const* names, int count);
+
+// Infers the column types from a sample, then parses the selected columns
+// with up to `threads` threads (0: one per CPU). A column whose later cells do
+// not fit the sampled type is parsed again as float or text.
+bool csv_read(CsvTable* table, int threads);
+
+// Reads the same selected columns (csv_select with the same names) of several
+// files as one table, the rows of tables[0] first. The records of every file
+// are counted on the worker pool first, so each column is allocated once at
+// its full length and every range of every file parses straight into its
+// part of it. The columns and total row count end up in tables[0].
+bool csv_read_files(CsvTable* tables, int count, int threads);
+
+// Decodes a quoted cell into out (at least span->len bytes); returns its length
+size_t csv_unquote(const CsvSpan* span, char* out);
+
+// Frees the columns and unmaps the file; text spans are invalid afterwards
+void csv_close(CsvTable* table);
+
+#endif
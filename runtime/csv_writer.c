@@ -0,0 +1,232 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "csv_writer.h"
+
+// Records are formatted into a buffer of this size, written out as it fills
+#define WRITE_BUFFER (1 << 20)
+// Longest number csv_format_double or format_int produce
+#define MAX_CELL 32
+
+typedef struct {
+    int fd;
+    char* buf;
+    size_t used;
+} Output;
+
+static bool flush_output(Output* out) {
+    size_t done = 0;
+    while (done < out->used) {
+        ssize_t n = write(out->fd, out->buf + done, out->used - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        done += (size_t)n;
+    }
+    out->used = 0;
+    return true;
+}
+
+static bool reserve(Output* out, size_t n) {
+    return out->used + n <= WRITE_BUFFER || flush_output(out);
+}
+
+static bool put(Output* out, const char* data, size_t len) {
+    while (len) {
+        if (out->used == WRITE_BUFFER && !flush_output(out)) return false;
+        size_t n = WRITE_BUFFER - out->used;
+        if (n > len) n = len;
+        memcpy(out->buf + out->used, data, n);
+        out->used += n;
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+// As csv.writer with QUOTE_MINIMAL: quoted when it holds a comma, a quote or
+// a line break (quotes doubled), and when it is the only, empty, field of a
+// record, which would otherwise read as a blank line
+static bool put_text(Output* out, const char* text, size_t len, bool alone) {
+    if (!len) return alone ? put(out, "\"\"", 2) : true;
+    bool quote = false;
+    for (size_t i = 0; i < len && !quote; i++)
+        quote = text[i] == ',' || text[i] == '"' || text[i] == '\n' || text[i] == '\r';
+    if (!quote) return put(out, text, len);
+    if (!put(out, "\"", 1)) return false;
+    while (len) {
+        const char* q = memchr(text, '"', len);
+        size_t n = q ? (size_t)(q - text) + 1 : len;
+        if (!put(out, text, n) || (q && !put(out, "\"", 1))) return false;
+        text += n;
+        len -= n;
+    }
+    return put(out, "\"", 1);
+}
+
+static size_t format_int(int64_t v, char* buf) {
+    char digits[20];
+    int n = 0;
+    uint64_t u = v < 0 ? 0 - (uint64_t)v : (uint64_t)v;
+    do {
+        digits[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    size_t len = 0;
+    if (v < 0) buf[len++] = '-';
+    while (n) buf[len++] = digits[--n];
+    return len;
+}
+
+// r / 10^k in fixed notation, with at least one digit on each side of the point
+static size_t format_fixed(uint64_t r, int k, char* buf) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + r % 10);
+        r /= 10;
+    } while (r);
+    while (n <= k) digits[n++] = '0';
+    size_t len = 0;
+    while (n > k) buf[len++] = digits[--n];
+    buf[len++] = '.';
+    if (!k) buf[len++] = '0';
+    while (n) buf[len++] = digits[--n];
+    return len;
+}
+
+// The shortest of the correctly rounded 15, 16 and 17 significant digits that
+// reads back as v (17 always does), laid out as repr() lays it out: fixed
+// notation for decimal exponents in [-4, 16), else d.ddde+XX. v > 0.
+// Subnormals hold fewer digits, so every precision is tried for them.
+static size_t format_shortest(double v, char* buf) {
+    char sci[40];
+    for (int p = v < DBL_MIN ? 1 : 15; p <= 17; p++) {
+        snprintf(sci, sizeof(sci), "%.*e", p - 1, v);
+        if (p == 17 || strtod(sci, NULL) == v) break;
+    }
+    char digits[20];
+    int n = 0;
+    const char* c = sci;
+    for (; *c != 'e'; c++)
+        if (*c != '.') digits[n++] = *c;
+    int exp = atoi(c + 1);
+    // Below 15 digits the rounded form is the shortest one padded with zeros
+    while (n > 1 && digits[n - 1] == '0') n--;
+
+    size_t len = 0;
+    if (exp >= -4 && exp < 16) {
+        if (exp < 0) {
+            buf[len++] = '0';
+            buf[len++] = '.';
+            for (int i = -1; i > exp; i--) buf[len++] = '0';
+            for (int i = 0; i < n; i++) buf[len++] = digits[i];
+            return len;
+        }
+        for (int i = 0; i <= exp; i++) buf[len++] = i < n ? digits[i] : '0';
+        buf[len++] = '.';
+        if (n <= exp + 1) buf[len++] = '0';
+        for (int i = exp + 1; i < n; i++) buf[len++] = digits[i];
+        return len;
+    }
+    buf[len++] = digits[0];
+    if (n > 1) {
+        buf[len++] = '.';
+        for (int i = 1; i < n; i++) buf[len++] = digits[i];
+    }
+    return len + (size_t)sprintf(buf + len, "e%c%02d", exp < 0 ? '-' : '+', exp < 0 ? -exp : exp);
+}
+
+size_t csv_format_double(double v, char* buf) {
+    static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+    };
+    if (isnan(v)) {
+        memcpy(buf, "nan", 3);
+        return 3;
+    }
+    size_t len = 0;
+    if (signbit(v)) {
+        buf[len++] = '-';
+        v = -v;
+    }
+    if (isinf(v)) {
+        memcpy(buf + len, "inf", 3);
+        return len + 3;
+    }
+    if (v == 0) {
+        memcpy(buf + len, "0.0", 3);
+        return len + 3;
+    }
+    // Data usually has a few decimals: v is the integer r over 10^k when r / 10^k
+    // (one correctly rounded division) reads back as v, and the smallest such k
+    // gives repr's digits. Below 10^15 only one r can read back as v.
+    if (v >= 1e-4) {
+        for (int k = 0; k < 16; k++) {
+            double t = v * powers[k];
+            if (t >= 1e15) break;
+            double r = nearbyint(t);
+            if (r / powers[k] == v) return len + format_fixed((uint64_t)r, k, buf + len);
+        }
+    }
+    return len + format_shortest(v, buf + len);
+}
+
+bool csv_write(const char* path, const CsvOutColumn* columns, int count) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) return false;
+    Output out = { fd, malloc(WRITE_BUFFER), 0 };
+    if (!out.buf) {
+        close(fd);
+        errno = ENOMEM;
+        return false;
+    }
+    size_t rows = 0;
+    for (int i = 0; i < count; i++)
+        if (columns[i].count > rows) rows = columns[i].count;
+
+    bool alone = count == 1;
+    bool ok = true;
+    for (int i = 0; ok && i < count; i++)
+        ok = (!i || put(&out, ",", 1)) && put_text(&out, columns[i].name, strlen(columns[i].name), alone);
+    ok = ok && put(&out, "\n", 1);
+    for (size_t r = 0; ok && r < rows; r++) {
+        for (int i = 0; ok && i < count; i++) {
+            const CsvOutColumn* c = &columns[i];
+            if (i && !(ok = put(&out, ",", 1))) break;
+            if (r >= c->count) {
+                ok = put_text(&out, "", 0, alone);
+                continue;
+            }
+            switch (c->kind) {
+                case CSV_OUT_INT:
+                    if ((ok = reserve(&out, MAX_CELL)))
+                        out.used += format_int(((const int64_t*)c->values)[r], out.buf + out.used);
+                    break;
+                case CSV_OUT_FLOAT:
+                    if ((ok = reserve(&out, MAX_CELL)))
+                        out.used += csv_format_double(((const double*)c->values)[r], out.buf + out.used);
+                    break;
+                case CSV_OUT_TEXT:
+                    ok = put_text(&out, ((const char* const*)c->values)[r], c->lens[r], alone);
+                    break;
+            }
+        }
+        ok = ok && put(&out, "\n", 1);
+    }
+    ok = ok && flush_output(&out);
+    int saved = errno;
+    free(out.buf);
+    if (close(fd) < 0 && ok) {
+        ok = false;
+        saved = errno;
+    }
+    errno = saved;
+    return ok;
+}
@@ -0,0 +1,33 @@
+#ifndef CSV_WRITER_H
+#define CSV_WRITER_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// CSV writer behind wizuall_rt.write_csv, for `export ... to "f.csv"`. Numbers
+// are formatted as str() formats them (floats in their shortest round-trip
+// form), text cells are quoted like csv.writer does, and the records go
+// through one large buffer straight to the file.
+
+typedef enum {
+    CSV_OUT_INT,     // int64_t values
+    CSV_OUT_FLOAT,   // double values
+    CSV_OUT_TEXT     // UTF-8 cells: const char* values with byte lengths in `lens`
+} CsvOutKind;
+
+typedef struct {
+    const char* name;     // header cell
+    CsvOutKind kind;
+    const void* values;
+    const size_t* lens;
+    size_t count;
+} CsvOutColumn;
+
+// Writes a header and one record per row of the longest column; shorter
+// columns leave their cells empty. Fails with errno set.
+bool csv_write(const char* path, const CsvOutColumn* columns, int count);
+
+// Formats v as repr(v) does into buf (at least 32 bytes) and returns its length
+size_t csv_format_double(double v, char* buf);
+
+#endif
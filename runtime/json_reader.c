@@ -0,0 +1,469 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "json_reader.h"
+#include "text_input.h"
+
+// Deeper values are rejected, as Python's recursion limit rejects them
+#define MAX_DEPTH 1000
+// First capacity of a numeric array, doubled as it fills
+#define FIRST_CAPACITY 1024
+
+typedef struct {
+    const char* p;
+    const char* end;
+    const char* done;     // start of the pages not yet released
+    JsonDocument* doc;
+} Parser;
+
+typedef enum { SCALAR_INT, SCALAR_FLOAT, SCALAR_NULL } ScalarKind;
+
+typedef union {
+    int64_t i;
+    double d;
+} Number;
+
+static bool fail(Parser* ps, const char* what) {
+    if (!ps->doc->error[0])
+        snprintf(ps->doc->error, sizeof(ps->doc->error), "%s at offset %zu", what, (size_t)(ps->p - ps->doc->data));
+    return false;
+}
+
+static bool no_memory(Parser* ps) {
+    ps->doc->no_memory = true;
+    snprintf(ps->doc->error, sizeof(ps->doc->error), "out of memory");
+    return false;
+}
+
+static void skip_ws(Parser* ps) {
+    while (ps->p < ps->end && (*ps->p == ' ' || *ps->p == '\t' || *ps->p == '\n' || *ps->p == '\r'))
+        ps->p++;
+}
+
+static bool at(Parser* ps, char c) {
+    return ps->p < ps->end && *ps->p == c;
+}
+
+static void progress(Parser* ps) {
+    if (ps->p - ps->done >= RELEASE_BYTES) ps->done = release_behind(ps->doc->source, ps->done, ps->p);
+}
+
+// ---------------------------------------------------------------------------
+// Strings
+// ---------------------------------------------------------------------------
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// The code unit of the \uXXXX escape at p, or -1
+static long escape_unit(const char* p, const char* end) {
+    if (end - p < 6 || p[0] != '\\' || p[1] != 'u') return -1;
+    long unit = 0;
+    for (int i = 2; i < 6; i++) {
+        int d = hex_digit(p[i]);
+        if (d < 0) return -1;
+        unit = unit * 16 + d;
+    }
+    return unit;
+}
+
+static char* put_utf8(char* out, long cp) {
+    if (cp < 0x80) {
+        *out++ = (char)cp;
+    } else if (cp < 0x800) {
+        *out++ = (char)(0xC0 | cp >> 6);
+        *out++ = (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = (char)(0xE0 | cp >> 12);
+        *out++ = (char)(0x80 | (cp >> 6 & 0x3F));
+        *out++ = (char)(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = (char)(0xF0 | cp >> 18);
+        *out++ = (char)(0x80 | (cp >> 12 & 0x3F));
+        *out++ = (char)(0x80 | (cp >> 6 & 0x3F));
+        *out++ = (char)(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+// Decodes the escapes of a validated string body; the result is never longer
+static void decode_string(const char* p, const char* end, char* out) {
+    while (p < end) {
+        if (*p != '\\') {
+            *out++ = *p++;
+            continue;
+        }
+        char c = p[1];
+        if (c != 'u') {
+            switch (c) {
+                case 'b': *out++ = '\b'; break;
+                case 'f': *out++ = '\f'; break;
+                case 'n': *out++ = '\n'; break;
+                case 'r': *out++ = '\r'; break;
+                case 't': *out++ = '\t'; break;
+                default: *out++ = c; break;   // " \ /
+            }
+            p += 2;
+            continue;
+        }
+        long cp = escape_unit(p, end);
+        p += 6;
+        if (cp >= 0xD800 && cp < 0xDC00) {
+            long low = escape_unit(p, end);
+            if (low >= 0xDC00 && low < 0xE000) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                p += 6;
+            }
+        }
+        out = put_utf8(out, cp);
+    }
+    *out = '\0';
+}
+
+// Scans the string at ps->p; stores it decoded and malloc'd in *out unless
+// out is NULL
+static bool scan_string(Parser* ps, char** out) {
+    const char* begin = ++ps->p;
+    for (;;) {
+        if (ps->p == ps->end) return fail(ps, "unterminated string");
+        unsigned char c = (unsigned char)*ps->p;
+        if (c == '"') break;
+        if (c < 0x20) return fail(ps, "invalid control character");
+        if (c != '\\') {
+            ps->p++;
+            continue;
+        }
+        if (ps->end - ps->p < 2) return fail(ps, "unterminated string");
+        if (ps->p[1] == 'u') {
+            if (escape_unit(ps->p, ps->end) < 0) return fail(ps, "invalid \\uXXXX escape");
+            ps->p += 6;
+        } else if (ps->p[1] && strchr("\"\\/bfnrt", ps->p[1])) {
+            ps->p += 2;
+        } else {
+            return fail(ps, "invalid escape");
+        }
+    }
+    if (out) {
+        *out = malloc(ps->p - begin + 1);
+        if (!*out) return no_memory(ps);
+        decode_string(begin, ps->p, *out);
+    }
+    ps->p++;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Numbers and literals
+// ---------------------------------------------------------------------------
+
+static bool is_digit(const char* p, const char* end) {
+    return p < end && (unsigned)(*p - '0') <= 9;
+}
+
+// Length of the JSON number at p (0 if there is none); integral is set when
+// it has neither fraction nor exponent
+static size_t number_length(const char* p, const char* end, bool* integral) {
+    const char* q = p;
+    if (q < end && *q == '-') q++;
+    if (!is_digit(q, end)) return 0;
+    if (*q++ != '0')
+        while (is_digit(q, end)) q++;
+    *integral = true;
+    if (q < end && *q == '.' && is_digit(q + 1, end)) {
+        for (q++; is_digit(q, end); q++) {}
+        *integral = false;
+    }
+    if (q < end && (*q == 'e' || *q == 'E')) {
+        const char* e = q + 1;
+        if (e < end && (*e == '+' || *e == '-')) e++;
+        if (is_digit(e, end)) {
+            for (q = e; is_digit(q, end); q++) {}
+            *integral = false;
+        }
+    }
+    return q - p;
+}
+
+static bool number_value(const char* p, size_t len, bool integral, ScalarKind* kind, Number* value) {
+    if (integral && parse_int64(p, p + len, &value->i)) {
+        *kind = SCALAR_INT;
+        return true;
+    }
+    // Integers beyond int64 become floats, as NumPy would need an object array
+    *kind = SCALAR_FLOAT;
+    if (len < MAX_NUMBER_LEN) return parse_double(p, p + len, &value->d);
+    char* buf = malloc(len + 1);
+    if (!buf) return false;
+    memcpy(buf, p, len);
+    buf[len] = '\0';
+    value->d = strtod(buf, NULL);
+    free(buf);
+    return true;
+}
+
+static bool literal(Parser* ps, const char* word) {
+    size_t n = strlen(word);
+    if ((size_t)(ps->end - ps->p) < n || memcmp(ps->p, word, n) != 0) return false;
+    ps->p += n;
+    return true;
+}
+
+// Scans a number or literal. Booleans read as 0/1 and NaN/Infinity as the
+// json module reads them; value may be NULL to only validate.
+static bool scan_scalar(Parser* ps, ScalarKind* kind, Number* value) {
+    bool integral;
+    size_t len = number_length(ps->p, ps->end, &integral);
+    ScalarKind k = SCALAR_NULL;
+    Number v = { 0 };
+    if (len > 0) {
+        if (value && !number_value(ps->p, len, integral, &k, &v)) return no_memory(ps);
+        ps->p += len;
+    } else if (literal(ps, "true")) {
+        k = SCALAR_INT;
+        v.i = 1;
+    } else if (literal(ps, "false")) {
+        k = SCALAR_INT;
+    } else if (literal(ps, "NaN")) {
+        k = SCALAR_FLOAT;
+        v.d = NAN;
+    } else if (literal(ps, "Infinity")) {
+        k = SCALAR_FLOAT;
+        v.d = INFINITY;
+    } else if (literal(ps, "-Infinity")) {
+        k = SCALAR_FLOAT;
+        v.d = -INFINITY;
+    } else if (!literal(ps, "null")) {
+        return fail(ps, "expected a value");
+    }
+    if (value) {
+        *kind = k;
+        *value = v;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Values
+// ---------------------------------------------------------------------------
+
+static bool skip_value(Parser* ps, int depth) {
+    if (depth > MAX_DEPTH) return fail(ps, "nesting too deep");
+    skip_ws(ps);
+    if (ps->p == ps->end) return fail(ps, "expected a value");
+    if (*ps->p == '"') return scan_string(ps, NULL);
+    if (*ps->p != '[' && *ps->p != '{') return scan_scalar(ps, NULL, NULL);
+
+    bool object = *ps->p == '{';
+    char close = object ? '}' : ']';
+    ps->p++;
+    skip_ws(ps);
+    if (at(ps, close)) {
+        ps->p++;
+        return true;
+    }
+    for (;;) {
+        if (object) {
+            skip_ws(ps);
+            if (!at(ps, '"')) return fail(ps, "expected a key");
+            if (!scan_string(ps, NULL)) return false;
+            skip_ws(ps);
+            if (!at(ps, ':')) return fail(ps, "expected ':'");
+            ps->p++;
+        }
+        if (!skip_value(ps, depth + 1)) return false;
+        skip_ws(ps);
+        progress(ps);
+        if (at(ps, ',')) {
+            ps->p++;
+            continue;
+        }
+        if (at(ps, close)) {
+            ps->p++;
+            return true;
+        }
+        return fail(ps, object ? "expected ',' or '}'" : "expected ',' or ']'");
+    }
+}
+
+static bool other_value(Parser* ps, JsonValue* v) {
+    skip_ws(ps);
+    const char* start = ps->p;
+    if (!skip_value(ps, 1)) return false;
+    v->kind = JSON_OTHER;
+    v->text = start;
+    v->len = ps->p - start;
+    return true;
+}
+
+// An array of numbers goes into one buffer of 8-byte slots: int64 until the
+// first float, when the slots filled so far are converted in place.
+// Anything else is rescanned as an ordinary value.
+static bool read_value(Parser* ps, JsonValue* v) {
+    skip_ws(ps);
+    const char* start = ps->p;
+    if (!at(ps, '[')) return other_value(ps, v);
+    ps->p++;
+    skip_ws(ps);
+    if (at(ps, ']')) {
+        ps->p = start;
+        return other_value(ps, v);
+    }
+    Number* buf = NULL;
+    size_t n = 0, cap = 0;
+    bool floats = false;
+    for (;;) {
+        skip_ws(ps);
+        if (ps->p == ps->end || *ps->p == '"' || *ps->p == '[' || *ps->p == '{') break;
+        ScalarKind kind;
+        Number value;
+        if (!scan_scalar(ps, &kind, &value)) {
+            free(buf);
+            return false;
+        }
+        if (kind == SCALAR_NULL) break;
+        if (n == cap) {
+            cap = cap ? cap * 2 : FIRST_CAPACITY;
+            Number* grown = realloc(buf, cap * sizeof(Number));
+            if (!grown) {
+                free(buf);
+                return no_memory(ps);
+            }
+            buf = grown;
+        }
+        if (kind == SCALAR_FLOAT && !floats) {
+            for (size_t i = 0; i < n; i++)
+                buf[i].d = (double)buf[i].i;
+            floats = true;
+        }
+        if (floats && kind == SCALAR_INT) buf[n++].d = (double)value.i;
+        else buf[n++] = value;
+        skip_ws(ps);
+        progress(ps);
+        if (at(ps, ',')) {
+            ps->p++;
+            continue;
+        }
+        if (at(ps, ']')) {
+            ps->p++;
+            Number* fitted = realloc(buf, n * sizeof(Number));
+            v->kind = floats ? JSON_FLOAT : JSON_INT;
+            v->values = fitted ? fitted : buf;
+            v->count = n;
+            return true;
+        }
+        free(buf);
+        return fail(ps, "expected ',' or ']'");
+    }
+    free(buf);
+    ps->p = start;
+    return other_value(ps, v);
+}
+
+// ---------------------------------------------------------------------------
+// Document
+// ---------------------------------------------------------------------------
+
+bool json_open(JsonDocument* doc, const char* path) {
+    memset(doc, 0, sizeof(*doc));
+    return open_text(path, &doc->data, &doc->size, &doc->source);
+}
+
+static bool wanted(const char* key, const char* const* names, int count) {
+    if (!names) return true;
+    for (int i = 0; i < count; i++)
+        if (strcmp(names[i], key) == 0) return true;
+    return false;
+}
+
+// Like a dict: a repeated key keeps its first position and takes the new value
+static bool store(Parser* ps, JsonValue* v) {
+    JsonDocument* doc = ps->doc;
+    for (int i = 0; i < doc->count; i++) {
+        if (strcmp(doc->values[i].name, v->name) == 0) {
+            free(doc->values[i].name);
+            free(doc->values[i].values);
+            doc->values[i] = *v;
+            return true;
+        }
+    }
+    if ((doc->count & (doc->count - 1)) == 0) {
+        JsonValue* grown = realloc(doc->values, (doc->count ? doc->count * 2 : 1) * sizeof(JsonValue));
+        if (!grown) return no_memory(ps);
+        doc->values = grown;
+    }
+    doc->values[doc->count++] = *v;
+    return true;
+}
+
+static bool read_members(Parser* ps, const char* const* names, int count) {
+    ps->p++;   // '{'
+    skip_ws(ps);
+    if (at(ps, '}')) {
+        ps->p++;
+        return true;
+    }
+    for (;;) {
+        JsonValue v = { 0 };
+        skip_ws(ps);
+        if (!at(ps, '"')) return fail(ps, "expected a key");
+        if (!scan_string(ps, &v.name)) return false;
+        skip_ws(ps);
+        if (!at(ps, ':')) {
+            free(v.name);
+            return fail(ps, "expected ':'");
+        }
+        ps->p++;
+        bool ok;
+        if (wanted(v.name, names, count)) {
+            ok = read_value(ps, &v) && store(ps, &v);
+            if (!ok) {
+                free(v.name);
+                free(v.values);
+            }
+        } else {
+            free(v.name);
+            ok = skip_value(ps, 1);
+        }
+        if (!ok) return false;
+        skip_ws(ps);
+        progress(ps);
+        if (at(ps, ',')) {
+            ps->p++;
+            continue;
+        }
+        if (at(ps, '}')) {
+            ps->p++;
+            return true;
+        }
+        return fail(ps, "expected ',' or '}'");
+    }
+}
+
+bool json_read(JsonDocument* doc, const char* const* names, int count) {
+    Parser ps = { doc->data, doc->data + doc->size, doc->data, doc };
+    skip_ws(&ps);
+    if (!at(&ps, '{')) {
+        snprintf(doc->error, sizeof(doc->error), "expected a JSON object");
+        return false;
+    }
+    if (!read_members(&ps, names, count)) return false;
+    skip_ws(&ps);
+    if (ps.p != ps.end) return fail(&ps, "extra data");
+    release_behind(doc->source, ps.done, ps.end);
+    return true;
+}
+
+void json_close(JsonDocument* doc) {
+    for (int i = 0; i < doc->count; i++) {
+        free(doc->values[i].name);
+        free(doc->values[i].values);
+    }
+    free(doc->values);
+    close_text(doc->data, doc->size, doc->source);
+    memset(doc, 0, sizeof(*doc));
+}
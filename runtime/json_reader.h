@@ -0,0 +1,49 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "text_input.h"
+
+// Streaming reader for the top-level object of a JSON file, behind
+// wizuall_rt.read_json. The file is memory-mapped (a gzip file is
+// decompressed into memory first) and read once, front to back: values of unwanted keys are only validated, arrays of numbers are
+// parsed straight into typed buffers, and pages already read are dropped.
+
+typedef enum {
+    JSON_INT,     // non-empty array of integers (and booleans) that fit int64
+    JSON_FLOAT,   // non-empty array of numbers
+    JSON_OTHER    // anything else; left as text for the json module
+} JsonKind;
+
+typedef struct {
+    char* name;           // decoded key, UTF-8 (lone surrogates as in "surrogatepass")
+    JsonKind kind;
+    void* values;         // int64_t* or double*, `count` of them
+    size_t count;
+    const char* text;     // JSON_OTHER: the value's text in the mapped file
+    size_t len;
+} JsonValue;
+
+typedef struct {
+    const char* data;     // text of the file
+    size_t size;
+    TextSource source;
+    int count;
+    JsonValue* values;    // in document order; a repeated key keeps its first position
+    bool no_memory;       // json_read failed for lack of memory, not bad input
+    char error[256];
+} JsonDocument;
+
+// Maps the file (decompressing gzip)
+bool json_open(JsonDocument* doc, const char* path);
+
+// Reads the values of the named keys (every key when names is NULL). Fails
+// with a message in doc->error, like json.load, if the document is malformed
+// or not an object; keys that are absent are simply not in doc->values.
+bool json_read(JsonDocument* doc, const char* const* names, int count);
+
+// Frees the values and unmaps the file; text spans are invalid afterwards
+void json_close(JsonDocument* doc);
+
+#endif
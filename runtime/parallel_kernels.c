@@ -0,0 +1,406 @@
+#include <stdlib.h>
+#include <string.h>
+#include "parallel_kernels.h"
+#include "thread_pool.h"
+
+// Values per task
+#define BLOCK ((size_t)1 << 16)
+
+#define SIGN_BIT ((uint64_t)1 << 63)
+#define CANONICAL_NAN ((uint64_t)0x7ff8000000000000)
+#define INFINITY_BITS ((uint64_t)0x7ff0000000000000)
+
+static size_t block_count(size_t n) {
+    return (n + BLOCK - 1) / BLOCK;
+}
+
+static size_t block_length(size_t n, size_t b) {
+    return n - b * BLOCK < BLOCK ? n - b * BLOCK : BLOCK;
+}
+
+static bool serial(size_t n) {
+    return n < PARALLEL_MIN || pool_threads() == 1;
+}
+
+// ---- Sums
+
+typedef struct {
+    const void* x;
+    size_t* offsets;
+    size_t* lengths;
+    double* sums;
+    __int128* totals;
+} Sum;
+
+// Pieces of [offset, offset + n) as vk_sum_double's recursion splits it, each
+// at most BLOCK long; with sum NULL they are only counted
+static size_t split_tree(size_t offset, size_t n, Sum* sum, size_t count) {
+    if (n <= BLOCK) {
+        if (sum) {
+            sum->offsets[count] = offset;
+            sum->lengths[count] = n;
+        }
+        return count + 1;
+    }
+    size_t half = n / 2;
+    half -= half % 8;
+    count = split_tree(offset, half, sum, count);
+    return split_tree(offset + half, n - half, sum, count);
+}
+
+// Adds the piece sums up the same tree
+static double join_tree(size_t n, const double* sums, size_t* next) {
+    if (n <= BLOCK) return sums[(*next)++];
+    size_t half = n / 2;
+    half -= half % 8;
+    double left = join_tree(half, sums, next);
+    return left + join_tree(n - half, sums, next);
+}
+
+static void sum_piece(void* ctx, size_t i) {
+    Sum* s = ctx;
+    s->sums[i] = vk_sum_double((const double*)s->x + s->offsets[i], s->lengths[i]);
+}
+
+double par_sum_double(const double* x, size_t n) {
+    if (serial(n)) return vk_sum_double(x, n);
+    size_t count = split_tree(0, n, NULL, 0);
+    Sum s = { x, malloc(count * sizeof(size_t)), malloc(count * sizeof(size_t)), malloc(count * sizeof(double)), NULL };
+    double total;
+    if (s.offsets && s.lengths && s.sums) {
+        split_tree(0, n, &s, 0);
+        pool_run(count, sum_piece, &s);
+        size_t next = 0;
+        // A piece's sum of -0.0 comes back as 0.0, which no longer matters here
+        total = 0.0 + join_tree(n, s.sums, &next);
+    } else {
+        total = vk_sum_double(x, n);
+    }
+    free(s.offsets);
+    free(s.lengths);
+    free(s.sums);
+    return total;
+}
+
+static void sum_block(void* ctx, size_t b) {
+    Sum* s = ctx;
+    size_t n = s->offsets[0];
+    s->totals[b] = vk_sum_int((const int64_t*)s->x + b * BLOCK, block_length(n, b));
+}
+
+__int128 par_sum_int(const int64_t* x, size_t n) {
+    if (serial(n)) return vk_sum_int(x, n);
+    size_t blocks = block_count(n);
+    Sum s = { x, &n, NULL, NULL, malloc(blocks * sizeof(__int128)) };
+    if (!s.totals) return vk_sum_int(x, n);
+    pool_run(blocks, sum_block, &s);
+    __int128 total = 0;
+    for (size_t b = 0; b < blocks; b++) total += s.totals[b];
+    free(s.totals);
+    return total;
+}
+
+// ---- Running sums
+
+typedef struct {
+    const void* x;
+    void* out;
+    size_t n;
+    double* carries;
+    int64_t* int_carries;
+} Scan;
+
+static void scan_double(void* ctx, size_t b) {
+    Scan* s = ctx;
+    vk_running_sum_double((const double*)s->x + b * BLOCK, (double*)s->out + b * BLOCK, block_length(s->n, b));
+}
+
+static void carry_double(double* out, size_t len, double carry) {
+    VkOperand before = { NULL, false, carry, 0 }, local = { out, false, 0, 0 };
+    vk_arith_double(VK_ADD, &before, &local, out, len);
+}
+
+static void carry_double_block(void* ctx, size_t i) {
+    Scan* s = ctx;
+    size_t b = i + 1;
+    carry_double((double*)s->out + b * BLOCK, block_length(s->n, b), s->carries[b]);
+}
+
+void par_running_sum_double(const double* x, double* out, size_t n) {
+    if (n < PARALLEL_MIN) {
+        vk_running_sum_double(x, out, n);
+        return;
+    }
+    size_t blocks = block_count(n);
+    Scan s = { x, out, n, pool_threads() > 1 ? malloc(blocks * sizeof(double)) : NULL, NULL };
+    if (!s.carries) {
+        // One thread: each block gets its carry while still in cache
+        for (size_t b = 0; b < blocks; b++) {
+            scan_double(&s, b);
+            if (b) carry_double(out + b * BLOCK, block_length(n, b), out[b * BLOCK - 1]);
+        }
+        return;
+    }
+    pool_run(blocks, scan_double, &s);
+    s.carries[0] = 0;
+    for (size_t b = 1; b < blocks; b++)
+        s.carries[b] = b == 1 ? out[BLOCK - 1] : s.carries[b - 1] + out[b * BLOCK - 1];
+    pool_run(blocks - 1, carry_double_block, &s);
+    free(s.carries);
+}
+
+static void scan_int(void* ctx, size_t b) {
+    Scan* s = ctx;
+    vk_running_sum_int((const int64_t*)s->x + b * BLOCK, (int64_t*)s->out + b * BLOCK, block_length(s->n, b));
+}
+
+static void carry_int(int64_t* out, size_t len, int64_t carry) {
+    VkOperand before = { NULL, true, 0, carry }, local = { out, true, 0, 0 };
+    vk_arith_int(VK_ADD, &before, &local, out, len);
+}
+
+static void carry_int_block(void* ctx, size_t i) {
+    Scan* s = ctx;
+    size_t b = i + 1;
+    carry_int((int64_t*)s->out + b * BLOCK, block_length(s->n, b), s->int_carries[b]);
+}
+
+void par_running_sum_int(const int64_t* x, int64_t* out, size_t n) {
+    if (serial(n)) {
+        vk_running_sum_int(x, out, n);
+        return;
+    }
+    size_t blocks = block_count(n);
+    Scan s = { x, out, n, NULL, malloc(blocks * sizeof(int64_t)) };
+    if (!s.int_carries) {
+        vk_running_sum_int(x, out, n);
+        return;
+    }
+    pool_run(blocks, scan_int, &s);
+    uint64_t carry = 0;
+    for (size_t b = 1; b < blocks; b++) {
+        carry += (uint64_t)out[b * BLOCK - 1];
+        s.int_carries[b] = (int64_t)carry;
+    }
+    pool_run(blocks - 1, carry_int_block, &s);
+    free(s.int_carries);
+}
+
+// ---- Differences
+
+static void diff_double_block(void* ctx, size_t b) {
+    Scan* s = ctx;
+    size_t len = block_length(s->n - 1, b);
+    vk_diff_double((const double*)s->x + b * BLOCK, (double*)s->out + b * BLOCK, len + 1);
+}
+
+static void diff_int_block(void* ctx, size_t b) {
+    Scan* s = ctx;
+    size_t len = block_length(s->n - 1, b);
+    vk_diff_int((const int64_t*)s->x + b * BLOCK, (int64_t*)s->out + b * BLOCK, len + 1);
+}
+
+void par_diff_double(const double* x, double* out, size_t n) {
+    if (serial(n)) {
+        vk_diff_double(x, out, n);
+        return;
+    }
+    Scan s = { x, out, n, NULL, NULL };
+    pool_run(block_count(n - 1), diff_double_block, &s);
+}
+
+void par_diff_int(const int64_t* x, int64_t* out, size_t n) {
+    if (serial(n)) {
+        vk_diff_int(x, out, n);
+        return;
+    }
+    Scan s = { x, out, n, NULL, NULL };
+    pool_run(block_count(n - 1), diff_int_block, &s);
+}
+
+// ---- Elementwise arithmetic
+
+typedef struct {
+    VkOp op;
+    const VkOperand* a;
+    const VkOperand* b;
+    void* out;
+    size_t n;
+} Arith;
+
+// v from element `start` on
+static VkOperand operand_at(const VkOperand* v, size_t start) {
+    VkOperand at = *v;
+    if (at.values) at.values = (const char*)at.values + start * 8;
+    return at;
+}
+
+static void arith_double_block(void* ctx, size_t b) {
+    Arith* t = ctx;
+    VkOperand a = operand_at(t->a, b * BLOCK), y = operand_at(t->b, b * BLOCK);
+    vk_arith_double(t->op, &a, &y, (double*)t->out + b * BLOCK, block_length(t->n, b));
+}
+
+static void arith_int_block(void* ctx, size_t b) {
+    Arith* t = ctx;
+    VkOperand a = operand_at(t->a, b * BLOCK), y = operand_at(t->b, b * BLOCK);
+    vk_arith_int(t->op, &a, &y, (int64_t*)t->out + b * BLOCK, block_length(t->n, b));
+}
+
+void par_arith_double(VkOp op, const VkOperand* a, const VkOperand* b, double* out, size_t n) {
+    if (serial(n)) {
+        vk_arith_double(op, a, b, out, n);
+        return;
+    }
+    Arith t = { op, a, b, out, n };
+    pool_run(block_count(n), arith_double_block, &t);
+}
+
+void par_arith_int(VkOp op, const VkOperand* a, const VkOperand* b, int64_t* out, size_t n) {
+    if (serial(n)) {
+        vk_arith_int(op, a, b, out, n);
+        return;
+    }
+    Arith t = { op, a, b, out, n };
+    pool_run(block_count(n), arith_int_block, &t);
+}
+
+// ---- Sorting
+//
+// Values become unsigned keys in the same order (doubles with their sign
+// bit flipped, or all bits when negative, and NaNs made one positive NaN that
+// sorts after +inf), so that equal keys are equal bits and the result does
+// not depend on how the values were split. Each of a power of two runs is
+// sorted by one thread, then pairs of runs are merged in rounds, every merge
+// cut into blocks of output whose inputs a binary search finds.
+
+typedef struct {
+    size_t lo, mid, hi;     // runs [lo, mid) and [mid, hi)
+    size_t first, last;     // the block of merged output [lo + first, lo + last)
+} MergeBlock;
+
+typedef struct {
+    uint64_t* keys;
+    uint64_t* scratch;
+    size_t n;
+    size_t runs;
+    bool is_double;
+    KeySort key_sort;
+    const uint64_t* from;
+    uint64_t* to;
+    MergeBlock* blocks;
+} Sort;
+
+// Flips the sign bit of non-negative values and every bit of negative ones,
+// without branches so that the loops vectorize
+static inline uint64_t double_key(uint64_t bits) {
+    bits = (bits & ~SIGN_BIT) > INFINITY_BITS ? CANONICAL_NAN : bits;
+    return bits ^ ((uint64_t)((int64_t)bits >> 63) | SIGN_BIT);
+}
+
+static inline uint64_t key_double(uint64_t key) {
+    return key ^ (~(uint64_t)((int64_t)key >> 63) | SIGN_BIT);
+}
+
+static void to_keys(void* ctx, size_t b) {
+    Sort* s = ctx;
+    uint64_t* k = s->keys + b * BLOCK;
+    size_t len = block_length(s->n, b);
+    if (s->is_double)
+        for (size_t i = 0; i < len; i++) k[i] = double_key(k[i]);
+    else
+        for (size_t i = 0; i < len; i++) k[i] ^= SIGN_BIT;
+}
+
+static void from_keys(void* ctx, size_t b) {
+    Sort* s = ctx;
+    uint64_t* k = s->keys + b * BLOCK;
+    size_t len = block_length(s->n, b);
+    if (s->is_double)
+        for (size_t i = 0; i < len; i++) k[i] = key_double(k[i]);
+    else
+        for (size_t i = 0; i < len; i++) k[i] ^= SIGN_BIT;
+}
+
+static void sort_one_run(void* ctx, size_t r) {
+    Sort* s = ctx;
+    size_t lo = s->n * r / s->runs, hi = s->n * (r + 1) / s->runs;
+    s->key_sort(s->keys + lo, (ptrdiff_t)(hi - lo), NULL);
+}
+
+// How many of the first k merged values of a[0, na) and b[0, nb) come from
+// a, a's first where they are equal
+static size_t merge_split(const uint64_t* a, size_t na, const uint64_t* b, size_t nb, size_t k) {
+    size_t lo = k > nb ? k - nb : 0, hi = k < na ? k : na;
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        if (b[k - i - 1] < a[i]) hi = i;
+        else lo = i + 1;
+    }
+    return lo;
+}
+
+static void merge_block(void* ctx, size_t index) {
+    Sort* s = ctx;
+    const MergeBlock* m = &s->blocks[index];
+    const uint64_t* a = s->from + m->lo;
+    const uint64_t* b = s->from + m->mid;
+    size_t na = m->mid - m->lo, nb = m->hi - m->mid;
+    size_t i = merge_split(a, na, b, nb, m->first), j = m->first - i;
+    size_t i_end = merge_split(a, na, b, nb, m->last), j_end = m->last - i_end;
+    uint64_t* out = s->to + m->lo + m->first;
+    while (i < i_end && j < j_end) *out++ = b[j] < a[i] ? b[j++] : a[i++];
+    while (i < i_end) *out++ = a[i++];
+    while (j < j_end) *out++ = b[j++];
+}
+
+static void copy_block(void* ctx, size_t b) {
+    Sort* s = ctx;
+    memcpy(s->keys + b * BLOCK, s->scratch + b * BLOCK, block_length(s->n, b) * sizeof(uint64_t));
+}
+
+static bool sort_keys(uint64_t* keys, size_t n, bool is_double, KeySort key_sort) {
+    if (n < 2) return true;
+    Sort s = { keys, NULL, n, 1, is_double, key_sort, NULL, NULL, NULL };
+    size_t threads = (size_t)pool_threads();
+    while (s.runs < threads && n / (2 * s.runs) >= BLOCK) s.runs *= 2;
+    if (s.runs > 1) {
+        s.scratch = malloc(n * sizeof(uint64_t));
+        s.blocks = malloc((block_count(n) + s.runs) * sizeof(MergeBlock));
+    }
+    if (s.runs > 1 && (!s.scratch || !s.blocks)) {
+        free(s.scratch);
+        free(s.blocks);
+        return false;
+    }
+    size_t blocks = block_count(n);
+    pool_run(blocks, to_keys, &s);
+    pool_run(s.runs, sort_one_run, &s);
+    s.from = keys;
+    s.to = s.scratch;
+    for (size_t width = 1; width < s.runs; width *= 2) {
+        size_t count = 0;
+        for (size_t r = 0; r < s.runs; r += 2 * width) {
+            size_t lo = n * r / s.runs, mid = n * (r + width) / s.runs, hi = n * (r + 2 * width) / s.runs;
+            for (size_t first = 0; first < hi - lo; first += BLOCK)
+                s.blocks[count++] = (MergeBlock){ lo, mid, hi, first, first + BLOCK < hi - lo ? first + BLOCK : hi - lo };
+        }
+        pool_run(count, merge_block, &s);
+        const uint64_t* merged = s.to;
+        s.to = (uint64_t*)s.from;
+        s.from = merged;
+    }
+    if (s.from != keys) pool_run(blocks, copy_block, &s);
+    pool_run(blocks, from_keys, &s);
+    free(s.scratch);
+    free(s.blocks);
+    return true;
+}
+
+bool par_sort_double(double* x, size_t n, KeySort key_sort) {
+    return sort_keys((uint64_t*)x, n, true, key_sort);
+}
+
+bool par_sort_int(int64_t* x, size_t n, KeySort key_sort) {
+    return sort_keys((uint64_t*)x, n, false, key_sort);
+}
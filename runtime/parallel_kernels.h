@@ -0,0 +1,39 @@
+#ifndef PARALLEL_KERNELS_H
+#define PARALLEL_KERNELS_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "vector_kernels.h"
+
+// The vector_kernels split into blocks that run on the thread pool. Vectors
+// shorter than PARALLEL_MIN stay on the calling thread. Blocks fall on fixed
+// offsets, so results do not depend on the number of threads.
+#define PARALLEL_MIN ((size_t)1 << 17)
+
+// vk_sum_double's result: NumPy's pairwise tree, its subtrees summed apart
+double par_sum_double(const double* x, size_t n);
+__int128 par_sum_int(const int64_t* x, size_t n);
+
+// Running sums as a two-pass scan: every block of 2^16 values is summed on
+// its own, then the total of the blocks before it added to each value. Past
+// the first block, doubles can differ from np.cumsum's in the last bits.
+void par_running_sum_double(const double* x, double* out, size_t n);
+void par_running_sum_int(const int64_t* x, int64_t* out, size_t n);
+
+void par_diff_double(const double* x, double* out, size_t n);
+void par_diff_int(const int64_t* x, int64_t* out, size_t n);
+
+void par_arith_double(VkOp op, const VkOperand* a, const VkOperand* b, double* out, size_t n);
+void par_arith_int(VkOp op, const VkOperand* a, const VkOperand* b, int64_t* out, size_t n);
+
+// Sorts n uint64 keys in place: the signature of NumPy's sort functions,
+// called with a NULL array
+typedef int (*KeySort)(void* keys, ptrdiff_t n, void* arr);
+
+// Sorts x in place in np.sort's order (NaNs last): runs of it sorted by
+// key_sort on one thread each, then merged pairwise. Fails only when out of
+// memory.
+bool par_sort_double(double* x, size_t n, KeySort key_sort);
+bool par_sort_int(int64_t* x, size_t n, KeySort key_sort);
+
+#endif
@@ -0,0 +1,172 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sqlite_reader.h"
+
+// First capacity of the columns, in rows; doubled as they fill
+#define FIRST_CAPACITY 1024
+
+typedef union {
+    int64_t i;
+    double d;
+} Number;
+
+static bool fail(SqlTable* t) {
+    snprintf(t->error, sizeof(t->error), "%s", sqlite3_errmsg(t->db));
+    return false;
+}
+
+static bool no_memory(SqlTable* t) {
+    t->no_memory = true;
+    snprintf(t->error, sizeof(t->error), "out of memory reading %zu rows", t->rows);
+    return false;
+}
+
+bool sqlite_open(SqlTable* t, const char* path, const char* table,
+                 const char* const* names, int count, int64_t start, int64_t stop) {
+    memset(t, 0, sizeof(SqlTable));
+    if (sqlite3_open_v2(path, &t->db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) {
+        t->os_error = t->db ? sqlite3_system_errno(t->db) : ENOMEM;
+        if (!t->os_error) t->os_error = EIO;
+        return t->db ? fail(t) : no_memory(t);
+    }
+
+    // Identifiers are quoted, so any name (even a keyword) selects itself.
+    // Without ORDER BY, SQLite does not promise the same row order from one
+    // query to the next, so the window is taken in rowid order; a WITHOUT
+    // ROWID table has no rowid and is read in the order SQLite returns.
+    int rc = SQLITE_ERROR;
+    for (int ordered = 1; ordered >= 0 && rc != SQLITE_OK; ordered--) {
+        sqlite3_str* sql = sqlite3_str_new(t->db);
+        sqlite3_str_appendall(sql, "SELECT ");
+        if (!names) sqlite3_str_appendall(sql, "*");
+        for (int i = 0; names && i < count; i++)
+            sqlite3_str_appendf(sql, "%s\"%w\"", i ? ", " : "", names[i]);
+        sqlite3_str_appendf(sql, " FROM \"%w\"%s LIMIT ? OFFSET ?", table, ordered ? " ORDER BY rowid" : "");
+        char* text = sqlite3_str_finish(sql);
+        if (!text) return no_memory(t);
+        rc = sqlite3_prepare_v2(t->db, text, -1, &t->stmt, NULL);
+        sqlite3_free(text);
+        if (rc != SQLITE_OK && strcmp(sqlite3_errmsg(t->db), "no such column: rowid") != 0) break;
+    }
+    if (rc != SQLITE_OK) {
+        t->not_found = strncmp(sqlite3_errmsg(t->db), "no such ", 8) == 0;
+        return fail(t);
+    }
+    if (start < 0) start = 0;
+    sqlite3_bind_int64(t->stmt, 1, stop < 0 ? -1 : stop > start ? stop - start : 0);
+    sqlite3_bind_int64(t->stmt, 2, start);
+
+    t->column_count = sqlite3_column_count(t->stmt);
+    t->columns = calloc(t->column_count > 0 ? t->column_count : 1, sizeof(SqlColumn));
+    if (!t->columns) return no_memory(t);
+    for (int i = 0; i < t->column_count; i++) {
+        t->columns[i].name = strdup(names ? names[i] : sqlite3_column_name(t->stmt, i));
+        if (!t->columns[i].name) return no_memory(t);
+    }
+    return true;
+}
+
+static bool grow(SqlTable* t) {
+    size_t cap = t->capacity ? t->capacity * 2 : FIRST_CAPACITY;
+    for (int i = 0; i < t->column_count; i++) {
+        SqlColumn* c = &t->columns[i];
+        size_t width = c->kind == SQL_OTHER ? sizeof(SqlCell) : sizeof(Number);
+        void* grown = realloc(c->values, cap * width);
+        if (!grown) return false;
+        c->values = grown;
+    }
+    t->capacity = cap;
+    return true;
+}
+
+// The cells read so far, as SqlCell
+static bool to_cells(SqlTable* t, SqlColumn* c) {
+    SqlCell* cells = malloc((t->capacity ? t->capacity : 1) * sizeof(SqlCell));
+    if (!cells) return false;
+    Number* numbers = c->values;
+    for (size_t r = 0; r < t->rows; r++) {
+        cells[r].type = c->kind == SQL_INT ? SQLITE_INTEGER : SQLITE_FLOAT;
+        if (c->kind == SQL_INT) cells[r].i = numbers[r].i;
+        else cells[r].d = numbers[r].d;
+    }
+    free(c->values);
+    c->values = cells;
+    c->kind = SQL_OTHER;
+    return true;
+}
+
+static bool store(SqlTable* t, SqlColumn* c, int i) {
+    int type = sqlite3_column_type(t->stmt, i);
+    size_t r = t->rows;
+    if (c->kind != SQL_OTHER && type != SQLITE_INTEGER && type != SQLITE_FLOAT && !to_cells(t, c)) return false;
+    if (c->kind == SQL_INT && type == SQLITE_FLOAT) {
+        // Same width: the integers so far become doubles in place
+        Number* numbers = c->values;
+        for (size_t k = 0; k < r; k++) numbers[k].d = (double)numbers[k].i;
+        c->kind = SQL_FLOAT;
+    }
+    if (c->kind == SQL_INT) {
+        ((Number*)c->values)[r].i = sqlite3_column_int64(t->stmt, i);
+        return true;
+    }
+    if (c->kind == SQL_FLOAT) {
+        ((Number*)c->values)[r].d = sqlite3_column_double(t->stmt, i);
+        return true;
+    }
+    SqlCell* cell = &((SqlCell*)c->values)[r];
+    cell->type = type;
+    if (type == SQLITE_INTEGER) {
+        cell->i = sqlite3_column_int64(t->stmt, i);
+    } else if (type == SQLITE_FLOAT) {
+        cell->d = sqlite3_column_double(t->stmt, i);
+    } else if (type == SQLITE_TEXT || type == SQLITE_BLOB) {
+        const void* bytes = type == SQLITE_TEXT ? (const void*)sqlite3_column_text(t->stmt, i) : sqlite3_column_blob(t->stmt, i);
+        size_t len = (size_t)sqlite3_column_bytes(t->stmt, i);
+        cell->text.bytes = malloc(len ? len : 1);
+        cell->text.len = len;
+        if (!cell->text.bytes) {
+            cell->type = SQLITE_NULL;
+            return false;
+        }
+        if (len) memcpy(cell->text.bytes, bytes, len);
+    }
+    return true;
+}
+
+bool sqlite_read(SqlTable* t) {
+    int rc;
+    while ((rc = sqlite3_step(t->stmt)) == SQLITE_ROW) {
+        if (t->rows == t->capacity && !grow(t)) return no_memory(t);
+        for (int i = 0; i < t->column_count; i++) {
+            if (store(t, &t->columns[i], i)) continue;
+            // sqlite_close only frees whole rows
+            for (int k = 0; k < i; k++) {
+                SqlColumn* c = &t->columns[k];
+                SqlCell* cell = c->kind == SQL_OTHER ? &((SqlCell*)c->values)[t->rows] : NULL;
+                if (cell && (cell->type == SQLITE_TEXT || cell->type == SQLITE_BLOB)) free(cell->text.bytes);
+            }
+            return no_memory(t);
+        }
+        t->rows++;
+    }
+    return rc == SQLITE_DONE || fail(t);
+}
+
+void sqlite_close(SqlTable* t) {
+    for (int i = 0; i < t->column_count && t->columns; i++) {
+        SqlColumn* c = &t->columns[i];
+        if (c->kind == SQL_OTHER && c->values) {
+            SqlCell* cells = c->values;
+            for (size_t r = 0; r < t->rows; r++)
+                if (cells[r].type == SQLITE_TEXT || cells[r].type == SQLITE_BLOB) free(cells[r].text.bytes);
+        }
+        free(c->values);
+        free(c->name);
+    }
+    free(t->columns);
+    sqlite3_finalize(t->stmt);
+    sqlite3_close(t->db);
+    memset(t, 0, sizeof(SqlTable));
+}
@@ -0,0 +1,62 @@
+#ifndef SQLITE_READER_H
+#define SQLITE_READER_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sqlite3.h>
+
+// Reader of the columns of a SQLite table behind wizuall_rt.read_sqlite. It
+// selects only the wanted columns and rows and steps through the result once,
+// storing numbers straight into typed buffers.
+
+typedef enum {
+    SQL_INT,      // every cell is INTEGER
+    SQL_FLOAT,    // every cell is INTEGER or REAL
+    SQL_OTHER     // some cell is TEXT, BLOB or NULL; kept as SqlCell
+} SqlKind;
+
+// A cell of a SQL_OTHER column: `type` is its SQLITE_* storage class
+typedef struct {
+    int type;
+    union {
+        int64_t i;
+        double d;
+        struct {
+            char* bytes;      // malloc'd TEXT (UTF-8) or BLOB
+            size_t len;
+        } text;
+    };
+} SqlCell;
+
+typedef struct {
+    char* name;
+    SqlKind kind;
+    void* values;         // int64_t*, double* or SqlCell*, one per row
+} SqlColumn;
+
+typedef struct {
+    sqlite3* db;
+    sqlite3_stmt* stmt;
+    int column_count;
+    SqlColumn* columns;
+    size_t rows;
+    size_t capacity;
+    bool not_found;       // the table or a column does not exist
+    bool no_memory;
+    int os_error;         // errno of a database that could not be opened, else 0
+    char error[256];
+} SqlTable;
+
+// Opens the database read-only and prepares the query of the named columns
+// (every column when names is NULL) of rows [start, stop) of `table` (stop < 0:
+// to the end), in rowid order
+bool sqlite_open(SqlTable* t, const char* path, const char* table,
+                 const char* const* names, int count, int64_t start, int64_t stop);
+
+// Steps through the rows into the columns
+bool sqlite_read(SqlTable* t);
+
+// Frees the columns and closes the database
+void sqlite_close(SqlTable* t);
+
+#endif
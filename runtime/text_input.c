@@ -0,0 +1,239 @@
+#define _GNU_SOURCE   // mremap
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "text_input.h"
+
+// Capacity of a decompressed file before its size is known
+#define MIN_INFLATED (1 << 20)
+
+static bool map_file(const char* path, const char** data, size_t* size) {
+    *data = NULL;
+    *size = 0;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return false;
+    }
+    if (st.st_size > 0) {
+        void* mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            int saved = errno;
+            close(fd);
+            errno = saved;
+            return false;
+        }
+        madvise(mapped, (size_t)st.st_size, MADV_SEQUENTIAL);
+        *data = mapped;
+        *size = (size_t)st.st_size;
+    }
+    close(fd);
+    return true;
+}
+
+// Decompresses the gzip members in [in, in + n) into an anonymous mapping.
+// The last member's trailer holds the size modulo 2^32, which is the first
+// guess at the capacity; it doubles when that is short.
+static bool inflate_text(const unsigned char* in, size_t n, const char** data, size_t* size) {
+    size_t cap = n >= 4 ? (size_t)in[n - 4] | (size_t)in[n - 3] << 8 | (size_t)in[n - 2] << 16 | (size_t)in[n - 1] << 24 : 0;
+    if (cap < MIN_INFLATED) cap = MIN_INFLATED;
+    char* out = mmap(NULL, cap, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (out == MAP_FAILED) return false;
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (inflateInit2(&z, 16 + MAX_WBITS) != Z_OK) {
+        munmap(out, cap);
+        errno = ENOMEM;
+        return false;
+    }
+    const unsigned char* next = in;
+    const char* done = (const char*)in;
+    size_t used = 0;
+    int error = 0;
+    for (;;) {
+        if (used == cap) {
+            char* grown = mremap(out, cap, cap * 2, MREMAP_MAYMOVE);
+            if (grown == MAP_FAILED) {
+                error = errno;
+                break;
+            }
+            out = grown;
+            cap *= 2;
+        }
+        // zlib counts in uInt
+        if (z.avail_in == 0 && next < in + n) {
+            z.next_in = (unsigned char*)next;
+            z.avail_in = (uInt)(in + n - next < (1 << 30) ? in + n - next : (1 << 30));
+            next += z.avail_in;
+        }
+        z.next_out = (unsigned char*)out + used;
+        z.avail_out = (uInt)(cap - used < (1u << 30) ? cap - used : (1u << 30));
+        uInt room = z.avail_out;
+        int status = inflate(&z, Z_NO_FLUSH);
+        used += room - z.avail_out;
+        const unsigned char* at = next - z.avail_in;
+        if ((const char*)at - done >= RELEASE_BYTES) done = release_behind(TEXT_MAPPED, done, (const char*)at);
+        if (status == Z_STREAM_END) {
+            // Concatenated members (gzip -c a b > ab.gz) read as one file
+            if (at + 1 < in + n && at[0] == 0x1f && at[1] == 0x8b) {
+                inflateReset(&z);
+                continue;
+            }
+            break;
+        }
+        if (status == Z_MEM_ERROR) {
+            error = ENOMEM;
+            break;
+        }
+        if (status != Z_OK && (status != Z_BUF_ERROR || (z.avail_out > 0 && at == in + n))) {
+            error = EBADMSG;   // corrupt or truncated
+            break;
+        }
+    }
+    inflateEnd(&z);
+    if (error) {
+        munmap(out, cap);
+        errno = error;
+        return false;
+    }
+    long page = sysconf(_SC_PAGESIZE);
+    size_t kept = (used + page - 1) & ~(size_t)(page - 1);
+    if (kept < cap) munmap(out + kept, cap - kept);
+    if (used == 0) out = NULL;
+    *data = out;
+    *size = used;
+    return true;
+}
+
+bool open_text(const char* path, const char** data, size_t* size, TextSource* source) {
+    *source = TEXT_MAPPED;
+    if (!map_file(path, data, size)) return false;
+    const unsigned char* raw = (const unsigned char*)*data;
+    size_t n = *size;
+    if (n < 2 || raw[0] != 0x1f || raw[1] != 0x8b) return true;
+    bool ok = inflate_text(raw, n, data, size);
+    int saved = errno;
+    munmap((void*)raw, n);
+    errno = saved;
+    if (!ok) {
+        *data = NULL;
+        *size = 0;
+        return false;
+    }
+    *source = TEXT_INFLATED;
+    return true;
+}
+
+void close_text(const char* data, size_t size, TextSource source) {
+    if (data && source != TEXT_BORROWED) munmap((void*)data, size);
+}
+
+void advise_sparse(TextSource source, const char* data, size_t size) {
+    if (source == TEXT_MAPPED && data) madvise((void*)data, size, MADV_RANDOM);
+}
+
+const char* release_behind(TextSource source, const char* from, const char* to) {
+    if (source != TEXT_MAPPED) return to;
+    long page = sysconf(_SC_PAGESIZE);
+    uintptr_t b = ((uintptr_t)from + page - 1) & ~(uintptr_t)(page - 1);
+    uintptr_t e = (uintptr_t)to & ~(uintptr_t)(page - 1);
+    if (e > b) madvise((void*)b, e - b, MADV_DONTNEED);
+    return to;
+}
+
+// ---------------------------------------------------------------------------
+// Numbers
+//
+// Decimals with at most 19 significant digits and a small exponent are
+// converted exactly with one multiplication or division (both operands are
+// exact doubles); the rest go through strtod.
+// ---------------------------------------------------------------------------
+
+static const double powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+bool parse_int64(const char* p, const char* end, int64_t* value) {
+    bool negative = *p == '-';
+    if (*p == '-' || *p == '+') p++;
+    if (p == end) return false;
+    uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+    uint64_t v = 0;
+    for (; p < end; p++) {
+        unsigned d = (unsigned)(*p - '0');
+        if (d > 9) return false;
+        if (v > (limit - d) / 10) return false;
+        v = v * 10 + d;
+    }
+    *value = negative ? (int64_t)(0 - v) : (int64_t)v;
+    return true;
+}
+
+static bool parse_double_slow(const char* p, const char* end, double* value) {
+    char buf[MAX_NUMBER_LEN];
+    size_t len = end - p;
+    memcpy(buf, p, len);
+    buf[len] = '\0';
+    char* stop;
+    *value = strtod(buf, &stop);
+    return stop == buf + len;
+}
+
+bool parse_double(const char* begin, const char* end, double* value) {
+    const char* p = begin;
+    bool negative = *p == '-';
+    if (*p == '-' || *p == '+') p++;
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool any = false, exact = true;
+    for (; p < end && (unsigned)(*p - '0') <= 9; p++) {
+        any = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa) digits++;
+        } else {
+            exponent++;
+            if (*p != '0') exact = false;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && (unsigned)(*p - '0') <= 9; p++) {
+            any = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa) digits++;
+                exponent--;
+            } else if (*p != '0') {
+                exact = false;
+            }
+        }
+    }
+    if (!any) return parse_double_slow(begin, end, value);   // inf, nan, ...
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negative_exp = p < end && *p == '-';
+        if (p < end && (*p == '-' || *p == '+')) p++;
+        if (p == end) return false;
+        int e = 0;
+        for (; p < end && (unsigned)(*p - '0') <= 9; p++)
+            if (e < 10000) e = e * 10 + (*p - '0');
+        exponent += negative_exp ? -e : e;
+    }
+    if (p != end) return parse_double_slow(begin, end, value);
+    if (!exact || mantissa > (1ULL << 53) || exponent < -22 || exponent > 22)
+        return parse_double_slow(begin, end, value);
+    double v = (double)mantissa;
+    v = exponent < 0 ? v / powers_of_ten[-exponent] : v * powers_of_ten[exponent];
+    *value = negative ? -v : v;
+    return true;
+}
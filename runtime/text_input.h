@@ -0,0 +1,44 @@
+#ifndef TEXT_INPUT_H
+#define TEXT_INPUT_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Pieces shared by the file readers of wizuall_rt: the text of a file
+// (mapped, or decompressed when it is gzip) and number parsing with Python's
+// int()/float() semantics.
+
+// Longer tokens are never taken for numbers
+#define MAX_NUMBER_LEN 256
+// Parsed pages are dropped from a mapping in steps of this size
+#define RELEASE_BYTES (8 << 20)
+
+// Where a reader's text lives
+typedef enum {
+    TEXT_MAPPED,     // mapping of the file itself
+    TEXT_INFLATED,   // gzip file decompressed into anonymous memory
+    TEXT_BORROWED    // the caller's buffer
+} TextSource;
+
+// Maps the whole file for sequential reading (*data is NULL for an empty
+// file). A gzip file (recognised by its magic bytes, whatever its name) is
+// decompressed into memory instead; corrupt data fails with EBADMSG. On
+// failure errno is kept for the caller's error message.
+bool open_text(const char* path, const char** data, size_t* size, TextSource* source);
+void close_text(const char* data, size_t size, TextSource source);
+
+// Drops the whole pages of [from, to) of a file mapping and returns `to`. The
+// mapping is file backed, so a dropped page is read again if it is used later:
+// this only bounds RSS. Other sources are left alone.
+const char* release_behind(TextSource source, const char* from, const char* to);
+
+// Only parts of the text will be read: a file mapping drops its
+// sequential read-ahead, so pages between them stay on disk
+void advise_sparse(TextSource source, const char* data, size_t size);
+
+// Parse [p, end), which must be shorter than MAX_NUMBER_LEN and trimmed.
+// parse_int64 fails on overflow; parse_double accepts what float() does.
+bool parse_int64(const char* p, const char* end, int64_t* value);
+bool parse_double(const char* p, const char* end, double* value);
+
+#endif
@@ -0,0 +1,167 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "thread_pool.h"
+
+#define MAX_THREADS 256
+
+// The indices [next, end) of a job one thread starts on. The owner takes from
+// next and thieves from end, both under lock; reads outside it only pick a
+// victim, so they are relaxed atomics.
+typedef struct {
+    pthread_mutex_t lock;
+    size_t next;
+    size_t end;
+} Share;
+
+static struct {
+    pthread_once_t counted;
+    pthread_once_t started;
+    int threads;
+    pthread_mutex_t busy;       // held by the pool_run in progress
+    pthread_mutex_t lock;       // guards the fields below
+    pthread_cond_t wake;        // a job was posted
+    pthread_cond_t done;        // a task or a worker finished
+    unsigned long generation;   // jobs posted so far
+    bool open;                  // the last job still takes workers
+    int active;                 // workers inside the job
+    PoolTask task;
+    void* ctx;
+    size_t remaining;           // tasks not finished, atomic
+    Share shares[MAX_THREADS];
+} pool = {
+    .counted = PTHREAD_ONCE_INIT,
+    .started = PTHREAD_ONCE_INIT,
+    .busy = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+};
+
+static void count_threads(void) {
+    const char* env = getenv("WIZUALL_THREADS");
+    char* end;
+    long n = env ? strtol(env, &end, 10) : 0;
+    if (!env || end == env || *end || n < 1) n = sysconf(_SC_NPROCESSORS_ONLN);
+    pool.threads = n < 1 ? 1 : n > MAX_THREADS ? MAX_THREADS : (int)n;
+}
+
+int pool_threads(void) {
+    pthread_once(&pool.counted, count_threads);
+    return pool.threads;
+}
+
+static size_t share_left(Share* s) {
+    size_t next = __atomic_load_n(&s->next, __ATOMIC_RELAXED);
+    size_t end = __atomic_load_n(&s->end, __ATOMIC_RELAXED);
+    return next < end ? end - next : 0;
+}
+
+static void set_share(Share* s, size_t next, size_t end) {
+    __atomic_store_n(&s->next, next, __ATOMIC_RELAXED);
+    __atomic_store_n(&s->end, end, __ATOMIC_RELAXED);
+}
+
+// The next index for thread `self`: from its own share, else the first of
+// the back half of the largest one, the rest of which becomes its own
+static bool take(int self, size_t* index) {
+    Share* own = &pool.shares[self];
+    pthread_mutex_lock(&own->lock);
+    bool found = share_left(own) > 0;
+    if (found) *index = __atomic_fetch_add(&own->next, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&own->lock);
+    if (found) return true;
+    for (;;) {
+        Share* victim = NULL;
+        size_t most = 0;
+        for (int i = 0; i < pool.threads; i++) {
+            size_t left = share_left(&pool.shares[i]);
+            if (left > most) {
+                most = left;
+                victim = &pool.shares[i];
+            }
+        }
+        if (!victim) return false;
+        pthread_mutex_lock(&victim->lock);
+        size_t left = share_left(victim);
+        size_t end = victim->end, start = end - (left + 1) / 2;
+        if (left) __atomic_store_n(&victim->end, start, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&victim->lock);
+        if (!left) continue;    // emptied meanwhile: look again
+        *index = start;
+        pthread_mutex_lock(&own->lock);
+        set_share(own, start + 1, end);
+        pthread_mutex_unlock(&own->lock);
+        return true;
+    }
+}
+
+static void work(int self, PoolTask task, void* ctx) {
+    size_t i;
+    while (take(self, &i)) {
+        task(ctx, i);
+        if (__atomic_sub_fetch(&pool.remaining, 1, __ATOMIC_ACQ_REL) == 0) {
+            pthread_mutex_lock(&pool.lock);
+            pthread_cond_broadcast(&pool.done);
+            pthread_mutex_unlock(&pool.lock);
+        }
+    }
+}
+
+static void* worker(void* arg) {
+    int self = (int)(intptr_t)arg;
+    unsigned long seen = 0;
+    pthread_mutex_lock(&pool.lock);
+    for (;;) {
+        while (!pool.open || pool.generation == seen) pthread_cond_wait(&pool.wake, &pool.lock);
+        seen = pool.generation;
+        pool.active++;
+        PoolTask task = pool.task;
+        void* ctx = pool.ctx;
+        pthread_mutex_unlock(&pool.lock);
+        work(self, task, ctx);
+        pthread_mutex_lock(&pool.lock);
+        pool.active--;
+        pthread_cond_broadcast(&pool.done);
+    }
+    return NULL;
+}
+
+// Workers that fail to start leave their share to be stolen by the others
+static void start_workers(void) {
+    for (int i = 0; i < pool.threads; i++) pthread_mutex_init(&pool.shares[i].lock, NULL);
+    for (int i = 1; i < pool.threads; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, worker, (void*)(intptr_t)i) == 0) pthread_detach(thread);
+    }
+}
+
+void pool_run(size_t count, PoolTask task, void* ctx) {
+    if (pool_threads() == 1 || count < 2 || pthread_mutex_trylock(&pool.busy) != 0) {
+        for (size_t i = 0; i < count; i++) task(ctx, i);
+        return;
+    }
+    pthread_once(&pool.started, start_workers);
+    size_t threads = (size_t)pool.threads;
+    pthread_mutex_lock(&pool.lock);
+    // No worker is inside a job here, so the shares are free to reset
+    for (size_t i = 0; i < threads; i++) set_share(&pool.shares[i], count * i / threads, count * (i + 1) / threads);
+    pool.task = task;
+    pool.ctx = ctx;
+    __atomic_store_n(&pool.remaining, count, __ATOMIC_RELAXED);
+    pool.open = true;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    work(0, task, ctx);
+
+    pthread_mutex_lock(&pool.lock);
+    while (__atomic_load_n(&pool.remaining, __ATOMIC_ACQUIRE) || pool.active)
+        pthread_cond_wait(&pool.done, &pool.lock);
+    pool.open = false;
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.busy);
+}
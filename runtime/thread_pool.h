@@ -0,0 +1,21 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <stddef.h>
+
+// Work-stealing pool that runs the parallel vector kernels. Its workers are
+// started on first use and kept for the life of the process: WIZUALL_THREADS
+// of them, counting the calling thread (default: one per CPU).
+
+typedef void (*PoolTask)(void* ctx, size_t index);
+
+// Threads a pool_run spreads over, the calling one included
+int pool_threads(void);
+
+// Runs task(ctx, i) for every i in [0, count) and returns once all are done.
+// Each thread starts on an even share of the indices, taken from the front;
+// one that runs out steals the back half of the largest share left. While
+// another pool_run is in progress (from another thread, or from a task) the
+// tasks run on the calling thread instead.
+void pool_run(size_t count, PoolTask task, void* ctx);
+
+#endif
@@ -0,0 +1,389 @@
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+#include "vector_kernels.h"
+
+// GCC builds every kernel twice and an ifunc resolver picks the AVX2 copy on
+// CPUs that have it. The 4-lane vectors below are one ymm register there,
+// two xmm ones in the SSE2 copy.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#include <immintrin.h>
+#define X86_KERNELS
+#define KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+#define KERNEL
+#endif
+
+typedef double f64x4 __attribute__((vector_size(32)));
+typedef int64_t i64x4 __attribute__((vector_size(32)));
+typedef uint64_t u64x4 __attribute__((vector_size(32)));
+
+// Unaligned loads and stores of 4 lanes
+#define LOAD(v, p) memcpy(&(v), (p), sizeof(v))
+#define STORE(p, v) memcpy((p), &(v), sizeof(v))
+
+// Longest block summed without splitting, as NumPy's PW_BLOCKSIZE
+#define PAIRWISE_BLOCK 128
+// Values summed per pass of vk_sum_int; their 32-bit halves cannot overflow
+// a 64-bit lane within it
+#define INT_SUM_PASS ((size_t)1 << 28)
+
+// One pairwise block: 8 running sums, lanes 0-3 in a and 4-7 in b, combined
+// in NumPy's order, then the last n % 8 values one at a time
+static inline __attribute__((always_inline)) double sum_block(const double* x, size_t n) {
+    if (n < 8) {
+        double s = -0.0;
+        for (size_t i = 0; i < n; i++) s += x[i];
+        return s;
+    }
+    f64x4 a, b, u, v;
+    LOAD(a, x);
+    LOAD(b, x + 4);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        LOAD(u, x + i);
+        LOAD(v, x + i + 4);
+        a += u;
+        b += v;
+    }
+    double s = ((a[0] + a[1]) + (a[2] + a[3])) + ((b[0] + b[1]) + (b[2] + b[3]));
+    for (; i < n; i++) s += x[i];
+    return s;
+}
+
+KERNEL double vk_sum_double(const double* x, size_t n) {
+    // NumPy recurses into both halves; the right halves still to sum wait
+    // here with the sum of the half before them
+    struct {
+        const double* x;
+        size_t n;
+        double left;
+        bool started;
+    } pending[64];
+    int depth = 0;
+    for (;;) {
+        while (n > PAIRWISE_BLOCK) {
+            size_t half = n / 2;
+            half -= half % 8;
+            pending[depth].x = x + half;
+            pending[depth].n = n - half;
+            pending[depth].started = false;
+            depth++;
+            n = half;
+        }
+        double s = sum_block(x, n);
+        while (depth && pending[depth - 1].started) {
+            depth--;
+            s = pending[depth].left + s;
+        }
+        // np.add.reduce starts from 0.0, which turns a sum of -0.0 into 0.0
+        if (!depth) return 0.0 + s;
+        pending[depth - 1].left = s;
+        pending[depth - 1].started = true;
+        x = pending[depth - 1].x;
+        n = pending[depth - 1].n;
+    }
+}
+
+KERNEL __int128 vk_sum_int(const int64_t* x, size_t n) {
+    // x = high * 2^32 + low - 2^64 when negative: the unsigned halves and the
+    // count of negatives are summed in lanes, without AVX-512's 64-bit shifts
+    __int128 total = 0;
+    const i64x4 zero = { 0 };
+    for (size_t start = 0; start < n; start += INT_SUM_PASS) {
+        size_t end = n - start > INT_SUM_PASS ? start + INT_SUM_PASS : n;
+        u64x4 low = { 0 }, high = { 0 };
+        i64x4 negative = { 0 };
+        size_t i = start;
+        for (; i + 4 <= end; i += 4) {
+            u64x4 v;
+            LOAD(v, x + i);
+            low += v & 0xffffffff;
+            high += v >> 32;
+            negative += (i64x4)v < zero;
+        }
+        uint64_t l = low[0] + low[1] + low[2] + low[3];
+        uint64_t h = high[0] + high[1] + high[2] + high[3];
+        int64_t m = negative[0] + negative[1] + negative[2] + negative[3];
+        total += (__int128)l + ((__int128)h << 32) + (__int128)m * ((__int128)1 << 64);
+        for (; i < end; i++) total += x[i];
+    }
+    return total;
+}
+
+KERNEL void vk_running_sum_double(const double* x, double* out, size_t n) {
+    // Each sum rounds the one before it, so the additions stay in order
+    if (!n) return;
+    double s = x[0];
+    out[0] = s;
+    for (size_t i = 1; i < n; i++) {
+        s += x[i];
+        out[i] = s;
+    }
+}
+
+KERNEL void vk_running_sum_int(const int64_t* x, int64_t* out, size_t n) {
+    // Prefix sums of 4 lanes in two shifted adds, then the total so far
+    const u64x4 zero = { 0 };
+    const u64x4 by_one = { 4, 0, 1, 2 }, by_two = { 4, 5, 0, 1 }, last = { 3, 3, 3, 3 };
+    u64x4 carry = { 0 };
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        u64x4 v;
+        LOAD(v, x + i);
+        v += __builtin_shuffle(v, zero, by_one);
+        v += __builtin_shuffle(v, zero, by_two);
+        v += carry;
+        STORE(out + i, v);
+        carry = __builtin_shuffle(v, last);
+    }
+    uint64_t s = carry[0];
+    for (; i < n; i++) {
+        s += (uint64_t)x[i];
+        out[i] = (int64_t)s;
+    }
+}
+
+KERNEL void vk_diff_double(const double* x, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 < n; i += 4) {
+        f64x4 a, b;
+        LOAD(a, x + i);
+        LOAD(b, x + i + 1);
+        b -= a;
+        STORE(out + i, b);
+    }
+    for (; i + 1 < n; i++) out[i] = x[i + 1] - x[i];
+}
+
+KERNEL void vk_diff_int(const int64_t* x, int64_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 < n; i += 4) {
+        u64x4 a, b;
+        LOAD(a, x + i);
+        LOAD(b, x + i + 1);
+        b -= a;
+        STORE(out + i, b);
+    }
+    for (; i + 1 < n; i++) out[i] = (int64_t)((uint64_t)x[i + 1] - (uint64_t)x[i]);
+}
+
+KERNEL void vk_reverse(const uint64_t* x, uint64_t* out, size_t n) {
+    const u64x4 backwards = { 3, 2, 1, 0 };
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        u64x4 v;
+        LOAD(v, x + n - 4 - i);
+        v = __builtin_shuffle(v, backwards);
+        STORE(out + i, v);
+    }
+    for (; i < n; i++) out[i] = x[n - 1 - i];
+}
+
+// Elements per tile of vk_arith: operands that are not arrays of the result
+// type are widened into a tile on the stack first
+#define ARITH_TILE 256
+
+// o[i] = x[i] OP y[i] for i < len, 4 lanes at a time
+#define ELEMENTWISE(vec, x, y, o, len, OP)                          \
+    do {                                                            \
+        size_t i_ = 0;                                              \
+        for (; i_ + 4 <= (len); i_ += 4) {                          \
+            vec a_, b_;                                             \
+            LOAD(a_, (x) + i_);                                     \
+            LOAD(b_, (y) + i_);                                     \
+            a_ = a_ OP b_;                                          \
+            STORE((o) + i_, a_);                                    \
+        }                                                           \
+        for (; i_ < (len); i_++) (o)[i_] = (x)[i_] OP (y)[i_];      \
+    } while (0)
+
+// The values [start, start + len) of v as doubles: in place, or in tile (a
+// scalar's tile is filled once, by the caller)
+static inline __attribute__((always_inline)) const double* double_tile(const VkOperand* v, size_t start, size_t len, double* tile) {
+    if (!v->values) return tile;
+    if (!v->is_int) return (const double*)v->values + start;
+    const int64_t* x = (const int64_t*)v->values + start;
+    for (size_t i = 0; i < len; i++) tile[i] = (double)x[i];
+    return tile;
+}
+
+KERNEL void vk_arith_double(VkOp op, const VkOperand* a, const VkOperand* b, double* out, size_t n) {
+    double a_tile[ARITH_TILE], b_tile[ARITH_TILE];
+    for (size_t i = 0; i < ARITH_TILE; i++) {
+        a_tile[i] = a->scalar;
+        b_tile[i] = b->scalar;
+    }
+    for (size_t start = 0; start < n; start += ARITH_TILE) {
+        size_t len = n - start < ARITH_TILE ? n - start : ARITH_TILE;
+        const double* x = double_tile(a, start, len, a_tile);
+        const double* y = double_tile(b, start, len, b_tile);
+        double* o = out + start;
+        switch (op) {
+            case VK_ADD: ELEMENTWISE(f64x4, x, y, o, len, +); break;
+            case VK_SUBTRACT: ELEMENTWISE(f64x4, x, y, o, len, -); break;
+            case VK_MULTIPLY: ELEMENTWISE(f64x4, x, y, o, len, *); break;
+            case VK_DIVIDE: ELEMENTWISE(f64x4, x, y, o, len, /); break;
+        }
+    }
+}
+
+KERNEL void vk_arith_int(VkOp op, const VkOperand* a, const VkOperand* b, int64_t* out, size_t n) {
+    // Unsigned lanes wrap where signed ones would overflow
+    uint64_t a_tile[ARITH_TILE], b_tile[ARITH_TILE];
+    for (size_t i = 0; i < ARITH_TILE; i++) {
+        a_tile[i] = (uint64_t)a->int_scalar;
+        b_tile[i] = (uint64_t)b->int_scalar;
+    }
+    for (size_t start = 0; start < n; start += ARITH_TILE) {
+        size_t len = n - start < ARITH_TILE ? n - start : ARITH_TILE;
+        const uint64_t* x = a->values ? (const uint64_t*)a->values + start : a_tile;
+        const uint64_t* y = b->values ? (const uint64_t*)b->values + start : b_tile;
+        uint64_t* o = (uint64_t*)out + start;
+        switch (op) {
+            case VK_ADD: ELEMENTWISE(u64x4, x, y, o, len, +); break;
+            case VK_SUBTRACT: ELEMENTWISE(u64x4, x, y, o, len, -); break;
+            case VK_MULTIPLY: ELEMENTWISE(u64x4, x, y, o, len, *); break;
+            case VK_DIVIDE: break;
+        }
+    }
+}
+
+// Lanes where mask is set take a, the others b
+#define SELECT(type, mask, a, b) ((type)(((i64x4)(a) & (mask)) | ((i64x4)(b) & ~(mask))))
+// Widens the bounds low and high of each lane to v
+#define BOUND(type, v, low, high)                      \
+    do {                                               \
+        low = SELECT(type, (v) < low, (v), low);       \
+        high = SELECT(type, (v) > high, (v), high);    \
+    } while (0)
+
+// The bounds of 16 values at a time are kept in 4 independent pairs, so that
+// each compare-and-select only waits on the one before it in its own pair
+#define MINMAX_STRIDE 16
+
+// The lanes of the minmax_double loops are folded into lo and hi and the
+// values past the last whole stride checked one at a time
+static void minmax_tail(const double* x, size_t i, size_t n, double lo, double hi, bool nan, double* min, double* max) {
+    for (; i < n; i++) {
+        if (x[i] < lo) lo = x[i];
+        if (x[i] > hi) hi = x[i];
+        nan |= x[i] != x[i];
+    }
+    *min = nan ? NAN : lo;
+    *max = nan ? NAN : hi;
+}
+
+#ifdef X86_KERNELS
+// minpd and maxpd have no vector extension operator (SELECT costs twice the
+// instructions), so this kernel is written once per width with intrinsics.
+// NaN is tracked apart, as minpd returns its second operand for it.
+__attribute__((target("avx2"))) static void minmax_double_avx2(const double* x, size_t n, double* min, double* max) {
+    __m256d low0 = _mm256_loadu_pd(x), low1 = _mm256_loadu_pd(x + 4);
+    __m256d low2 = _mm256_loadu_pd(x + 8), low3 = _mm256_loadu_pd(x + 12);
+    __m256d high0 = low0, high1 = low1, high2 = low2, high3 = low3;
+    __m256d unordered = _mm256_or_pd(_mm256_cmp_pd(low0, low1, _CMP_UNORD_Q), _mm256_cmp_pd(low2, low3, _CMP_UNORD_Q));
+    size_t i = MINMAX_STRIDE;
+    for (; i + MINMAX_STRIDE <= n; i += MINMAX_STRIDE) {
+        __m256d v0 = _mm256_loadu_pd(x + i), v1 = _mm256_loadu_pd(x + i + 4);
+        __m256d v2 = _mm256_loadu_pd(x + i + 8), v3 = _mm256_loadu_pd(x + i + 12);
+        low0 = _mm256_min_pd(v0, low0);
+        low1 = _mm256_min_pd(v1, low1);
+        low2 = _mm256_min_pd(v2, low2);
+        low3 = _mm256_min_pd(v3, low3);
+        high0 = _mm256_max_pd(v0, high0);
+        high1 = _mm256_max_pd(v1, high1);
+        high2 = _mm256_max_pd(v2, high2);
+        high3 = _mm256_max_pd(v3, high3);
+        unordered = _mm256_or_pd(unordered, _mm256_or_pd(_mm256_cmp_pd(v0, v1, _CMP_UNORD_Q),
+                                                         _mm256_cmp_pd(v2, v3, _CMP_UNORD_Q)));
+    }
+    double lows[4], highs[4];
+    _mm256_storeu_pd(lows, _mm256_min_pd(_mm256_min_pd(low0, low1), _mm256_min_pd(low2, low3)));
+    _mm256_storeu_pd(highs, _mm256_max_pd(_mm256_max_pd(high0, high1), _mm256_max_pd(high2, high3)));
+    double lo = lows[0], hi = highs[0];
+    for (int k = 1; k < 4; k++) {
+        if (lows[k] < lo) lo = lows[k];
+        if (highs[k] > hi) hi = highs[k];
+    }
+    minmax_tail(x, i, n, lo, hi, _mm256_movemask_pd(unordered) != 0, min, max);
+}
+
+static void minmax_double_sse2(const double* x, size_t n, double* min, double* max) {
+    __m128d low0 = _mm_loadu_pd(x), low1 = _mm_loadu_pd(x + 2);
+    __m128d low2 = _mm_loadu_pd(x + 4), low3 = _mm_loadu_pd(x + 6);
+    __m128d high0 = low0, high1 = low1, high2 = low2, high3 = low3;
+    __m128d unordered = _mm_or_pd(_mm_cmpunord_pd(low0, low1), _mm_cmpunord_pd(low2, low3));
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        __m128d v0 = _mm_loadu_pd(x + i), v1 = _mm_loadu_pd(x + i + 2);
+        __m128d v2 = _mm_loadu_pd(x + i + 4), v3 = _mm_loadu_pd(x + i + 6);
+        low0 = _mm_min_pd(v0, low0);
+        low1 = _mm_min_pd(v1, low1);
+        low2 = _mm_min_pd(v2, low2);
+        low3 = _mm_min_pd(v3, low3);
+        high0 = _mm_max_pd(v0, high0);
+        high1 = _mm_max_pd(v1, high1);
+        high2 = _mm_max_pd(v2, high2);
+        high3 = _mm_max_pd(v3, high3);
+        unordered = _mm_or_pd(unordered, _mm_or_pd(_mm_cmpunord_pd(v0, v1), _mm_cmpunord_pd(v2, v3)));
+    }
+    double lows[2], highs[2];
+    _mm_storeu_pd(lows, _mm_min_pd(_mm_min_pd(low0, low1), _mm_min_pd(low2, low3)));
+    _mm_storeu_pd(highs, _mm_max_pd(_mm_max_pd(high0, high1), _mm_max_pd(high2, high3)));
+    minmax_tail(x, i, n, lows[0] < lows[1] ? lows[0] : lows[1], highs[0] > highs[1] ? highs[0] : highs[1],
+                _mm_movemask_pd(unordered) != 0, min, max);
+}
+#endif
+
+void vk_minmax_double(const double* x, size_t n, double* min, double* max) {
+#ifdef X86_KERNELS
+    if (n >= MINMAX_STRIDE) {
+        if (__builtin_cpu_supports("avx2")) minmax_double_avx2(x, n, min, max);
+        else minmax_double_sse2(x, n, min, max);
+        return;
+    }
+#endif
+    minmax_tail(x, 1, n, x[0], x[0], x[0] != x[0], min, max);
+}
+
+KERNEL void vk_minmax_int(const int64_t* x, size_t n, int64_t* min, int64_t* max) {
+    int64_t lo = x[0], hi = x[0];
+    size_t i = 0;
+    if (n >= MINMAX_STRIDE) {
+        i64x4 low0, low1, low2, low3, v0, v1, v2, v3;
+        LOAD(low0, x);
+        LOAD(low1, x + 4);
+        LOAD(low2, x + 8);
+        LOAD(low3, x + 12);
+        i64x4 high0 = low0, high1 = low1, high2 = low2, high3 = low3;
+        for (i = MINMAX_STRIDE; i + MINMAX_STRIDE <= n; i += MINMAX_STRIDE) {
+            LOAD(v0, x + i);
+            LOAD(v1, x + i + 4);
+            LOAD(v2, x + i + 8);
+            LOAD(v3, x + i + 12);
+            BOUND(i64x4, v0, low0, high0);
+            BOUND(i64x4, v1, low1, high1);
+            BOUND(i64x4, v2, low2, high2);
+            BOUND(i64x4, v3, low3, high3);
+        }
+        BOUND(i64x4, low1, low0, high0);
+        BOUND(i64x4, low2, low0, high0);
+        BOUND(i64x4, low3, low0, high0);
+        BOUND(i64x4, high1, low0, high0);
+        BOUND(i64x4, high2, low0, high0);
+        BOUND(i64x4, high3, low0, high0);
+        lo = low0[0];
+        hi = high0[0];
+        for (int k = 1; k < 4; k++) {
+            if (low0[k] < lo) lo = low0[k];
+            if (high0[k] > hi) hi = high0[k];
+        }
+    }
+    for (; i < n; i++) {
+        if (x[i] < lo) lo = x[i];
+        if (x[i] > hi) hi = x[i];
+    }
+    *min = lo;
+    *max = hi;
+}
@@ -0,0 +1,52 @@
+#ifndef VECTOR_KERNELS_H
+#define VECTOR_KERNELS_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// SIMD kernels behind the wizuall_rt vector builtins. Each is built for
+// SSE2 and AVX2 and picks the widest the CPU runs, when the library is
+// loaded. Results match NumPy's for the same arrays bit for bit, except
+// vk_sum_int, which is exact where np.mean would sum in float64.
+
+// The sum of x in NumPy's pairwise order: blocks of up to 128 values summed
+// in 8 lanes, halves split at multiples of 8
+double vk_sum_double(const double* x, size_t n);
+
+// The exact sum of x
+__int128 vk_sum_int(const int64_t* x, size_t n);
+
+// out[i] = x[0] + ... + x[i]. out may be x. Integers wrap as np.cumsum's do;
+// doubles are added one after the other, in np.cumsum's order.
+void vk_running_sum_double(const double* x, double* out, size_t n);
+void vk_running_sum_int(const int64_t* x, int64_t* out, size_t n);
+
+// out[i] = x[i + 1] - x[i], for n - 1 values (n > 0)
+void vk_diff_double(const double* x, double* out, size_t n);
+void vk_diff_int(const int64_t* x, int64_t* out, size_t n);
+
+// x in reverse order, for any 8-byte elements; out must not overlap x
+void vk_reverse(const uint64_t* x, uint64_t* out, size_t n);
+
+typedef enum { VK_ADD, VK_SUBTRACT, VK_MULTIPLY, VK_DIVIDE } VkOp;
+
+// An operand of vk_arith: `values` (int64_t or double, by is_int) holds one
+// value per element, or is NULL for the same scalar in every element
+typedef struct {
+    const void* values;
+    bool is_int;
+    double scalar;
+    int64_t int_scalar;
+} VkOperand;
+
+// out[i] = a[i] op b[i] in doubles, ints converted first as NumPy converts
+// them. out may be the values of an operand.
+void vk_arith_double(VkOp op, const VkOperand* a, const VkOperand* b, double* out, size_t n);
+// The same over int operands, wrapping as NumPy does; op is not VK_DIVIDE
+void vk_arith_int(VkOp op, const VkOperand* a, const VkOperand* b, int64_t* out, size_t n);
+
+// Smallest and largest value of x (n > 0) in one pass; NaN when x holds one
+void vk_minmax_double(const double* x, size_t n, double* min, double* max);
+void vk_minmax_int(const int64_t* x, size_t n, int64_t* min, int64_t* max);
+
+#endif
@@ -0,0 +1,932 @@
+// wizuall_rt: native runtime support for the Python programs the compiler
+// generates. Built by `make` next to the compiler; generated code falls back
+// to pure Python when it cannot be imported.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+#include <numpy/arrayscalars.h>
+#include "csv_reader.h"
+#include "csv_writer.h"
+#include "json_reader.h"
+#include "parallel_kernels.h"
+#include "sqlite_reader.h"
+#include "thread_pool.h"
+#include "vector_kernels.h"
+
+// Kernels over vectors this long release the GIL, so that imports prefetched
+// on other threads keep running
+#define UNLOCKED_FROM ((size_t)1 << 16)
+
+static void free_buffer(PyObject* capsule) {
+    free(PyCapsule_GetPointer(capsule, NULL));
+}
+
+// Wraps a malloc'd buffer of n elements in a 1-D array that frees it
+static PyObject* adopt_array(void* data, size_t n, int typenum) {
+    npy_intp dims[1] = { (npy_intp)n };
+    PyObject* array = PyArray_SimpleNewFromData(1, dims, typenum, data);
+    if (!array) {
+        free(data);
+        return NULL;
+    }
+    PyObject* owner = PyCapsule_New(data, NULL, free_buffer);
+    if (!owner) {
+        Py_DECREF(array);
+        free(data);
+        return NULL;
+    }
+    // Steals owner, also on failure
+    if (PyArray_SetBaseObject((PyArrayObject*)array, owner) < 0) {
+        Py_DECREF(array);
+        return NULL;
+    }
+    return array;
+}
+
+// Text cells become str, cells missing from short records None
+static PyObject* text_list(const CsvColumn* column, size_t rows) {
+    PyObject* list = PyList_New((Py_ssize_t)rows);
+    if (!list) return NULL;
+    const CsvSpan* spans = column->values;
+    char* buf = NULL;
+    size_t cap = 0;
+    for (size_t i = 0; i < rows; i++) {
+        const CsvSpan* s = &spans[i];
+        PyObject* item;
+        if (!s->start) {
+            item = Py_NewRef(Py_None);
+        } else if (s->quoted) {
+            if (s->len > cap) {
+                cap = s->len * 2;
+                free(buf);
+                buf = malloc(cap);
+                if (!buf) {
+                    Py_DECREF(list);
+                    return PyErr_NoMemory();
+                }
+            }
+            item = PyUnicode_DecodeUTF8(buf, (Py_ssize_t)csv_unquote(s, buf), NULL);
+        } else {
+            item = PyUnicode_DecodeUTF8(s->start, (Py_ssize_t)s->len, NULL);
+        }
+        if (!item) {
+            free(buf);
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, (Py_ssize_t)i, item);
+    }
+    free(buf);
+    return list;
+}
+
+static PyObject* columns_dict(CsvTable* table) {
+    PyObject* result = PyDict_New();
+    if (!result) return NULL;
+    for (int i = 0; i < table->column_count; i++) {
+        CsvColumn* c = &table->columns[i];
+        PyObject* value;
+        if (c->kind == CSV_TEXT) {
+            value = text_list(c, table->rows);
+        } else {
+            value = adopt_array(c->values, table->rows, c->kind == CSV_INT ? NPY_INT64 : NPY_FLOAT64);
+            c->values = NULL;
+        }
+        if (!value || PyDict_SetItemString(result, c->name, value) < 0) {
+            Py_XDECREF(value);
+            Py_DECREF(result);
+            return NULL;
+        }
+        Py_DECREF(value);
+    }
+    return result;
+}
+
+// The UTF-8 names of a sequence of str, or NULL for None; *seq keeps them alive
+static bool name_list(PyObject* names, PyObject** seq, const char*** wanted, Py_ssize_t* count) {
+    if (names == Py_None) return true;
+    *seq = PySequence_Fast(names, "names must be a sequence of str");
+    if (!*seq) return false;
+    *count = PySequence_Fast_GET_SIZE(*seq);
+    *wanted = malloc((*count > 0 ? *count : 1) * sizeof(char*));
+    for (Py_ssize_t i = 0; i < *count; i++) {
+        (*wanted)[i] = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(*seq, i));
+        if (!(*wanted)[i]) {
+            free(*wanted);
+            Py_CLEAR(*seq);
+            return false;
+        }
+    }
+    return true;
+}
+
+// A sequence of (start, stop) byte offsets, as csv_ranges takes them
+static bool range_list(PyObject* obj, size_t** bounds, int* count) {
+    PyObject* seq = PySequence_Fast(obj, "ranges must be a sequence of (start, stop) pairs");
+    if (!seq) return false;
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+    *bounds = malloc((n > 0 ? 2 * n : 1) * sizeof(size_t));
+    *count = (int)n;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        Py_ssize_t start, stop;
+        if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(seq, i), "nn;ranges must be (start, stop) pairs", &start, &stop)) {
+            free(*bounds);
+            Py_DECREF(seq);
+            return false;
+        }
+        (*bounds)[2 * i] = start > 0 ? (size_t)start : 0;
+        (*bounds)[2 * i + 1] = stop > start ? (size_t)stop : (*bounds)[2 * i];
+    }
+    Py_DECREF(seq);
+    return true;
+}
+
+// Restricts an opened table to `ranges` (None: the whole file)
+static bool apply_ranges(CsvTable* table, PyObject* ranges) {
+    if (ranges == Py_None) return true;
+    size_t* bounds;
+    int count;
+    if (!range_list(ranges, &bounds, &count)) return false;
+    csv_ranges(table, bounds, count);
+    free(bounds);
+    return true;
+}
+
+// The files of a list are opened, counted and parsed on one worker pool and
+// their rows concatenated into each column
+static PyObject* read_csv_files(PyObject* sources, PyObject* names, int threads, PyObject* ranges) {
+    PyObject* list = PySequence_Fast(sources, "source must be a path, bytes or a list of paths");
+    if (!list) return NULL;
+    Py_ssize_t files = PySequence_Fast_GET_SIZE(list);
+    if (files == 0) {
+        Py_DECREF(list);
+        PyErr_SetString(PyExc_ValueError, "no files to read");
+        return NULL;
+    }
+    PyObject** path_objs = calloc(files, sizeof(PyObject*));
+    const char** paths = malloc(files * sizeof(char*));
+    CsvTable* tables = calloc(files, sizeof(CsvTable));
+    PyObject* seq = NULL;
+    const char** wanted = NULL;
+    Py_ssize_t count = 0;
+    PyObject* result = NULL;
+    bool ok = path_objs && paths && tables;
+    if (!ok) PyErr_NoMemory();
+    for (Py_ssize_t i = 0; ok && i < files; i++) {
+        ok = PyUnicode_FSConverter(PySequence_Fast_GET_ITEM(list, i), &path_objs[i]);
+        if (ok) paths[i] = PyBytes_AS_STRING(path_objs[i]);
+    }
+    if (ok) ok = name_list(names, &seq, &wanted, &count);
+    if (ok) {
+        int failed;
+        Py_BEGIN_ALLOW_THREADS
+        failed = csv_open_files(tables, paths, (int)files, threads);
+        Py_END_ALLOW_THREADS
+        if (failed >= 0) {
+            PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, PySequence_Fast_GET_ITEM(list, failed));
+            files = 0;
+            ok = false;
+        }
+    }
+    if (ok) {
+        // Every file must have the columns of the first one (or the named ones)
+        ok = csv_select(&tables[0], wanted, (int)count);
+        const char** first = malloc((tables[0].column_count > 0 ? tables[0].column_count : 1) * sizeof(char*));
+        for (int i = 0; ok && i < tables[0].column_count; i++)
+            first[i] = tables[0].columns[i].name;
+        Py_ssize_t bad = 0;
+        for (Py_ssize_t f = 1; ok && f < files; f++)
+            if (!csv_select(&tables[f], first, tables[0].column_count)) ok = false, bad = f;
+        free(first);
+        if (!ok) PyErr_SetString(PyExc_KeyError, tables[bad].error);
+    }
+    if (ok && ranges != Py_None) {
+        // One list of ranges per file
+        PyObject* per_file = PySequence_Fast(ranges, "ranges must be a sequence with one entry per file");
+        ok = per_file != NULL;
+        if (ok && PySequence_Fast_GET_SIZE(per_file) != files) {
+            PyErr_SetString(PyExc_ValueError, "ranges must have one entry per file");
+            ok = false;
+        }
+        for (Py_ssize_t f = 0; ok && f < files; f++)
+            ok = apply_ranges(&tables[f], PySequence_Fast_GET_ITEM(per_file, f));
+        Py_XDECREF(per_file);
+    }
+    if (ok) {
+        Py_BEGIN_ALLOW_THREADS
+        ok = csv_read_files(tables, (int)files, threads);
+        Py_END_ALLOW_THREADS
+        if (ok) result = columns_dict(&tables[0]);
+        else PyErr_SetString(PyExc_MemoryError, tables[0].error);
+    }
+    for (Py_ssize_t i = 0; tables && i < files; i++)
+        csv_close(&tables[i]);
+    for (Py_ssize_t i = 0; path_objs && i < PySequence_Fast_GET_SIZE(list); i++)
+        Py_XDECREF(path_objs[i]);
+    free(tables);
+    free(paths);
+    free(path_objs);
+    free(wanted);
+    Py_XDECREF(seq);
+    Py_DECREF(list);
+    return result;
+}
+
+static PyObject* read_csv(PyObject* self, PyObject* args, PyObject* kwargs) {
+    (void)self;
+    static char* kwlist[] = { "source", "names", "threads", "start", "stop", "ranges", NULL };
+    PyObject* source;
+    PyObject* names = Py_None;
+    PyObject* ranges = Py_None;
+    int threads = 0;
+    Py_ssize_t start = 0, stop = -1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|OinnO:read_csv", kwlist, &source, &names, &threads, &start, &stop, &ranges))
+        return NULL;
+    if ((start > 0 || stop >= 0) && ranges != Py_None) {
+        PyErr_SetString(PyExc_ValueError, "start/stop and ranges are exclusive");
+        return NULL;
+    }
+    if (PyList_Check(source) || PyTuple_Check(source)) {
+        if (start > 0 || stop >= 0) {
+            PyErr_SetString(PyExc_ValueError, "start and stop apply to a single file");
+            return NULL;
+        }
+        return read_csv_files(source, names, threads, ranges);
+    }
+    // A bytes-like source is CSV text itself, e.g. a block of a file that
+    // generated code decompresses as it goes
+    Py_buffer text = { 0 };
+    PyObject* path_obj = NULL;
+    if (PyObject_CheckBuffer(source)) {
+        if (PyObject_GetBuffer(source, &text, PyBUF_SIMPLE) < 0) return NULL;
+    } else if (!PyUnicode_FSConverter(source, &path_obj)) {
+        return NULL;
+    }
+
+    PyObject* seq = NULL;
+    const char** wanted = NULL;
+    Py_ssize_t count = 0;
+    if (!name_list(names, &seq, &wanted, &count)) {
+        Py_XDECREF(path_obj);
+        if (text.obj) PyBuffer_Release(&text);
+        return NULL;
+    }
+
+    CsvTable table;
+    PyObject* result = NULL;
+    bool opened = true;
+    if (path_obj) {
+        // Decompressing a gzip file takes a while
+        Py_BEGIN_ALLOW_THREADS
+        opened = csv_open(&table, PyBytes_AS_STRING(path_obj));
+        Py_END_ALLOW_THREADS
+    } else {
+        csv_open_data(&table, text.buf, (size_t)text.len);
+    }
+    if (!opened) {
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, source);
+    } else if (!csv_select(&table, wanted, (int)count)) {
+        PyErr_SetString(PyExc_KeyError, table.error);
+    } else if (apply_ranges(&table, ranges)) {
+        bool ok;
+        if (start > 0 || stop >= 0)
+            csv_range(&table, start > 0 ? (size_t)start : 0, stop >= 0 ? (size_t)stop : table.size);
+        Py_BEGIN_ALLOW_THREADS
+        ok = csv_read(&table, threads);
+        Py_END_ALLOW_THREADS
+        if (ok) result = columns_dict(&table);
+        else PyErr_SetString(PyExc_MemoryError, table.error);
+    }
+    csv_close(&table);
+    free(wanted);
+    Py_XDECREF(seq);
+    Py_XDECREF(path_obj);
+    if (text.obj) PyBuffer_Release(&text);
+    return result;
+}
+
+static PyObject* json_value(const JsonValue* v, PyObject* loads) {
+    PyObject* value;
+    if (v->kind == JSON_OTHER) {
+        PyObject* text = PyUnicode_DecodeUTF8(v->text, (Py_ssize_t)v->len, "surrogatepass");
+        if (!text) return NULL;
+        value = PyObject_CallOneArg(loads, text);
+        Py_DECREF(text);
+        return value;
+    }
+    return adopt_array(v->values, v->count, v->kind == JSON_INT ? NPY_INT64 : NPY_FLOAT64);
+}
+
+static const JsonValue* find_value(const JsonDocument* doc, const char* name) {
+    for (int i = 0; i < doc->count; i++)
+        if (strcmp(doc->values[i].name, name) == 0) return &doc->values[i];
+    return NULL;
+}
+
+// Keys in document order, or the named ones in that order
+static PyObject* values_dict(JsonDocument* doc, const char** wanted, Py_ssize_t count) {
+    PyObject* json = PyImport_ImportModule("json");
+    if (!json) return NULL;
+    PyObject* loads = PyObject_GetAttrString(json, "loads");
+    Py_DECREF(json);
+    if (!loads) return NULL;
+    PyObject* result = PyDict_New();
+    Py_ssize_t n = wanted ? count : doc->count;
+    for (Py_ssize_t i = 0; result && i < n; i++) {
+        JsonValue* v = wanted ? (JsonValue*)find_value(doc, wanted[i]) : &doc->values[i];
+        if (!v) {
+            PyErr_SetString(PyExc_KeyError, wanted[i]);
+            Py_CLEAR(result);
+            break;
+        }
+        PyObject* key = PyUnicode_DecodeUTF8(v->name, (Py_ssize_t)strlen(v->name), "surrogatepass");
+        if (!key) {
+            Py_CLEAR(result);
+            break;
+        }
+        // A name asked for twice: its buffer already belongs to an array
+        int seen = PyDict_Contains(result, key);
+        PyObject* value = seen ? NULL : json_value(v, loads);
+        if (v->kind != JSON_OTHER && !seen) v->values = NULL;
+        if (seen < 0 || (!seen && (!value || PyDict_SetItem(result, key, value) < 0)))
+            Py_CLEAR(result);
+        Py_DECREF(key);
+        Py_XDECREF(value);
+    }
+    Py_DECREF(loads);
+    return result;
+}
+
+static PyObject* read_json(PyObject* self, PyObject* args, PyObject* kwargs) {
+    (void)self;
+    static char* kwlist[] = { "path", "names", NULL };
+    PyObject* path;
+    PyObject* path_obj;
+    PyObject* names = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O:read_json", kwlist, &path, &names))
+        return NULL;
+    if (!PyUnicode_FSConverter(path, &path_obj)) return NULL;
+    PyObject* seq = NULL;
+    const char** wanted = NULL;
+    Py_ssize_t count = 0;
+    if (!name_list(names, &seq, &wanted, &count)) {
+        Py_DECREF(path_obj);
+        return NULL;
+    }
+
+    JsonDocument doc;
+    PyObject* result = NULL;
+    bool ok, opened;
+    Py_BEGIN_ALLOW_THREADS
+    opened = json_open(&doc, PyBytes_AS_STRING(path_obj));
+    ok = opened && json_read(&doc, wanted, (int)count);
+    Py_END_ALLOW_THREADS
+    if (!opened) {
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+    } else {
+        if (ok) result = values_dict(&doc, wanted, count);
+        else if (doc.no_memory) PyErr_SetString(PyExc_MemoryError, doc.error);
+        else PyErr_Format(PyExc_ValueError, "%S: %s", path, doc.error);
+    }
+    json_close(&doc);
+    free(wanted);
+    Py_XDECREF(seq);
+    Py_DECREF(path_obj);
+    return result;
+}
+
+// TEXT cells become str, BLOBs bytes and NULLs None, as in the sqlite3 module
+static PyObject* cell_list(const SqlCell* cells, size_t rows) {
+    PyObject* list = PyList_New((Py_ssize_t)rows);
+    for (size_t i = 0; list && i < rows; i++) {
+        const SqlCell* c = &cells[i];
+        PyObject* item;
+        switch (c->type) {
+            case SQLITE_INTEGER: item = PyLong_FromLongLong(c->i); break;
+            case SQLITE_FLOAT:   item = PyFloat_FromDouble(c->d); break;
+            case SQLITE_TEXT:    item = PyUnicode_DecodeUTF8(c->text.bytes, (Py_ssize_t)c->text.len, NULL); break;
+            case SQLITE_BLOB:    item = PyBytes_FromStringAndSize(c->text.bytes, (Py_ssize_t)c->text.len); break;
+            default:             item = Py_NewRef(Py_None); break;
+        }
+        if (!item) Py_CLEAR(list);
+        else PyList_SET_ITEM(list, (Py_ssize_t)i, item);
+    }
+    return list;
+}
+
+static PyObject* sql_columns_dict(SqlTable* t) {
+    PyObject* result = PyDict_New();
+    for (int i = 0; result && i < t->column_count; i++) {
+        SqlColumn* c = &t->columns[i];
+        PyObject* value;
+        if (!t->rows) {
+            value = PyList_New(0);
+        } else if (c->kind == SQL_OTHER) {
+            value = cell_list(c->values, t->rows);
+        } else {
+            value = adopt_array(c->values, t->rows, c->kind == SQL_INT ? NPY_INT64 : NPY_FLOAT64);
+            c->values = NULL;
+        }
+        if (!value || PyDict_SetItemString(result, c->name, value) < 0) Py_CLEAR(result);
+        Py_XDECREF(value);
+    }
+    return result;
+}
+
+static PyObject* read_sqlite(PyObject* self, PyObject* args, PyObject* kwargs) {
+    (void)self;
+    static char* kwlist[] = { "path", "table", "names", "start", "stop", NULL };
+    PyObject* path;
+    PyObject* path_obj;
+    const char* table;
+    PyObject* names = Py_None;
+    long long start = 0, stop = -1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Os|OLL:read_sqlite", kwlist, &path, &table, &names, &start, &stop))
+        return NULL;
+    if (!PyUnicode_FSConverter(path, &path_obj)) return NULL;
+    PyObject* seq = NULL;
+    const char** wanted = NULL;
+    Py_ssize_t count = 0;
+    if (!name_list(names, &seq, &wanted, &count)) {
+        Py_DECREF(path_obj);
+        return NULL;
+    }
+
+    SqlTable t;
+    PyObject* result = NULL;
+    bool opened, ok;
+    Py_BEGIN_ALLOW_THREADS
+    opened = sqlite_open(&t, PyBytes_AS_STRING(path_obj), table, wanted, (int)count, start, stop);
+    ok = opened && sqlite_read(&t);
+    Py_END_ALLOW_THREADS
+    if (ok) {
+        result = sql_columns_dict(&t);
+    } else if (t.no_memory) {
+        PyErr_SetString(PyExc_MemoryError, t.error);
+    } else if (t.os_error) {
+        errno = t.os_error;
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+    } else {
+        PyErr_Format(t.not_found ? PyExc_KeyError : PyExc_OSError, "%S: %s", path, t.error);
+    }
+    sqlite_close(&t);
+    free(wanted);
+    Py_XDECREF(seq);
+    Py_DECREF(path_obj);
+    return result;
+}
+
+// A column of write_csv: a 1-D int64 or float64 array, or a sequence of str.
+// *keep holds what the cells point into until the file is written.
+static bool out_column(PyObject* obj, CsvOutColumn* c, PyObject** keep) {
+    if (PyArray_Check(obj) && PyArray_NDIM((PyArrayObject*)obj) == 1) {
+        int type = PyArray_TYPE((PyArrayObject*)obj);
+        if (type == NPY_INT64 || type == NPY_FLOAT64) {
+            *keep = PyArray_FROMANY(obj, type, 1, 1, NPY_ARRAY_IN_ARRAY);
+            if (!*keep) return false;
+            c->kind = type == NPY_INT64 ? CSV_OUT_INT : CSV_OUT_FLOAT;
+            c->values = PyArray_DATA((PyArrayObject*)*keep);
+            c->count = (size_t)PyArray_DIM((PyArrayObject*)*keep, 0);
+            return true;
+        }
+    }
+    *keep = PySequence_Fast(obj, "columns must be int64/float64 arrays or sequences of str");
+    if (!*keep) return false;
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(*keep);
+    const char** cells = malloc((n > 0 ? n : 1) * sizeof(char*));
+    size_t* lens = malloc((n > 0 ? n : 1) * sizeof(size_t));
+    c->kind = CSV_OUT_TEXT;
+    c->values = cells;
+    c->lens = lens;
+    if (!cells || !lens) {
+        PyErr_NoMemory();
+        return false;
+    }
+    for (Py_ssize_t i = 0; i < n; i++) {
+        Py_ssize_t len;
+        cells[i] = PyUnicode_AsUTF8AndSize(PySequence_Fast_GET_ITEM(*keep, i), &len);
+        if (!cells[i]) return false;
+        lens[i] = (size_t)len;
+    }
+    c->count = (size_t)n;
+    return true;
+}
+
+static PyObject* write_csv(PyObject* self, PyObject* args) {
+    (void)self;
+    PyObject* path;
+    PyObject* names;
+    PyObject* columns;
+    if (!PyArg_ParseTuple(args, "OOO:write_csv", &path, &names, &columns)) return NULL;
+    PyObject* path_obj;
+    if (!PyUnicode_FSConverter(path, &path_obj)) return NULL;
+    PyObject* name_seq = NULL;
+    const char** header = NULL;
+    Py_ssize_t count = 0;
+    PyObject* column_seq = NULL;
+    PyObject** keep = NULL;
+    CsvOutColumn* out = NULL;
+    PyObject* result = NULL;
+    if (!name_list(names, &name_seq, &header, &count)) goto done;
+    column_seq = PySequence_Fast(columns, "columns must be a sequence");
+    if (!column_seq) goto done;
+    if (PySequence_Fast_GET_SIZE(column_seq) != count) {
+        PyErr_SetString(PyExc_ValueError, "write_csv takes one column per name");
+        goto done;
+    }
+    keep = calloc(count > 0 ? count : 1, sizeof(PyObject*));
+    out = calloc(count > 0 ? count : 1, sizeof(CsvOutColumn));
+    if (!keep || !out) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (Py_ssize_t i = 0; i < count; i++) {
+        out[i].name = header[i];
+        if (!out_column(PySequence_Fast_GET_ITEM(column_seq, i), &out[i], &keep[i])) goto done;
+    }
+    bool ok;
+    Py_BEGIN_ALLOW_THREADS
+    ok = csv_write(PyBytes_AS_STRING(path_obj), out, (int)count);
+    Py_END_ALLOW_THREADS
+    if (ok) result = Py_NewRef(Py_None);
+    else PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+done:
+    for (Py_ssize_t i = 0; out && keep && i < count; i++) {
+        if (out[i].kind == CSV_OUT_TEXT) {
+            free((void*)out[i].values);
+            free((void*)out[i].lens);
+        }
+        Py_XDECREF(keep[i]);
+    }
+    free(out);
+    free(keep);
+    free(header);
+    Py_XDECREF(column_seq);
+    Py_XDECREF(name_seq);
+    Py_DECREF(path_obj);
+    return result;
+}
+
+// The vector a kernel runs over: x as a C-contiguous 1-D int64 or float64
+// array (a new reference), else NULL with TypeError
+static PyArrayObject* vector_arg(PyObject* x) {
+    if (PyArray_Check(x) && PyArray_NDIM((PyArrayObject*)x) == 1) {
+        int type = PyArray_TYPE((PyArrayObject*)x);
+        // long long is int64 too, under another type number
+        if (PyArray_EquivTypenums(type, NPY_INT64) || type == NPY_FLOAT64)
+            return (PyArrayObject*)PyArray_FROMANY(x, type, 1, 1, NPY_ARRAY_IN_ARRAY);
+    }
+    PyErr_SetString(PyExc_TypeError, "expected a 1-D int64 or float64 array");
+    return NULL;
+}
+
+static PyThreadState* unlock_for(size_t n) {
+    return n >= UNLOCKED_FROM ? PyEval_SaveThread() : NULL;
+}
+
+static void relock(PyThreadState* state) {
+    if (state) PyEval_RestoreThread(state);
+}
+
+// sum / n rounded as Python's int / int rounds it: one division of doubles
+// when both are exact as doubles, else of the Python ints
+static PyObject* int_mean(__int128 sum, size_t n) {
+    const __int128 exact = (__int128)1 << 53;
+    if (!n) return PyFloat_FromDouble(NAN);
+    if (sum >= -exact && sum <= exact && (__int128)n <= exact) return PyFloat_FromDouble((double)sum / (double)n);
+    PyObject* high = PyLong_FromLongLong((long long)(sum >> 64));
+    PyObject* low = PyLong_FromUnsignedLongLong((unsigned long long)sum);
+    PyObject* bits = PyLong_FromLong(64);
+    PyObject* count = PyLong_FromSize_t(n);
+    PyObject* shifted = high && bits ? PyNumber_Lshift(high, bits) : NULL;
+    PyObject* total = shifted && low ? PyNumber_Add(shifted, low) : NULL;
+    PyObject* result = total && count ? PyNumber_TrueDivide(total, count) : NULL;
+    Py_XDECREF(high);
+    Py_XDECREF(low);
+    Py_XDECREF(bits);
+    Py_XDECREF(count);
+    Py_XDECREF(shifted);
+    Py_XDECREF(total);
+    return result;
+}
+
+static PyObject* avg(PyObject* self, PyObject* x) {
+    (void)self;
+    PyArrayObject* a = vector_arg(x);
+    if (!a) return NULL;
+    size_t n = (size_t)PyArray_DIM(a, 0);
+    PyObject* result;
+    PyThreadState* state = unlock_for(n);
+    if (PyArray_TYPE(a) == NPY_FLOAT64) {
+        double sum = par_sum_double(PyArray_DATA(a), n);
+        relock(state);
+        result = PyFloat_FromDouble(sum / (double)n);
+    } else {
+        __int128 sum = par_sum_int(PyArray_DATA(a), n);
+        relock(state);
+        result = int_mean(sum, n);
+    }
+    Py_DECREF(a);
+    return result;
+}
+
+static PyObject* running_sum(PyObject* self, PyObject* args) {
+    (void)self;
+    PyObject* x;
+    PyObject* out = Py_None;
+    if (!PyArg_ParseTuple(args, "O|O:running_sum", &x, &out)) return NULL;
+    PyArrayObject* a = vector_arg(x);
+    if (!a) return NULL;
+    npy_intp n = PyArray_DIM(a, 0);
+    int type = PyArray_TYPE(a);
+    PyArrayObject* result;
+    if (out == Py_None) {
+        result = (PyArrayObject*)PyArray_SimpleNew(1, &n, type);
+        if (!result) {
+            Py_DECREF(a);
+            return NULL;
+        }
+    } else {
+        result = (PyArrayObject*)out;
+        if (!PyArray_Check(out) || PyArray_NDIM(result) != 1 || PyArray_DIM(result, 0) != n
+            || !PyArray_EquivTypenums(PyArray_TYPE(result), type) || !PyArray_ISCARRAY(result)) {
+            PyErr_SetString(PyExc_ValueError, "out must be a writeable contiguous array of x's shape and dtype");
+            Py_DECREF(a);
+            return NULL;
+        }
+        Py_INCREF(out);
+    }
+    PyThreadState* state = unlock_for((size_t)n);
+    if (type == NPY_FLOAT64) par_running_sum_double(PyArray_DATA(a), PyArray_DATA(result), (size_t)n);
+    else par_running_sum_int(PyArray_DATA(a), PyArray_DATA(result), (size_t)n);
+    relock(state);
+    Py_DECREF(a);
+    return (PyObject*)result;
+}
+
+static PyObject* diff(PyObject* self, PyObject* x) {
+    (void)self;
+    PyArrayObject* a = vector_arg(x);
+    if (!a) return NULL;
+    npy_intp n = PyArray_DIM(a, 0);
+    npy_intp m = n > 0 ? n - 1 : 0;
+    PyArrayObject* result = (PyArrayObject*)PyArray_SimpleNew(1, &m, PyArray_TYPE(a));
+    if (result && n > 0) {
+        PyThreadState* state = unlock_for((size_t)n);
+        if (PyArray_TYPE(a) == NPY_FLOAT64) par_diff_double(PyArray_DATA(a), PyArray_DATA(result), (size_t)n);
+        else par_diff_int(PyArray_DATA(a), PyArray_DATA(result), (size_t)n);
+        relock(state);
+    }
+    Py_DECREF(a);
+    return (PyObject*)result;
+}
+
+static PyObject* reverse(PyObject* self, PyObject* x) {
+    (void)self;
+    PyArrayObject* a = vector_arg(x);
+    if (!a) return NULL;
+    npy_intp n = PyArray_DIM(a, 0);
+    PyArrayObject* result = (PyArrayObject*)PyArray_SimpleNew(1, &n, PyArray_TYPE(a));
+    if (result) {
+        PyThreadState* state = unlock_for((size_t)n);
+        vk_reverse(PyArray_DATA(a), PyArray_DATA(result), (size_t)n);
+        relock(state);
+    }
+    Py_DECREF(a);
+    return (PyObject*)result;
+}
+
+static PyObject* minmax(PyObject* self, PyObject* x) {
+    (void)self;
+    PyArrayObject* a = vector_arg(x);
+    if (!a) return NULL;
+    size_t n = (size_t)PyArray_DIM(a, 0);
+    if (!n) {
+        Py_DECREF(a);
+        PyErr_SetString(PyExc_ValueError, "minmax of an empty array");
+        return NULL;
+    }
+    // Both bounds are written as the array's own dtype
+    union {
+        double d;
+        int64_t i;
+    } low, high;
+    PyThreadState* state = unlock_for(n);
+    if (PyArray_TYPE(a) == NPY_FLOAT64) vk_minmax_double(PyArray_DATA(a), n, &low.d, &high.d);
+    else vk_minmax_int(PyArray_DATA(a), n, &low.i, &high.i);
+    relock(state);
+    PyObject* lo = PyArray_Scalar(&low, PyArray_DESCR(a), NULL);
+    PyObject* hi = PyArray_Scalar(&high, PyArray_DESCR(a), NULL);
+    Py_DECREF(a);
+    PyObject* result = lo && hi ? PyTuple_Pack(2, lo, hi) : NULL;
+    Py_XDECREF(lo);
+    Py_XDECREF(hi);
+    return result;
+}
+
+// An operand of arith: a 1-D int64/float64 array (*keep, a new reference,
+// with its length in *n) or an int or float scalar (*n = -1). False for
+// anything else, or an int out of int64's range.
+static bool arith_operand(PyObject* obj, VkOperand* v, PyArrayObject** keep, npy_intp* n) {
+    *keep = NULL;
+    *n = -1;
+    if (PyArray_Check(obj)) {
+        PyArrayObject* a = (PyArrayObject*)obj;
+        int type = PyArray_TYPE(a);
+        if (PyArray_NDIM(a) != 1 || !(PyArray_EquivTypenums(type, NPY_INT64) || type == NPY_FLOAT64)) return false;
+        *keep = (PyArrayObject*)PyArray_FROMANY(obj, type, 1, 1, NPY_ARRAY_IN_ARRAY);
+        if (!*keep) {
+            PyErr_Clear();
+            return false;
+        }
+        *v = (VkOperand){ PyArray_DATA(*keep), type != NPY_FLOAT64, 0, 0 };
+        *n = PyArray_DIM(*keep, 0);
+        return true;
+    }
+    if (PyFloat_Check(obj)) {
+        *v = (VkOperand){ NULL, false, PyFloat_AS_DOUBLE(obj), 0 };
+        return true;
+    }
+    // np.int64 is one of NumPy's long or long long, depending on the platform
+    if (PyLong_Check(obj) || PyArray_IsScalar(obj, LongLong) || PyArray_IsScalar(obj, Long)) {
+        long long i;
+        if (PyLong_Check(obj)) i = PyLong_AsLongLong(obj);
+        else if (PyArray_IsScalar(obj, LongLong)) i = PyArrayScalar_VAL(obj, LongLong);
+        else i = PyArrayScalar_VAL(obj, Long);
+        if (i == -1 && PyErr_Occurred()) {
+            PyErr_Clear();
+            return false;
+        }
+        *v = (VkOperand){ NULL, true, (double)i, i };
+        return true;
+    }
+    return false;
+}
+
+// An array of length 1 against a longer one is its one value in every element
+static void broadcast(VkOperand* v, npy_intp length, npy_intp n) {
+    if (length != 1 || n == 1) return;
+    if (v->is_int) {
+        v->int_scalar = *(const int64_t*)v->values;
+        v->scalar = (double)v->int_scalar;
+    } else {
+        v->scalar = *(const double*)v->values;
+    }
+    v->values = NULL;
+}
+
+static PyObject* arith(PyObject* self, PyObject* args) {
+    (void)self;
+    const char* op_name;
+    PyObject *x, *y;
+    if (!PyArg_ParseTuple(args, "sOO:arith", &op_name, &x, &y)) return NULL;
+    static const char ops[] = "+-*/";
+    const char* found = strlen(op_name) == 1 ? strchr(ops, op_name[0]) : NULL;
+    if (!found) {
+        PyErr_Format(PyExc_ValueError, "unknown operator '%s'", op_name);
+        return NULL;
+    }
+    VkOp op = (VkOp)(found - ops);
+    VkOperand a, b;
+    PyArrayObject *keep_a = NULL, *keep_b = NULL;
+    npy_intp n_a, n_b;
+    PyObject* result = Py_NotImplemented;
+    // Left to NumPy: other operands, two scalars, and lengths that do not match
+    if (!arith_operand(x, &a, &keep_a, &n_a) || !arith_operand(y, &b, &keep_b, &n_b)) goto done;
+    npy_intp n = n_a > n_b ? n_a : n_b;
+    if (n < 0 || (n_a >= 0 && n_a != n && n_a != 1) || (n_b >= 0 && n_b != n && n_b != 1)) goto done;
+    broadcast(&a, n_a, n);
+    broadcast(&b, n_b, n);
+    bool is_int = a.is_int && b.is_int && op != VK_DIVIDE;
+    result = PyArray_SimpleNew(1, &n, is_int ? NPY_INT64 : NPY_FLOAT64);
+    if (!result) goto done;
+    PyThreadState* state = unlock_for((size_t)n);
+    if (is_int) par_arith_int(op, &a, &b, PyArray_DATA((PyArrayObject*)result), (size_t)n);
+    else par_arith_double(op, &a, &b, PyArray_DATA((PyArrayObject*)result), (size_t)n);
+    relock(state);
+done:
+    if (result == Py_NotImplemented) Py_INCREF(result);
+    Py_XDECREF(keep_a);
+    Py_XDECREF(keep_b);
+    return result;
+}
+
+// NumPy's own sort of uint64 values, which par_sort runs on each thread's
+// share of the keys
+static KeySort key_sort(void) {
+    PyArray_Descr* descr = PyArray_DescrFromType(NPY_UINT64);
+    KeySort f = (KeySort)PyDataType_GetArrFuncs(descr)->sort[NPY_QUICKSORT];
+    Py_DECREF(descr);
+    return f;
+}
+
+static PyObject* sort(PyObject* self, PyObject* x) {
+    (void)self;
+    KeySort f = key_sort();
+    if (!f) {
+        PyErr_SetString(PyExc_RuntimeError, "NumPy has no uint64 sort");
+        return NULL;
+    }
+    PyArrayObject* a = vector_arg(x);
+    if (!a) return NULL;
+    PyArrayObject* result = (PyArrayObject*)PyArray_NewCopy(a, NPY_CORDER);
+    Py_DECREF(a);
+    if (!result) return NULL;
+    size_t n = (size_t)PyArray_DIM(result, 0);
+    if (n < PARALLEL_MIN || pool_threads() == 1) {
+        // np.sort itself, without par_sort's passes to and from keys
+        if (PyArray_Sort(result, 0, NPY_QUICKSORT) < 0) Py_CLEAR(result);
+        return (PyObject*)result;
+    }
+    PyThreadState* state = unlock_for(n);
+    bool sorted = PyArray_TYPE(result) == NPY_FLOAT64 ? par_sort_double(PyArray_DATA(result), n, f)
+                                                      : par_sort_int(PyArray_DATA(result), n, f);
+    relock(state);
+    if (!sorted) {
+        Py_DECREF(result);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*)result;
+}
+
+static PyObject* threads(PyObject* self, PyObject* args) {
+    (void)self;
+    (void)args;
+    return PyLong_FromLong(pool_threads());
+}
+
+static PyMethodDef methods[] = {
+    { "read_csv", (PyCFunction)(void (*)(void))read_csv, METH_VARARGS | METH_KEYWORDS,
+      "read_csv(source, names=None, threads=0, start=0, stop=-1, ranges=None) -> dict\n\n"
+      "Reads the named columns of a CSV file (every column when names is None);\n"
+      "source is its path (gzip files are decompressed), its bytes, or a list of\n"
+      "paths of files with the same columns, whose rows are concatenated.\n"
+      "Integer and numeric columns become int64/float64 arrays, others lists of\n"
+      "str. threads=0 uses one thread per CPU. start/stop limit the read to the\n"
+      "records starting within that byte range (stop=-1: end of file); ranges\n"
+      "limits it to the records starting within a list of (start, stop) byte\n"
+      "ranges, in order (for a list of paths: one such list per file)." },
+    { "read_json", (PyCFunction)(void (*)(void))read_json, METH_VARARGS | METH_KEYWORDS,
+      "read_json(path, names=None) -> dict\n\n"
+      "Reads the named keys of the top-level object of a JSON file (every key\n"
+      "when names is None; gzip files are decompressed). Non-empty arrays of\n"
+      "numbers become int64/float64 arrays (booleans count as integers); other\n"
+      "values are what json.loads returns for them." },
+    { "read_sqlite", (PyCFunction)(void (*)(void))read_sqlite, METH_VARARGS | METH_KEYWORDS,
+      "read_sqlite(path, table, names=None, start=0, stop=-1) -> dict\n\n"
+      "Reads the named columns of a table of a SQLite database (every column\n"
+      "when names is None), in rows [start, stop) of the table's order (stop=-1:\n"
+      "to the end). Non-empty INTEGER columns become int64 arrays, INTEGER/REAL\n"
+      "ones float64 arrays; others are lists of what the sqlite3 module returns." },
+    { "write_csv", (PyCFunction)write_csv, METH_VARARGS,
+      "write_csv(path, names, columns) -> None\n\n"
+      "Writes a CSV file with a header of names and one column per name, each\n"
+      "an int64/float64 array or a sequence of str, to the longest column's\n"
+      "length (shorter columns leave cells empty). Numbers are written as str()\n"
+      "writes them and text is quoted as csv.writer quotes it." },
+    { "avg", avg, METH_O,
+      "avg(x) -> float\n\n"
+      "Mean of a 1-D int64/float64 array: float64 values summed in np.mean's\n"
+      "pairwise order (the same result), int64 ones summed exactly and divided\n"
+      "as Python divides ints." },
+    { "running_sum", running_sum, METH_VARARGS,
+      "running_sum(x, out=None) -> array\n\n"
+      "np.cumsum of a 1-D int64/float64 array, written to out when given (a\n"
+      "contiguous array of x's shape and dtype, which may be x)." },
+    { "diff", diff, METH_O,
+      "diff(x) -> array\n\n"
+      "np.diff of a 1-D int64/float64 array." },
+    { "reverse", reverse, METH_O,
+      "reverse(x) -> array\n\n"
+      "A reversed copy of a 1-D int64/float64 array." },
+    { "minmax", minmax, METH_O,
+      "minmax(x) -> (min, max)\n\n"
+      "x.min() and x.max() of a non-empty 1-D int64/float64 array, in one pass." },
+    { "arith", arith, METH_VARARGS,
+      "arith(op, a, b) -> array\n\n"
+      "a op b for op one of + - * /, where a and b are 1-D int64/float64 arrays\n"
+      "of one length (or of length 1) or an array and an int or float: NumPy's\n"
+      "result, split across threads. NotImplemented for other operands." },
+    { "sort", sort, METH_O,
+      "sort(x) -> array\n\n"
+      "np.sort of a 1-D int64/float64 array, split across threads from\n"
+      "PARALLEL_MIN values on." },
+    { "threads", threads, METH_NOARGS,
+      "threads() -> int\n\n"
+      "Threads the kernels run on: WIZUALL_THREADS, else one per CPU. Vectors\n"
+      "shorter than PARALLEL_MIN stay on one." },
+    { NULL, NULL, 0, NULL }
+};
+
+static struct PyModuleDef module = {
+    PyModuleDef_HEAD_INIT, "wizuall_rt", "Native runtime for WizuAll generated programs.", -1, methods,
+    NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit_wizuall_rt(void) {
+    import_array();
+    PyObject* m = PyModule_Create(&module);
+    if (m && PyModule_AddIntConstant(m, "PARALLEL_MIN", (long)PARALLEL_MIN) < 0) Py_CLEAR(m);
+    return m;
+}
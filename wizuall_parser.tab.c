@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.5.1.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -34,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -41,14 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
-
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.5.1"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -72,6 +73,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "ir/ast.h"
+#include "ir/import_schema.h"
 
 ASTNode* final_ast = NULL;
 
@@ -80,7 +82,64 @@ extern int yylineno;
 extern int yycolumn;
 extern char* yytext;
 
-#line 84 "wizuall_parser.tab.c"
+int yylex(void);
+void yyerror(const char *s);
+
+// A SQLite database is imported one table at a time, only databases have
+// tables, and only CSV files are concatenated from a pattern
+static bool check_import(const char* filename, const char* table) {
+    char path[256];
+    import_path(filename, path, sizeof(path));
+    bool database = import_format(path) == IMPORT_SQLITE;
+    if (database && !table) yyerror("a database is imported with `table \"name\"` after the file name");
+    else if (!database && table) yyerror("only a SQLite database (.db, .sqlite, .sqlite3) is imported with a table");
+    else if (import_is_pattern(path) && import_format(path) != IMPORT_CSV) yyerror("only CSV files are imported by pattern");
+    else return true;
+    return false;
+}
+
+// Only CSV files are sampled: the other readers have no cheap way to skip rows
+static bool check_sample(const char* filename) {
+    char path[256];
+    import_path(filename, path, sizeof(path));
+    if (import_format(path) == IMPORT_CSV) return true;
+    yyerror("only CSV files are imported with sample");
+    return false;
+}
+
+// A live import follows one growing file (or FIFO) from where it last read
+static bool check_live(const char* filename) {
+    char path[256];
+    import_path(filename, path, sizeof(path));
+    if (import_format(path) != IMPORT_CSV) yyerror("only CSV files are imported live");
+    else if (import_is_pattern(path)) yyerror("a pattern is not imported live");
+    else if (strlen(path) > 3 && strcmp(path + strlen(path) - 3, ".gz") == 0) yyerror("a .gz file is not imported live");
+    else return true;
+    return false;
+}
+
+// `export x, y to "f";` writes named vectors, each once: the file is a CSV
+// table or a binary `.wzb` archive of columns
+static bool check_export(ASTList* names, const char* filename) {
+    char path[256];
+    import_path(filename, path, sizeof(path));
+    size_t len = strlen(path);
+    bool csv = len > 4 && strcmp(path + len - 4, ".csv") == 0;
+    bool wzb = len > 4 && strcmp(path + len - 4, ".wzb") == 0;
+    if (!csv && !wzb) {
+        yyerror("export writes a .wzb or .csv file");
+        return false;
+    }
+    for (ASTList* n = names; n; n = n->next)
+        for (ASTList* m = n->next; m; m = m->next)
+            if (strcmp(n->node->id_name, m->node->id_name) == 0) {
+                yyerror("a vector is exported once per file");
+                return false;
+            }
+    return true;
+}
+
+#line 143 "wizuall_parser.tab.c"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -103,100 +162,79 @@ extern char* yytext;
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
-
-/* Use api.header.include to #include this header
-   instead of duplicating it here.  */
-#ifndef YY_YY_WIZUALL_PARSER_TAB_H_INCLUDED
-# define YY_YY_WIZUALL_PARSER_TAB_H_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    NUMBER = 258,
-    ID = 259,
-    STRING = 260,
-    LT = 261,
-    GT = 262,
-    IF = 263,
-    ELSE = 264,
-    WHILE = 265,
-    FOR = 266,
-    BEGIN_AUX = 267,
-    END_AUX = 268,
-    SORT = 269,
-    REVERSE = 270,
-    SLICE = 271,
-    AVG = 272,
-    TRANSPOSE = 273,
-    RUNNING_SUM = 274,
-    PAIRWISE_COMPARE = 275,
-    PARETO_SET = 276,
-    PLOT = 277,
-    HISTOGRAM = 278,
-    HEATMAP = 279,
-    BARCHART = 280,
-    PIECHART = 281,
-    SCATTER = 282,
-    BOXPLOT = 283,
-    TIMELINE = 284,
-    PLUS = 285,
-    MINUS = 286,
-    TIMES = 287,
-    DIVIDE = 288,
-    ASSIGN = 289,
-    COMMA = 290,
-    SEMICOLON = 291,
-    LPAREN = 292,
-    RPAREN = 293,
-    LBRACE = 294,
-    RBRACE = 295,
-    LBRACKET = 296,
-    RBRACKET = 297,
-    IMPORT = 298
-  };
-#endif
-
-/* Value type.  */
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-union YYSTYPE
+#include "wizuall_parser.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-#line 16 "grammar/wizuall_parser.y"
-
-    double num;
-    char* str;
-    struct ASTNode* ast;
-    struct ASTList* list;
-
-#line 187 "wizuall_parser.tab.c"
-
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_NUMBER = 3,                     /* NUMBER  */
+  YYSYMBOL_ID = 4,                         /* ID  */
+  YYSYMBOL_STRING = 5,                     /* STRING  */
+  YYSYMBOL_LT = 6,                         /* LT  */
+  YYSYMBOL_GT = 7,                         /* GT  */
+  YYSYMBOL_IF = 8,                         /* IF  */
+  YYSYMBOL_ELSE = 9,                       /* ELSE  */
+  YYSYMBOL_WHILE = 10,                     /* WHILE  */
+  YYSYMBOL_FOR = 11,                       /* FOR  */
+  YYSYMBOL_BEGIN_AUX = 12,                 /* BEGIN_AUX  */
+  YYSYMBOL_END_AUX = 13,                   /* END_AUX  */
+  YYSYMBOL_SORT = 14,                      /* SORT  */
+  YYSYMBOL_REVERSE = 15,                   /* REVERSE  */
+  YYSYMBOL_SLICE = 16,                     /* SLICE  */
+  YYSYMBOL_AVG = 17,                       /* AVG  */
+  YYSYMBOL_TRANSPOSE = 18,                 /* TRANSPOSE  */
+  YYSYMBOL_RUNNING_SUM = 19,               /* RUNNING_SUM  */
+  YYSYMBOL_PAIRWISE_COMPARE = 20,          /* PAIRWISE_COMPARE  */
+  YYSYMBOL_PARETO_SET = 21,                /* PARETO_SET  */
+  YYSYMBOL_PLOT = 22,                      /* PLOT  */
+  YYSYMBOL_HISTOGRAM = 23,                 /* HISTOGRAM  */
+  YYSYMBOL_HEATMAP = 24,                   /* HEATMAP  */
+  YYSYMBOL_BARCHART = 25,                  /* BARCHART  */
+  YYSYMBOL_PIECHART = 26,                  /* PIECHART  */
+  YYSYMBOL_SCATTER = 27,                   /* SCATTER  */
+  YYSYMBOL_BOXPLOT = 28,                   /* BOXPLOT  */
+  YYSYMBOL_TIMELINE = 29,                  /* TIMELINE  */
+  YYSYMBOL_PLUS = 30,                      /* PLUS  */
+  YYSYMBOL_MINUS = 31,                     /* MINUS  */
+  YYSYMBOL_TIMES = 32,                     /* TIMES  */
+  YYSYMBOL_DIVIDE = 33,                    /* DIVIDE  */
+  YYSYMBOL_ASSIGN = 34,                    /* ASSIGN  */
+  YYSYMBOL_COMMA = 35,                     /* COMMA  */
+  YYSYMBOL_SEMICOLON = 36,                 /* SEMICOLON  */
+  YYSYMBOL_LPAREN = 37,                    /* LPAREN  */
+  YYSYMBOL_RPAREN = 38,                    /* RPAREN  */
+  YYSYMBOL_LBRACE = 39,                    /* LBRACE  */
+  YYSYMBOL_RBRACE = 40,                    /* RBRACE  */
+  YYSYMBOL_LBRACKET = 41,                  /* LBRACKET  */
+  YYSYMBOL_RBRACKET = 42,                  /* RBRACKET  */
+  YYSYMBOL_IMPORT = 43,                    /* IMPORT  */
+  YYSYMBOL_YYACCEPT = 44,                  /* $accept  */
+  YYSYMBOL_Program = 45,                   /* Program  */
+  YYSYMBOL_StatementList = 46,             /* StatementList  */
+  YYSYMBOL_Statement = 47,                 /* Statement  */
+  YYSYMBOL_ImportStatement = 48,           /* ImportStatement  */
+  YYSYMBOL_ExportStatement = 49,           /* ExportStatement  */
+  YYSYMBOL_ExportNames = 50,               /* ExportNames  */
+  YYSYMBOL_Assignment = 51,                /* Assignment  */
+  YYSYMBOL_ControlStructure = 52,          /* ControlStructure  */
+  YYSYMBOL_FunctionCall = 53,              /* FunctionCall  */
+  YYSYMBOL_VisualizationCall = 54,         /* VisualizationCall  */
+  YYSYMBOL_Expression = 55,                /* Expression  */
+  YYSYMBOL_Term = 56,                      /* Term  */
+  YYSYMBOL_Factor = 57,                    /* Factor  */
+  YYSYMBOL_VectorLiteral = 58,             /* VectorLiteral  */
+  YYSYMBOL_VectorElements = 59,            /* VectorElements  */
+  YYSYMBOL_ArgListOpt = 60,                /* ArgListOpt  */
+  YYSYMBOL_ArgList = 61,                   /* ArgList  */
+  YYSYMBOL_VizArgListOpt = 62,             /* VizArgListOpt  */
+  YYSYMBOL_VizArgList = 63,                /* VizArgList  */
+  YYSYMBOL_VizArg = 64                     /* VizArg  */
 };
-typedef union YYSTYPE YYSTYPE;
-# define YYSTYPE_IS_TRIVIAL 1
-# define YYSTYPE_IS_DECLARED 1
-#endif
-
-
-extern YYSTYPE yylval;
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-int yyparse (void);
-
-#endif /* !YY_YY_WIZUALL_PARSER_TAB_H_INCLUDED  */
 
 
 
@@ -237,6 +275,18 @@ typedef int_least16_t yytype_int16;
 typedef short yytype_int16;
 #endif
 
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
 #if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
 typedef __UINT_LEAST8_TYPE__ yytype_uint8;
 #elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
@@ -296,8 +346,9 @@ typedef int yytype_uint16;
 
 #define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
 
+
 /* Stored state numbers (used for stacks). */
-typedef yytype_int8 yy_state_t;
+typedef yytype_uint8 yy_state_t;
 
 /* State numbers in computations.  */
 typedef int yy_state_fast_t;
@@ -314,6 +365,7 @@ typedef int yy_state_fast_t;
 # endif
 #endif
 
+
 #ifndef YY_ATTRIBUTE_PURE
 # if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
 #  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
@@ -332,17 +384,23 @@ typedef int yy_state_fast_t;
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && ! defined __ICC && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                            \
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
     _Pragma ("GCC diagnostic push")                                     \
     _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
 # define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
@@ -371,7 +429,7 @@ typedef int yy_state_fast_t;
 
 #define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -436,8 +494,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -500,27 +557,29 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  36
+#define YYFINAL  39
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   211
+#define YYLAST   214
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  44
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  19
+#define YYNNTS  21
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  51
+#define YYNRULES  59
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  126
+#define YYNSTATES  142
 
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   298
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex, with out-of-bounds checking.  */
-#define YYTRANSLATE(YYX)                                                \
-  (0 <= (YYX) && (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex.  */
@@ -559,51 +618,52 @@ static const yytype_int8 yytranslate[] =
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
-static const yytype_uint8 yyrline[] =
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
 {
-       0,    55,    55,    59,    60,    64,    65,    66,    67,    68,
-      72,    76,    80,    82,    84,    89,    93,    94,    95,    96,
-      97,    98,    99,   100,   104,   105,   106,   107,   108,   112,
-     113,   114,   118,   119,   120,   121,   122,   123,   127,   132,
-     133,   137,   138,   142,   143,   147,   148,   152,   153,   157,
-     162,   166
+       0,   114,   114,   118,   119,   123,   124,   125,   126,   127,
+     128,   132,   137,   147,   158,   172,   188,   202,   203,   207,
+     211,   213,   215,   220,   224,   225,   226,   227,   228,   229,
+     230,   231,   235,   236,   237,   238,   239,   243,   244,   245,
+     249,   250,   251,   252,   253,   254,   258,   263,   264,   268,
+     269,   273,   274,   278,   279,   283,   284,   288,   293,   297
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 0
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "NUMBER", "ID", "STRING", "LT", "GT",
-  "IF", "ELSE", "WHILE", "FOR", "BEGIN_AUX", "END_AUX", "SORT", "REVERSE",
-  "SLICE", "AVG", "TRANSPOSE", "RUNNING_SUM", "PAIRWISE_COMPARE",
-  "PARETO_SET", "PLOT", "HISTOGRAM", "HEATMAP", "BARCHART", "PIECHART",
-  "SCATTER", "BOXPLOT", "TIMELINE", "PLUS", "MINUS", "TIMES", "DIVIDE",
-  "ASSIGN", "COMMA", "SEMICOLON", "LPAREN", "RPAREN", "LBRACE", "RBRACE",
-  "LBRACKET", "RBRACKET", "IMPORT", "$accept", "Program", "StatementList",
-  "Statement", "ImportStatement", "Assignment", "ControlStructure",
+  "\"end of file\"", "error", "\"invalid token\"", "NUMBER", "ID",
+  "STRING", "LT", "GT", "IF", "ELSE", "WHILE", "FOR", "BEGIN_AUX",
+  "END_AUX", "SORT", "REVERSE", "SLICE", "AVG", "TRANSPOSE", "RUNNING_SUM",
+  "PAIRWISE_COMPARE", "PARETO_SET", "PLOT", "HISTOGRAM", "HEATMAP",
+  "BARCHART", "PIECHART", "SCATTER", "BOXPLOT", "TIMELINE", "PLUS",
+  "MINUS", "TIMES", "DIVIDE", "ASSIGN", "COMMA", "SEMICOLON", "LPAREN",
+  "RPAREN", "LBRACE", "RBRACE", "LBRACKET", "RBRACKET", "IMPORT",
+  "$accept", "Program", "StatementList", "Statement", "ImportStatement",
+  "ExportStatement", "ExportNames", "Assignment", "ControlStructure",
   "FunctionCall", "VisualizationCall", "Expression", "Term", "Factor",
   "VectorLiteral", "VectorElements", "ArgListOpt", "ArgList",
   "VizArgListOpt", "VizArgList", "VizArg", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_int16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,   297,   298
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF (-29)
+#define YYPACT_NINF (-66)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
@@ -613,164 +673,173 @@ static const yytype_int16 yytoknum[] =
 #define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-     132,   -16,   -26,   -17,   -15,   -10,     2,     7,    15,    26,
-      30,    37,    41,     8,    69,   132,   -29,   -29,    43,   -29,
-      44,    45,     4,     4,     4,     4,    87,   147,   147,   147,
-     147,   147,   147,   147,   147,    56,   -29,   -29,   -29,   -29,
-     -29,   -29,    59,   -29,     4,     4,   -29,   160,     5,   -29,
-     -29,   160,    55,    62,    88,   138,    67,    66,    39,   160,
-      73,    80,   -29,    86,    89,    99,   100,   101,   103,   115,
-     -29,   141,   160,   -23,     4,     4,     4,     4,     4,     4,
-     -29,     4,    65,    68,     4,   159,   -29,   147,   -29,   -29,
-     -29,   -29,   -29,   -29,   -29,   -29,     4,   -29,     5,     5,
-       5,     5,   -29,   -29,   160,   132,   132,    17,   -29,   160,
-     -29,   160,     6,    32,    87,   116,   -29,   127,   131,   135,
-     132,   132,    60,   106,   -29,   -29
+     148,    19,   -16,    10,    23,    33,    50,    52,    58,    59,
+      61,    75,    83,   118,   129,   148,   -66,   -66,   -66,    95,
+     -66,   107,   117,   -66,    47,    47,    81,    47,    47,   150,
+      60,    60,    60,    60,    60,    60,    60,    60,    54,   -66,
+     -66,   -66,   -66,   -66,   -66,   120,   -66,    47,    47,   -66,
+     172,   -24,   -66,   -66,   172,   142,   146,   177,   151,    62,
+     104,   149,   153,    11,   172,   152,   159,   -66,   158,   160,
+     161,   162,   163,   166,   167,     8,   -66,   154,   172,   -30,
+      47,    47,    47,    47,    47,    47,   -66,    47,   170,   -66,
+     147,   156,    47,    78,   -66,    60,   -66,   -66,   -66,   -66,
+     -66,   -66,   -66,    63,   171,   -66,   -66,    47,   -66,   -24,
+     -24,   -24,   -24,   -66,   -66,   172,   -66,   148,   148,   157,
+     -66,   172,   -66,   173,   -66,   -66,   172,     6,    14,   150,
+     -66,   188,   -66,   174,   169,   175,   148,   148,    51,   122,
+     -66,   -66
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
 static const yytype_int8 yydefact[] =
 {
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     2,     3,     5,     0,     7,
-       0,     0,     0,    42,     0,     0,     0,    46,    46,    46,
-      46,    46,    46,    46,    46,     0,     1,     4,     6,     9,
-       8,    32,    33,    34,     0,     0,    36,    11,    28,    31,
-      35,    43,     0,    41,     0,     0,     0,     0,    33,    51,
-       0,    45,    47,     0,     0,     0,     0,     0,     0,     0,
-      10,     0,    39,     0,     0,     0,     0,     0,     0,     0,
-      15,     0,     0,     0,     0,     0,    16,     0,    17,    18,
-      19,    20,    21,    22,    23,    37,     0,    38,    26,    27,
-      24,    25,    29,    30,    44,     0,     0,     0,    34,    50,
-      48,    40,     0,     0,     0,     0,    13,     0,     0,     0,
-       0,     0,     0,     0,    12,    14
+       0,     0,     0,     0,     0,     2,     3,     5,     6,     0,
+       8,     0,     0,    17,     0,    50,     0,     0,     0,     0,
+      54,    54,    54,    54,    54,    54,    54,    54,     0,     1,
+       4,     7,    10,     9,    40,    41,    42,     0,     0,    44,
+      19,    36,    39,    43,    51,     0,    49,     0,     0,     0,
+       0,     0,     0,    41,    59,     0,    53,    55,     0,     0,
+       0,     0,     0,     0,     0,     0,    11,     0,    47,     0,
+       0,     0,     0,     0,     0,     0,    23,     0,     0,    18,
+       0,     0,     0,     0,    24,     0,    25,    26,    27,    28,
+      29,    30,    31,     0,     0,    12,    45,     0,    46,    34,
+      35,    32,    33,    37,    38,    52,    16,     0,     0,     0,
+      42,    58,    56,     0,    14,    13,    48,     0,     0,     0,
+      15,     0,    21,     0,     0,     0,     0,     0,     0,     0,
+      20,    22
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
-static const yytype_int16 yypgoto[] =
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int8 yypgoto[] =
 {
-     -29,   -29,    72,   -14,   -29,   -24,   -29,     0,   -29,   -19,
-     134,   -28,   -29,   -29,   -29,   -29,   173,   -29,    93
+     -66,   -66,     4,   -14,   -66,   -66,   -66,   -27,   -66,     0,
+     -66,   -21,    86,   -65,   -66,   -66,   -66,   -66,    72,   -66,
+     115
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
+/* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int8 yydefgoto[] =
 {
-      -1,    14,    15,    16,    17,    18,    19,    46,    21,    59,
-      48,    49,    50,    73,    52,    53,    60,    61,    62
+       0,    14,    15,    16,    17,    18,    26,    19,    20,    49,
+      22,    64,    51,    52,    53,    79,    55,    56,    65,    66,
+      67
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
-static const yytype_int8 yytable[] =
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_uint8 yytable[] =
 {
-      20,    37,    57,    47,    51,    54,    55,    41,    42,    43,
-       1,    24,    96,    35,     2,    20,     3,     4,    22,    97,
-      25,    23,    26,    74,    75,    71,    72,    27,     5,     6,
-       7,     8,     9,    10,    11,    12,     1,    78,    79,    28,
-       2,    44,     3,     4,    29,    45,   115,    76,    77,    13,
-     102,   103,    30,   114,     5,     6,     7,     8,     9,    10,
-      11,    12,   104,    31,     1,   107,   109,    32,     2,    36,
-       3,     4,   116,    85,    33,    13,    23,   111,    34,    38,
-      39,    40,     5,     6,     7,     8,     9,    10,    11,    12,
-     117,    56,    70,    80,    74,    75,    23,    81,    37,    37,
-     124,    22,    84,    13,   105,    20,    20,   106,    37,    37,
-       1,    86,    20,    20,     2,    87,     3,     4,    76,    77,
-      20,    20,    20,    20,    88,   118,    82,    89,     5,     6,
-       7,     8,     9,    10,    11,    12,     1,    90,    91,    92,
-       2,    93,     3,     4,    74,    75,   125,    74,    75,    13,
-      41,    58,    43,    94,     5,     6,     7,     8,     9,    10,
-      11,    12,    41,    42,   108,   119,    74,    75,    76,    77,
-     120,    76,    77,     0,   121,    13,    83,   112,   113,    95,
-     110,     0,     0,     0,    44,     0,     0,     0,    45,     0,
-      76,    77,   122,   123,     0,     0,    44,     0,     0,     0,
-      45,    63,    64,    65,    66,    67,    68,    69,    98,    99,
-     100,   101
+      21,    40,    62,    50,    54,   107,    59,    60,    84,    85,
+       1,   103,   108,   104,     2,    21,     3,     4,     1,   113,
+     114,    27,     2,    23,     3,     4,    77,    78,     5,     6,
+       7,     8,     9,    10,    11,    12,     5,     6,     7,     8,
+       9,    10,    11,    12,   105,    93,   131,    28,    25,    13,
+      44,    45,    46,    24,   132,     1,    25,    13,    75,     2,
+      29,     3,     4,    44,    63,    46,   115,   123,    80,    81,
+      30,   119,   121,     5,     6,     7,     8,     9,    10,    11,
+      12,    44,    45,   120,    47,    57,   126,    31,    48,    32,
+      76,   140,    82,    83,    13,    33,    34,    47,    35,   124,
+      90,    48,   133,    68,    69,    70,    71,    72,    73,    74,
+      80,    81,    36,    40,    40,    47,    58,    21,    21,    48,
+      37,   127,   128,    38,    40,    40,     1,    21,    21,    39,
+       2,    41,     3,     4,    82,    83,    21,    21,    21,    21,
+     138,   139,    91,    42,     5,     6,     7,     8,     9,    10,
+      11,    12,     1,    43,    61,    89,     2,    25,     3,     4,
+      80,    81,   141,    80,    81,    13,   109,   110,   111,   112,
+       5,     6,     7,     8,     9,    10,    11,    12,    80,    81,
+      86,    87,    88,    24,    82,    83,   117,    82,    83,    92,
+      94,    13,   106,   129,    95,   118,    96,   134,    97,    98,
+      99,   100,    82,    83,   101,   102,   116,   125,   136,   130,
+     122,     0,   135,     0,   137
 };
 
-static const yytype_int8 yycheck[] =
+static const yytype_int16 yycheck[] =
 {
-       0,    15,    26,    22,    23,    24,    25,     3,     4,     5,
-       4,    37,    35,     5,     8,    15,    10,    11,    34,    42,
-      37,    37,    37,     6,     7,    44,    45,    37,    22,    23,
-      24,    25,    26,    27,    28,    29,     4,    32,    33,    37,
-       8,    37,    10,    11,    37,    41,    40,    30,    31,    43,
-      78,    79,    37,    36,    22,    23,    24,    25,    26,    27,
-      28,    29,    81,    37,     4,    84,    85,    37,     8,     0,
-      10,    11,    40,    34,    37,    43,    37,    96,    37,    36,
-      36,    36,    22,    23,    24,    25,    26,    27,    28,    29,
-     114,     4,    36,    38,     6,     7,    37,    35,   112,   113,
-      40,    34,    36,    43,    39,   105,   106,    39,   122,   123,
-       4,    38,   112,   113,     8,    35,    10,    11,    30,    31,
-     120,   121,   122,   123,    38,     9,    38,    38,    22,    23,
-      24,    25,    26,    27,    28,    29,     4,    38,    38,    38,
-       8,    38,    10,    11,     6,     7,    40,     6,     7,    43,
-       3,     4,     5,    38,    22,    23,    24,    25,    26,    27,
-      28,    29,     3,     4,     5,    38,     6,     7,    30,    31,
-      39,    30,    31,    -1,    39,    43,    38,   105,   106,    38,
-      87,    -1,    -1,    -1,    37,    -1,    -1,    -1,    41,    -1,
-      30,    31,   120,   121,    -1,    -1,    37,    -1,    -1,    -1,
-      41,    28,    29,    30,    31,    32,    33,    34,    74,    75,
-      76,    77
+       0,    15,    29,    24,    25,    35,    27,    28,    32,    33,
+       4,     3,    42,     5,     8,    15,    10,    11,     4,    84,
+      85,    37,     8,     4,    10,    11,    47,    48,    22,    23,
+      24,    25,    26,    27,    28,    29,    22,    23,    24,    25,
+      26,    27,    28,    29,    36,    34,    40,    37,    37,    43,
+       3,     4,     5,    34,    40,     4,    37,    43,     4,     8,
+      37,    10,    11,     3,     4,     5,    87,     4,     6,     7,
+      37,    92,    93,    22,    23,    24,    25,    26,    27,    28,
+      29,     3,     4,     5,    37,     4,   107,    37,    41,    37,
+      36,    40,    30,    31,    43,    37,    37,    37,    37,    36,
+      38,    41,   129,    31,    32,    33,    34,    35,    36,    37,
+       6,     7,    37,   127,   128,    37,    35,   117,   118,    41,
+      37,   117,   118,     5,   138,   139,     4,   127,   128,     0,
+       8,    36,    10,    11,    30,    31,   136,   137,   138,   139,
+     136,   137,    38,    36,    22,    23,    24,    25,    26,    27,
+      28,    29,     4,    36,     4,     4,     8,    37,    10,    11,
+       6,     7,    40,     6,     7,    43,    80,    81,    82,    83,
+      22,    23,    24,    25,    26,    27,    28,    29,     6,     7,
+      38,    35,     5,    34,    30,    31,    39,    30,    31,    36,
+      38,    43,    38,    36,    35,    39,    38,     9,    38,    38,
+      38,    38,    30,    31,    38,    38,    36,    36,    39,    36,
+      95,    -1,    38,    -1,    39
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
        0,     4,     8,    10,    11,    22,    23,    24,    25,    26,
-      27,    28,    29,    43,    45,    46,    47,    48,    49,    50,
-      51,    52,    34,    37,    37,    37,    37,    37,    37,    37,
-      37,    37,    37,    37,    37,     5,     0,    47,    36,    36,
-      36,     3,     4,     5,    37,    41,    51,    53,    54,    55,
-      56,    53,    58,    59,    53,    53,     4,    49,     4,    53,
-      60,    61,    62,    60,    60,    60,    60,    60,    60,    60,
-      36,    53,    53,    57,     6,     7,    30,    31,    32,    33,
-      38,    35,    38,    38,    36,    34,    38,    35,    38,    38,
-      38,    38,    38,    38,    38,    38,    35,    42,    54,    54,
-      54,    54,    55,    55,    53,    39,    39,    53,     5,    53,
-      62,    53,    46,    46,    36,    40,    40,    49,     9,    38,
-      39,    39,    46,    46,    40,    40
+      27,    28,    29,    43,    45,    46,    47,    48,    49,    51,
+      52,    53,    54,     4,    34,    37,    50,    37,    37,    37,
+      37,    37,    37,    37,    37,    37,    37,    37,     5,     0,
+      47,    36,    36,    36,     3,     4,     5,    37,    41,    53,
+      55,    56,    57,    58,    55,    60,    61,     4,    35,    55,
+      55,     4,    51,     4,    55,    62,    63,    64,    62,    62,
+      62,    62,    62,    62,    62,     4,    36,    55,    55,    59,
+       6,     7,    30,    31,    32,    33,    38,    35,     5,     4,
+      38,    38,    36,    34,    38,    35,    38,    38,    38,    38,
+      38,    38,    38,     3,     5,    36,    38,    35,    42,    56,
+      56,    56,    56,    57,    57,    55,    36,    39,    39,    55,
+       5,    55,    64,     4,    36,    36,    55,    46,    46,    36,
+      36,    40,    40,    51,     9,    38,    39,    39,    46,    46,
+      40,    40
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
        0,    44,    45,    46,    46,    47,    47,    47,    47,    47,
-      48,    49,    50,    50,    50,    51,    52,    52,    52,    52,
-      52,    52,    52,    52,    53,    53,    53,    53,    53,    54,
-      54,    54,    55,    55,    55,    55,    55,    55,    56,    57,
-      57,    58,    58,    59,    59,    60,    60,    61,    61,    62,
-      62,    62
+      47,    48,    48,    48,    48,    48,    49,    50,    50,    51,
+      52,    52,    52,    53,    54,    54,    54,    54,    54,    54,
+      54,    54,    55,    55,    55,    55,    55,    56,    56,    56,
+      57,    57,    57,    57,    57,    57,    58,    59,    59,    60,
+      60,    61,    61,    62,    62,    63,    63,    64,    64,    64
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
-       0,     2,     1,     1,     2,     1,     2,     1,     2,     2,
-       3,     3,    11,     7,    11,     4,     4,     4,     4,     4,
-       4,     4,     4,     4,     3,     3,     3,     3,     1,     3,
-       3,     1,     1,     1,     1,     1,     1,     3,     3,     1,
-       3,     1,     0,     1,     3,     1,     0,     1,     3,     3,
-       3,     1
+       0,     2,     1,     1,     2,     1,     1,     2,     1,     2,
+       2,     3,     4,     5,     5,     6,     5,     1,     3,     3,
+      11,     7,    11,     4,     4,     4,     4,     4,     4,     4,
+       4,     4,     3,     3,     3,     3,     1,     3,     3,     1,
+       1,     1,     1,     1,     1,     3,     3,     1,     3,     1,
+       0,     1,     3,     1,     0,     1,     3,     3,     3,     1
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
@@ -792,10 +861,9 @@ static const yytype_int8 yyr2[] =
       }                                                           \
   while (0)
 
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 
 /* Enable debugging if requested.  */
@@ -812,19 +880,16 @@ do {                                            \
     YYFPRINTF Args;                             \
 } while (0)
 
-/* This macro is provided for backward compatibility. */
-#ifndef YY_LOCATION_PRINT
-# define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-#endif
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value); \
+                  Kind, Value); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -835,18 +900,15 @@ do {                                                                      \
 `-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
   FILE *yyoutput = yyo;
-  YYUSE (yyoutput);
+  YY_USE (yyoutput);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyo, yytoknum[yytype], *yyvaluep);
-# endif
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -856,12 +918,13 @@ yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep)
 `---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
   YYFPRINTF (yyo, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyo, yytype, yyvaluep);
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
   YYFPRINTF (yyo, ")");
 }
 
@@ -894,7 +957,8 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, int yyrule)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -906,9 +970,8 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, int yyrule)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[+yyssp[yyi + 1 - yynrhs]],
-                       &yyvsp[(yyi + 1) - (yynrhs)]
-                                              );
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -923,8 +986,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -947,259 +1010,30 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
-
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
-#  else
-/* Return the length of YYSTR.  */
-static YYPTRDIFF_T
-yystrlen (const char *yystr)
-{
-  YYPTRDIFF_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
-
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
-
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYPTRDIFF_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYPTRDIFF_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-        switch (*++yyp)
-          {
-          case '\'':
-          case ',':
-            goto do_not_strip_quotes;
-
-          case '\\':
-            if (*++yyp != '\\')
-              goto do_not_strip_quotes;
-            else
-              goto append;
-
-          append:
-          default:
-            if (yyres)
-              yyres[yyn] = *yyp;
-            yyn++;
-            break;
-
-          case '"':
-            if (yyres)
-              yyres[yyn] = '\0';
-            return yyn;
-          }
-    do_not_strip_quotes: ;
-    }
-
-  if (yyres)
-    return yystpcpy (yyres, yystr) - yyres;
-  else
-    return yystrlen (yystr);
-}
-# endif
-
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
-
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int
-yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
-                yy_state_t *yyssp, int yytoken)
-{
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat: reported tokens (one for the "unexpected",
-     one per "expected"). */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Actual size of YYARG. */
-  int yycount = 0;
-  /* Cumulated lengths of YYARG.  */
-  YYPTRDIFF_T yysize = 0;
-
-  /* There are many possibilities here to consider:
-     - If this state is a consistent state with a default action, then
-       the only way this function was invoked is if the default action
-       is an error action.  In that case, don't check for expected
-       tokens because there are none.
-     - The only way there can be no lookahead present (in yychar) is if
-       this state is a consistent state with a default action.  Thus,
-       detecting the absence of a lookahead is sufficient to determine
-       that there is no unexpected or expected token to report.  In that
-       case, just report a simple "syntax error".
-     - Don't assume there isn't a lookahead just because this state is a
-       consistent state with a default action.  There might have been a
-       previous inconsistent state, consistent state with a non-default
-       action, or user semantic action that manipulated yychar.
-     - Of course, the expected token list depends on states to have
-       correct lookahead information, and it depends on the parser not
-       to perform extra reductions after fetching a lookahead from the
-       scanner and before detecting a syntax error.  Thus, state merging
-       (from LALR or IELR) and default reductions corrupt the expected
-       token list.  However, the list is correct for canonical LR with
-       one exception: it will still contain any token that will not be
-       accepted due to an error action in a later state.
-  */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[+*yyssp];
-      YYPTRDIFF_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-      yysize = yysize0;
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYPTRDIFF_T yysize1
-                    = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-                    yysize = yysize1;
-                  else
-                    return 2;
-                }
-              }
-        }
-    }
-
-  switch (yycount)
-    {
-# define YYCASE_(N, S)                      \
-      case N:                               \
-        yyformat = S;                       \
-      break
-    default: /* Avoid compiler warnings. */
-      YYCASE_(0, YY_("syntax error"));
-      YYCASE_(1, YY_("syntax error, unexpected %s"));
-      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
 
-  {
-    /* Don't count the "%s"s in the final size, but reserve room for
-       the terminator.  */
-    YYPTRDIFF_T yysize1 = yysize + (yystrlen (yyformat) - 2 * yycount) + 1;
-    if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-      yysize = yysize1;
-    else
-      return 2;
-  }
 
-  if (*yymsg_alloc < yysize)
-    {
-      *yymsg_alloc = 2 * yysize;
-      if (! (yysize <= *yymsg_alloc
-             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
-    }
 
-  /* Avoid sprintf, as that infringes on the user's name space.
-     Don't have undefined behavior even if the translation
-     produced a string with the wrong number of "%s"s.  */
-  {
-    char *yyp = *yymsg;
-    int yyi = 0;
-    while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
-        {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
-          yyformat += 2;
-        }
-      else
-        {
-          ++yyp;
-          ++yyformat;
-        }
-  }
-  return 0;
-}
-#endif /* YYERROR_VERBOSE */
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
 {
-  YYUSE (yyvaluep);
+  YY_USE (yyvaluep);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-
-
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 /* The semantic value of the lookahead symbol.  */
@@ -1208,6 +1042,8 @@ YYSTYPE yylval;
 int yynerrs;
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1215,43 +1051,36 @@ int yynerrs;
 int
 yyparse (void)
 {
-    yy_state_fast_t yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
-
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
+    int yyerrstatus = 0;
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
     yy_state_t yyssa[YYINITDEPTH];
-    yy_state_t *yyss;
-    yy_state_t *yyssp;
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    /* The semantic value stack.  */
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
-
-    YYPTRDIFF_T yystacksize;
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
@@ -1259,16 +1088,10 @@ yyparse (void)
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   goto yysetstate;
 
 
@@ -1290,10 +1113,11 @@ yysetstate:
   YY_IGNORE_USELESS_CAST_BEGIN
   *yyssp = YY_CAST (yy_state_t, yystate);
   YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
 #if !defined yyoverflow && !defined YYSTACK_RELOCATE
-    goto yyexhaustedlab;
+    YYNOMEM;
 #else
     {
       /* Get the current used size of the three stacks, in elements.  */
@@ -1321,7 +1145,7 @@ yysetstate:
 # else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
@@ -1332,10 +1156,10 @@ yysetstate:
           YY_CAST (union yyalloc *,
                    YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
-# undef YYSTACK_RELOCATE
+#  undef YYSTACK_RELOCATE
         if (yyss1 != yyssa)
           YYSTACK_FREE (yyss1);
       }
@@ -1354,6 +1178,7 @@ yysetstate:
     }
 #endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
+
   if (yystate == YYFINAL)
     YYACCEPT;
 
@@ -1374,18 +1199,29 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex ();
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1454,271 +1290,365 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-  case 2:
-#line 55 "grammar/wizuall_parser.y"
+  case 2: /* Program: StatementList  */
+#line 114 "grammar/wizuall_parser.y"
                                    { final_ast = createProgramNode((yyvsp[0].list)); }
-#line 1461 "wizuall_parser.tab.c"
+#line 1297 "wizuall_parser.tab.c"
     break;
 
-  case 3:
-#line 59 "grammar/wizuall_parser.y"
+  case 3: /* StatementList: Statement  */
+#line 118 "grammar/wizuall_parser.y"
                                        { (yyval.list) = createASTList((yyvsp[0].ast)); }
-#line 1467 "wizuall_parser.tab.c"
+#line 1303 "wizuall_parser.tab.c"
     break;
 
-  case 4:
-#line 60 "grammar/wizuall_parser.y"
+  case 4: /* StatementList: StatementList Statement  */
+#line 119 "grammar/wizuall_parser.y"
                                        { (yyval.list) = appendASTList((yyvsp[-1].list), (yyvsp[0].ast)); }
-#line 1473 "wizuall_parser.tab.c"
+#line 1309 "wizuall_parser.tab.c"
+    break;
+
+  case 11: /* ImportStatement: IMPORT STRING SEMICOLON  */
+#line 133 "grammar/wizuall_parser.y"
+        {
+            if (!check_import((yyvsp[-1].str), NULL)) YYERROR;
+            (yyval.ast) = createImportNode((yyvsp[-1].str), false, false, NULL, 0, false);
+        }
+#line 1318 "wizuall_parser.tab.c"
+    break;
+
+  case 12: /* ImportStatement: IMPORT STRING ID SEMICOLON  */
+#line 138 "grammar/wizuall_parser.y"
+        {   /* `stream` and `live` are not reserved, so they stay usable as variable names */
+            bool live = strcmp((yyvsp[-1].str), "live") == 0;
+            if (strcmp((yyvsp[-1].str), "stream") != 0 && !live) {
+                yyerror("expected 'stream', 'live' or ';' after the import file name");
+                YYERROR;
+            }
+            if (!check_import((yyvsp[-2].str), NULL) || (live && !check_live((yyvsp[-2].str)))) YYERROR;
+            (yyval.ast) = createImportNode((yyvsp[-2].str), !live, live, NULL, 0, false);
+        }
+#line 1332 "wizuall_parser.tab.c"
     break;
 
-  case 10:
-#line 72 "grammar/wizuall_parser.y"
-                              { (yyval.ast) = createImportNode((yyvsp[-1].str)); }
-#line 1479 "wizuall_parser.tab.c"
+  case 13: /* ImportStatement: IMPORT STRING ID STRING SEMICOLON  */
+#line 148 "grammar/wizuall_parser.y"
+        {   /* likewise `table` */
+            if (strcmp((yyvsp[-2].str), "table") != 0) {
+                yyerror("expected 'table' before the table name");
+                YYERROR;
+            }
+            char table[256];
+            import_path((yyvsp[-1].str), table, sizeof(table));
+            if (!check_import((yyvsp[-3].str), table)) YYERROR;
+            (yyval.ast) = createImportNode((yyvsp[-3].str), false, false, table, 0, false);
+        }
+#line 1347 "wizuall_parser.tab.c"
+    break;
+
+  case 14: /* ImportStatement: IMPORT STRING ID NUMBER SEMICOLON  */
+#line 159 "grammar/wizuall_parser.y"
+        {   /* and `sample`: a fraction of the rows */
+            if (strcmp((yyvsp[-2].str), "sample") != 0) {
+                yyerror("expected 'sample' before the sampled fraction");
+                YYERROR;
+            }
+            if (!((yyvsp[-1].num) > 0 && (yyvsp[-1].num) <= 1)) {
+                yyerror((yyvsp[-1].num) > 1 && (yyvsp[-1].num) == (long long)(yyvsp[-1].num) ? "a sampled row count is written `sample N rows`"
+                                                      : "a sampled fraction must be in (0, 1]");
+                YYERROR;
+            }
+            if (!check_import((yyvsp[-3].str), NULL) || !check_sample((yyvsp[-3].str))) YYERROR;
+            (yyval.ast) = createImportNode((yyvsp[-3].str), false, false, NULL, (yyvsp[-1].num), false);
+        }
+#line 1365 "wizuall_parser.tab.c"
+    break;
+
+  case 15: /* ImportStatement: IMPORT STRING ID NUMBER ID SEMICOLON  */
+#line 173 "grammar/wizuall_parser.y"
+        {   /* `sample N rows`: that many rows */
+            if (strcmp((yyvsp[-3].str), "sample") != 0 || strcmp((yyvsp[-1].str), "rows") != 0) {
+                yyerror("expected `sample N rows`");
+                YYERROR;
+            }
+            if (!((yyvsp[-2].num) >= 1 && (yyvsp[-2].num) == (long long)(yyvsp[-2].num))) {
+                yyerror("a sampled row count must be a positive integer");
+                YYERROR;
+            }
+            if (!check_import((yyvsp[-4].str), NULL) || !check_sample((yyvsp[-4].str))) YYERROR;
+            (yyval.ast) = createImportNode((yyvsp[-4].str), false, false, NULL, (yyvsp[-2].num), true);
+        }
+#line 1382 "wizuall_parser.tab.c"
+    break;
+
+  case 16: /* ExportStatement: ID ExportNames ID STRING SEMICOLON  */
+#line 189 "grammar/wizuall_parser.y"
+        {   /* `export` and `to` are contextual, like `stream` and `sample` */
+            if (strcmp((yyvsp[-4].str), "export") != 0 || strcmp((yyvsp[-2].str), "to") != 0) {
+                yyerror("expected `export name, ... to \"file\"`");
+                YYERROR;
+            }
+            if (!check_export((yyvsp[-3].list), (yyvsp[-1].str))) YYERROR;
+            char path[256];
+            import_path((yyvsp[-1].str), path, sizeof(path));
+            (yyval.ast) = createExportNode((yyvsp[-3].list), path);
+        }
+#line 1397 "wizuall_parser.tab.c"
+    break;
+
+  case 17: /* ExportNames: ID  */
+#line 202 "grammar/wizuall_parser.y"
+                                   { (yyval.list) = createASTList(createIdNode((yyvsp[0].str))); }
+#line 1403 "wizuall_parser.tab.c"
+    break;
+
+  case 18: /* ExportNames: ExportNames COMMA ID  */
+#line 203 "grammar/wizuall_parser.y"
+                                   { (yyval.list) = appendASTList((yyvsp[-2].list), createIdNode((yyvsp[0].str))); }
+#line 1409 "wizuall_parser.tab.c"
     break;
 
-  case 11:
-#line 76 "grammar/wizuall_parser.y"
+  case 19: /* Assignment: ID ASSIGN Expression  */
+#line 207 "grammar/wizuall_parser.y"
                                    { (yyval.ast) = createAssignmentNode((yyvsp[-2].str), (yyvsp[0].ast)); }
-#line 1485 "wizuall_parser.tab.c"
+#line 1415 "wizuall_parser.tab.c"
     break;
 
-  case 12:
-#line 81 "grammar/wizuall_parser.y"
+  case 20: /* ControlStructure: IF LPAREN Expression RPAREN LBRACE StatementList RBRACE ELSE LBRACE StatementList RBRACE  */
+#line 212 "grammar/wizuall_parser.y"
         { (yyval.ast) = createIfElseNode((yyvsp[-8].ast), (yyvsp[-5].list), (yyvsp[-1].list)); }
-#line 1491 "wizuall_parser.tab.c"
+#line 1421 "wizuall_parser.tab.c"
     break;
 
-  case 13:
-#line 83 "grammar/wizuall_parser.y"
+  case 21: /* ControlStructure: WHILE LPAREN Expression RPAREN LBRACE StatementList RBRACE  */
+#line 214 "grammar/wizuall_parser.y"
         { (yyval.ast) = createWhileNode((yyvsp[-4].ast), (yyvsp[-1].list)); }
-#line 1497 "wizuall_parser.tab.c"
+#line 1427 "wizuall_parser.tab.c"
     break;
 
-  case 14:
-#line 85 "grammar/wizuall_parser.y"
+  case 22: /* ControlStructure: FOR LPAREN Assignment SEMICOLON Expression SEMICOLON Assignment RPAREN LBRACE StatementList RBRACE  */
+#line 216 "grammar/wizuall_parser.y"
         { (yyval.ast) = createForNode((yyvsp[-8].ast), (yyvsp[-6].ast), (yyvsp[-4].ast), (yyvsp[-1].list)); }
-#line 1503 "wizuall_parser.tab.c"
+#line 1433 "wizuall_parser.tab.c"
     break;
 
-  case 15:
-#line 89 "grammar/wizuall_parser.y"
+  case 23: /* FunctionCall: ID LPAREN ArgListOpt RPAREN  */
+#line 220 "grammar/wizuall_parser.y"
                                    { (yyval.ast) = createFunctionCallNode((yyvsp[-3].str), (yyvsp[-1].list)); }
-#line 1509 "wizuall_parser.tab.c"
+#line 1439 "wizuall_parser.tab.c"
     break;
 
-  case 16:
-#line 93 "grammar/wizuall_parser.y"
+  case 24: /* VisualizationCall: PLOT LPAREN VizArgListOpt RPAREN  */
+#line 224 "grammar/wizuall_parser.y"
                                             { (yyval.ast) = createVizCallNode("plot",      (yyvsp[-1].list)); }
-#line 1515 "wizuall_parser.tab.c"
+#line 1445 "wizuall_parser.tab.c"
     break;
 
-  case 17:
-#line 94 "grammar/wizuall_parser.y"
+  case 25: /* VisualizationCall: HISTOGRAM LPAREN VizArgListOpt RPAREN  */
+#line 225 "grammar/wizuall_parser.y"
                                             { (yyval.ast) = createVizCallNode("histogram", (yyvsp[-1].list)); }
-#line 1521 "wizuall_parser.tab.c"
+#line 1451 "wizuall_parser.tab.c"
     break;
 
-  case 18:
-#line 95 "grammar/wizuall_parser.y"
+  case 26: /* VisualizationCall: HEATMAP LPAREN VizArgListOpt RPAREN  */
+#line 226 "grammar/wizuall_parser.y"
                                             { (yyval.ast) = createVizCallNode("heatmap",   (yyvsp[-1].list)); }
-#line 1527 "wizuall_parser.tab.c"
+#line 1457 "wizuall_parser.tab.c"
     break;
 
-  case 19:
-#line 96 "grammar/wizuall_parser.y"
+  case 27: /* VisualizationCall: BARCHART LPAREN VizArgListOpt RPAREN  */
+#line 227 "grammar/wizuall_parser.y"
                                             { (yyval.ast) = createVizCallNode("barchart",  (yyvsp[-1].list)); }
-#line 1533 "wizuall_parser.tab.c"
+#line 1463 "wizuall_parser.tab.c"
     break;
 
-  case 20:
-#line 97 "grammar/wizuall_parser.y"
+  case 28: /* VisualizationCall: PIECHART LPAREN VizArgListOpt RPAREN  */
+#line 228 "grammar/wizuall_parser.y"
                                             { (yyval.ast) = createVizCallNode("piechart",  (yyvsp[-1].list)); }
-#line 1539 "wizuall_parser.tab.c"
+#line 1469 "wizuall_parser.tab.c"
     break;
 
-  case 21:
-#line 98 "grammar/wizuall_parser.y"
+  case 29: /* VisualizationCall: SCATTER LPAREN VizArgListOpt RPAREN  */
+#line 229 "grammar/wizuall_parser.y"
                                             { (yyval.ast) = createVizCallNode("scatter",   (yyvsp[-1].list)); }
-#line 1545 "wizuall_parser.tab.c"
+#line 1475 "wizuall_parser.tab.c"
     break;
 
-  case 22:
-#line 99 "grammar/wizuall_parser.y"
+  case 30: /* VisualizationCall: BOXPLOT LPAREN VizArgListOpt RPAREN  */
+#line 230 "grammar/wizuall_parser.y"
                                             { (yyval.ast) = createVizCallNode("boxplot",   (yyvsp[-1].list)); }
-#line 1551 "wizuall_parser.tab.c"
+#line 1481 "wizuall_parser.tab.c"
     break;
 
-  case 23:
-#line 100 "grammar/wizuall_parser.y"
+  case 31: /* VisualizationCall: TIMELINE LPAREN VizArgListOpt RPAREN  */
+#line 231 "grammar/wizuall_parser.y"
                                             { (yyval.ast) = createVizCallNode("timeline",  (yyvsp[-1].list)); }
-#line 1557 "wizuall_parser.tab.c"
+#line 1487 "wizuall_parser.tab.c"
     break;
 
-  case 24:
-#line 104 "grammar/wizuall_parser.y"
+  case 32: /* Expression: Expression PLUS Term  */
+#line 235 "grammar/wizuall_parser.y"
                                    { (yyval.ast) = createBinaryOpNode(OP_PLUS , (yyvsp[-2].ast), (yyvsp[0].ast)); }
-#line 1563 "wizuall_parser.tab.c"
+#line 1493 "wizuall_parser.tab.c"
     break;
 
-  case 25:
-#line 105 "grammar/wizuall_parser.y"
+  case 33: /* Expression: Expression MINUS Term  */
+#line 236 "grammar/wizuall_parser.y"
                                     { (yyval.ast) = createBinaryOpNode(OP_MINUS, (yyvsp[-2].ast), (yyvsp[0].ast)); }
-#line 1569 "wizuall_parser.tab.c"
+#line 1499 "wizuall_parser.tab.c"
     break;
 
-  case 26:
-#line 106 "grammar/wizuall_parser.y"
+  case 34: /* Expression: Expression LT Term  */
+#line 237 "grammar/wizuall_parser.y"
                                     { (yyval.ast) = createBinaryOpNode(OP_LT, (yyvsp[-2].ast), (yyvsp[0].ast)); }
-#line 1575 "wizuall_parser.tab.c"
+#line 1505 "wizuall_parser.tab.c"
     break;
 
-  case 27:
-#line 107 "grammar/wizuall_parser.y"
+  case 35: /* Expression: Expression GT Term  */
+#line 238 "grammar/wizuall_parser.y"
                                     { (yyval.ast) = createBinaryOpNode(OP_GT, (yyvsp[-2].ast), (yyvsp[0].ast)); }
-#line 1581 "wizuall_parser.tab.c"
+#line 1511 "wizuall_parser.tab.c"
     break;
 
-  case 29:
-#line 112 "grammar/wizuall_parser.y"
+  case 37: /* Term: Term TIMES Factor  */
+#line 243 "grammar/wizuall_parser.y"
                                     { (yyval.ast) = createBinaryOpNode(OP_TIMES, (yyvsp[-2].ast), (yyvsp[0].ast)); }
-#line 1587 "wizuall_parser.tab.c"
+#line 1517 "wizuall_parser.tab.c"
     break;
 
-  case 30:
-#line 113 "grammar/wizuall_parser.y"
+  case 38: /* Term: Term DIVIDE Factor  */
+#line 244 "grammar/wizuall_parser.y"
                                     { (yyval.ast) = createBinaryOpNode(OP_DIVIDE, (yyvsp[-2].ast), (yyvsp[0].ast)); }
-#line 1593 "wizuall_parser.tab.c"
+#line 1523 "wizuall_parser.tab.c"
     break;
 
-  case 32:
-#line 118 "grammar/wizuall_parser.y"
+  case 40: /* Factor: NUMBER  */
+#line 249 "grammar/wizuall_parser.y"
                                     { (yyval.ast) = createNumberNode((yyvsp[0].num)); }
-#line 1599 "wizuall_parser.tab.c"
+#line 1529 "wizuall_parser.tab.c"
     break;
 
-  case 33:
-#line 119 "grammar/wizuall_parser.y"
+  case 41: /* Factor: ID  */
+#line 250 "grammar/wizuall_parser.y"
                                     { (yyval.ast) = createIdNode((yyvsp[0].str)); }
-#line 1605 "wizuall_parser.tab.c"
+#line 1535 "wizuall_parser.tab.c"
     break;
 
-  case 34:
-#line 120 "grammar/wizuall_parser.y"
+  case 42: /* Factor: STRING  */
+#line 251 "grammar/wizuall_parser.y"
                                     { (yyval.ast) = createStringNode((yyvsp[0].str)); }
-#line 1611 "wizuall_parser.tab.c"
+#line 1541 "wizuall_parser.tab.c"
     break;
 
-  case 35:
-#line 121 "grammar/wizuall_parser.y"
+  case 43: /* Factor: VectorLiteral  */
+#line 252 "grammar/wizuall_parser.y"
                                     { (yyval.ast) = (yyvsp[0].ast); }
-#line 1617 "wizuall_parser.tab.c"
+#line 1547 "wizuall_parser.tab.c"
     break;
 
-  case 36:
-#line 122 "grammar/wizuall_parser.y"
+  case 44: /* Factor: FunctionCall  */
+#line 253 "grammar/wizuall_parser.y"
                                     { (yyval.ast) = (yyvsp[0].ast); }
-#line 1623 "wizuall_parser.tab.c"
+#line 1553 "wizuall_parser.tab.c"
     break;
 
-  case 37:
-#line 123 "grammar/wizuall_parser.y"
+  case 45: /* Factor: LPAREN Expression RPAREN  */
+#line 254 "grammar/wizuall_parser.y"
                                     { (yyval.ast) = (yyvsp[-1].ast); }
-#line 1629 "wizuall_parser.tab.c"
+#line 1559 "wizuall_parser.tab.c"
     break;
 
-  case 38:
-#line 127 "grammar/wizuall_parser.y"
+  case 46: /* VectorLiteral: LBRACKET VectorElements RBRACKET  */
+#line 258 "grammar/wizuall_parser.y"
                                        { (yyval.ast) = createVectorNode((yyvsp[-1].list)); }
-#line 1635 "wizuall_parser.tab.c"
+#line 1565 "wizuall_parser.tab.c"
     break;
 
-  case 39:
-#line 132 "grammar/wizuall_parser.y"
+  case 47: /* VectorElements: Expression  */
+#line 263 "grammar/wizuall_parser.y"
                                            { (yyval.list) = createASTList((yyvsp[0].ast)); }
-#line 1641 "wizuall_parser.tab.c"
+#line 1571 "wizuall_parser.tab.c"
     break;
 
-  case 40:
-#line 133 "grammar/wizuall_parser.y"
+  case 48: /* VectorElements: VectorElements COMMA Expression  */
+#line 264 "grammar/wizuall_parser.y"
                                            { (yyval.list) = appendASTList((yyvsp[-2].list), (yyvsp[0].ast)); }
-#line 1647 "wizuall_parser.tab.c"
+#line 1577 "wizuall_parser.tab.c"
     break;
 
-  case 41:
-#line 137 "grammar/wizuall_parser.y"
+  case 49: /* ArgListOpt: ArgList  */
+#line 268 "grammar/wizuall_parser.y"
                                      { (yyval.list) = (yyvsp[0].list); }
-#line 1653 "wizuall_parser.tab.c"
+#line 1583 "wizuall_parser.tab.c"
     break;
 
-  case 42:
-#line 138 "grammar/wizuall_parser.y"
+  case 50: /* ArgListOpt: %empty  */
+#line 269 "grammar/wizuall_parser.y"
                                      { (yyval.list) = NULL; }
-#line 1659 "wizuall_parser.tab.c"
+#line 1589 "wizuall_parser.tab.c"
     break;
 
-  case 43:
-#line 142 "grammar/wizuall_parser.y"
+  case 51: /* ArgList: Expression  */
+#line 273 "grammar/wizuall_parser.y"
                                      { (yyval.list) = createASTList((yyvsp[0].ast)); }
-#line 1665 "wizuall_parser.tab.c"
+#line 1595 "wizuall_parser.tab.c"
     break;
 
-  case 44:
-#line 143 "grammar/wizuall_parser.y"
+  case 52: /* ArgList: ArgList COMMA Expression  */
+#line 274 "grammar/wizuall_parser.y"
                                      { (yyval.list) = appendASTList((yyvsp[-2].list), (yyvsp[0].ast)); }
-#line 1671 "wizuall_parser.tab.c"
+#line 1601 "wizuall_parser.tab.c"
     break;
 
-  case 45:
-#line 147 "grammar/wizuall_parser.y"
+  case 53: /* VizArgListOpt: VizArgList  */
+#line 278 "grammar/wizuall_parser.y"
                                      { (yyval.list) = (yyvsp[0].list); }
-#line 1677 "wizuall_parser.tab.c"
+#line 1607 "wizuall_parser.tab.c"
     break;
 
-  case 46:
-#line 148 "grammar/wizuall_parser.y"
+  case 54: /* VizArgListOpt: %empty  */
+#line 279 "grammar/wizuall_parser.y"
                                      { (yyval.list) = NULL; }
-#line 1683 "wizuall_parser.tab.c"
+#line 1613 "wizuall_parser.tab.c"
     break;
 
-  case 47:
-#line 152 "grammar/wizuall_parser.y"
+  case 55: /* VizArgList: VizArg  */
+#line 283 "grammar/wizuall_parser.y"
                                      { (yyval.list) = createASTList((yyvsp[0].ast)); }
-#line 1689 "wizuall_parser.tab.c"
+#line 1619 "wizuall_parser.tab.c"
     break;
 
-  case 48:
-#line 153 "grammar/wizuall_parser.y"
+  case 56: /* VizArgList: VizArgList COMMA VizArg  */
+#line 284 "grammar/wizuall_parser.y"
                                      { (yyval.list) = appendASTList((yyvsp[-2].list), (yyvsp[0].ast)); }
-#line 1695 "wizuall_parser.tab.c"
+#line 1625 "wizuall_parser.tab.c"
     break;
 
-  case 49:
-#line 158 "grammar/wizuall_parser.y"
+  case 57: /* VizArg: ID ASSIGN STRING  */
+#line 289 "grammar/wizuall_parser.y"
         {   ASTNode* key = createIdNode((yyvsp[-2].str));
             ASTNode* val = createStringNode((yyvsp[0].str));
             (yyval.ast) = createBinaryOpNode(OP_ASSIGN, key, val);
         }
-#line 1704 "wizuall_parser.tab.c"
+#line 1634 "wizuall_parser.tab.c"
     break;
 
-  case 50:
-#line 163 "grammar/wizuall_parser.y"
+  case 58: /* VizArg: ID ASSIGN Expression  */
+#line 294 "grammar/wizuall_parser.y"
         {   ASTNode* key = createIdNode((yyvsp[-2].str));
             (yyval.ast) = createBinaryOpNode(OP_ASSIGN, key, (yyvsp[0].ast));
         }
-#line 1712 "wizuall_parser.tab.c"
+#line 1642 "wizuall_parser.tab.c"
     break;
 
-  case 51:
-#line 166 "grammar/wizuall_parser.y"
+  case 59: /* VizArg: Expression  */
+#line 297 "grammar/wizuall_parser.y"
                                      { (yyval.ast) = (yyvsp[0].ast); }
-#line 1718 "wizuall_parser.tab.c"
+#line 1648 "wizuall_parser.tab.c"
     break;
 
 
-#line 1722 "wizuall_parser.tab.c"
+#line 1652 "wizuall_parser.tab.c"
 
       default: break;
     }
@@ -1733,11 +1663,10 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
@@ -1761,50 +1690,14 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
-      {
-        char const *yymsgp = YY_("syntax error");
-        int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
-        if (yysyntax_error_status == 0)
-          yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
-          {
-            if (yymsg != yymsgbuf)
-              YYSTACK_FREE (yymsg);
-            yymsg = YY_CAST (char *, YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
-            if (!yymsg)
-              {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
-              }
-            else
-              {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
-              }
-          }
-        yyerror (yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
-      }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -1837,6 +1730,7 @@ yyerrorlab:
      label yyerrorlab therefore never appears in user code.  */
   if (0)
     YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -1853,13 +1747,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -1873,7 +1768,7 @@ yyerrlab1:
 
 
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -1885,7 +1780,7 @@ yyerrlab1:
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -1896,7 +1791,7 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
 /*-----------------------------------.
@@ -1904,24 +1799,22 @@ yyacceptlab:
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
 
-/*-----------------------------------------------------.
-| yyreturn -- parsing is finished, return the result.  |
-`-----------------------------------------------------*/
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -1937,20 +1830,18 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[+*yyssp], yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
+
   return yyresult;
 }
-#line 169 "grammar/wizuall_parser.y"
+
+#line 300 "grammar/wizuall_parser.y"
   /* ----------  C code section ---------- */
 
 void yyerror(const char *s) {
@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.5.1.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -31,8 +31,9 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
 
 #ifndef YY_YY_WIZUALL_PARSER_TAB_H_INCLUDED
 # define YY_YY_WIZUALL_PARSER_TAB_H_INCLUDED
@@ -44,67 +45,72 @@
 extern int yydebug;
 #endif
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    NUMBER = 258,
-    ID = 259,
-    STRING = 260,
-    LT = 261,
-    GT = 262,
-    IF = 263,
-    ELSE = 264,
-    WHILE = 265,
-    FOR = 266,
-    BEGIN_AUX = 267,
-    END_AUX = 268,
-    SORT = 269,
-    REVERSE = 270,
-    SLICE = 271,
-    AVG = 272,
-    TRANSPOSE = 273,
-    RUNNING_SUM = 274,
-    PAIRWISE_COMPARE = 275,
-    PARETO_SET = 276,
-    PLOT = 277,
-    HISTOGRAM = 278,
-    HEATMAP = 279,
-    BARCHART = 280,
-    PIECHART = 281,
-    SCATTER = 282,
-    BOXPLOT = 283,
-    TIMELINE = 284,
-    PLUS = 285,
-    MINUS = 286,
-    TIMES = 287,
-    DIVIDE = 288,
-    ASSIGN = 289,
-    COMMA = 290,
-    SEMICOLON = 291,
-    LPAREN = 292,
-    RPAREN = 293,
-    LBRACE = 294,
-    RBRACE = 295,
-    LBRACKET = 296,
-    RBRACKET = 297,
-    IMPORT = 298
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    NUMBER = 258,                  /* NUMBER  */
+    ID = 259,                      /* ID  */
+    STRING = 260,                  /* STRING  */
+    LT = 261,                      /* LT  */
+    GT = 262,                      /* GT  */
+    IF = 263,                      /* IF  */
+    ELSE = 264,                    /* ELSE  */
+    WHILE = 265,                   /* WHILE  */
+    FOR = 266,                     /* FOR  */
+    BEGIN_AUX = 267,               /* BEGIN_AUX  */
+    END_AUX = 268,                 /* END_AUX  */
+    SORT = 269,                    /* SORT  */
+    REVERSE = 270,                 /* REVERSE  */
+    SLICE = 271,                   /* SLICE  */
+    AVG = 272,                     /* AVG  */
+    TRANSPOSE = 273,               /* TRANSPOSE  */
+    RUNNING_SUM = 274,             /* RUNNING_SUM  */
+    PAIRWISE_COMPARE = 275,        /* PAIRWISE_COMPARE  */
+    PARETO_SET = 276,              /* PARETO_SET  */
+    PLOT = 277,                    /* PLOT  */
+    HISTOGRAM = 278,               /* HISTOGRAM  */
+    HEATMAP = 279,                 /* HEATMAP  */
+    BARCHART = 280,                /* BARCHART  */
+    PIECHART = 281,                /* PIECHART  */
+    SCATTER = 282,                 /* SCATTER  */
+    BOXPLOT = 283,                 /* BOXPLOT  */
+    TIMELINE = 284,                /* TIMELINE  */
+    PLUS = 285,                    /* PLUS  */
+    MINUS = 286,                   /* MINUS  */
+    TIMES = 287,                   /* TIMES  */
+    DIVIDE = 288,                  /* DIVIDE  */
+    ASSIGN = 289,                  /* ASSIGN  */
+    COMMA = 290,                   /* COMMA  */
+    SEMICOLON = 291,               /* SEMICOLON  */
+    LPAREN = 292,                  /* LPAREN  */
+    RPAREN = 293,                  /* RPAREN  */
+    LBRACE = 294,                  /* LBRACE  */
+    RBRACE = 295,                  /* RBRACE  */
+    LBRACKET = 296,                /* LBRACKET  */
+    RBRACKET = 297,                /* RBRACKET  */
+    IMPORT = 298                   /* IMPORT  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
 /* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 16 "grammar/wizuall_parser.y"
+#line 74 "grammar/wizuall_parser.y"
 
     double num;
     char* str;
     struct ASTNode* ast;
     struct ASTList* list;
 
-#line 108 "wizuall_parser.tab.h"
+#line 114 "wizuall_parser.tab.h"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -115,6 +121,8 @@ typedef union YYSTYPE YYSTYPE;
 
 extern YYSTYPE yylval;
 
+
 int yyparse (void);
 
+
 #endif /* !YY_YY_WIZUALL_PARSER_TAB_H_INCLUDED  */